@@ -1,6 +1,9 @@
 #ifndef TRANSACTIONS_SOURCE_CONTROLLER_CONTROLLER_H_
 #define TRANSACTIONS_SOURCE_CONTROLLER_CONTROLLER_H_
 
+#include <chrono>
+#include <limits>
+
 #include "model/common/basestorage.h"
 #include "model/common/filemanager.h"
 #include "model/common/managerttl.h"
@@ -14,30 +17,56 @@ class Controller {
       : manager_(model), model_(model) {}
 
   bool Set(Key key, Value value, size_t ttl = 0) {
+    manager_.ExpireRecord(key);
     manager_.AddRecord({key, ttl});
-    return manager_.ExecuteStorageOperation(&BaseStorage<Key, Value>::Set, key,
-                                            value);
+    return manager_.ExecuteKeyOperation(key, &BaseStorage<Key, Value>::Set,
+                                        key, value);
+  }
+
+  // Millisecond counterpart of Set with a TTL in seconds.
+  bool SetWithTimeout(Key key, Value value, std::chrono::milliseconds ttl) {
+    manager_.ExpireRecord(key);
+    manager_.AddRecord({key, ttl});
+    return manager_.ExecuteKeyOperation(key, &BaseStorage<Key, Value>::Set,
+                                        key, value);
   }
 
   Value Get(Key key) {
-    return manager_.ExecuteStorageOperation(&BaseStorage<Key, Value>::Get, key);
+    return manager_.ExecuteKeyOperation(key, &BaseStorage<Key, Value>::Get,
+                                        key);
   }
 
   bool Exists(Key key) {
-    return manager_.ExecuteStorageOperation(&BaseStorage<Key, Value>::Exists,
-                                            key);
+    return manager_.ExecuteKeyOperation(key, &BaseStorage<Key, Value>::Exists,
+                                        key);
   }
 
   bool Del(Key key) {
     bool status =
-        manager_.ExecuteStorageOperation(&BaseStorage<Key, Value>::Del, key);
+        manager_.ExecuteKeyOperation(key, &BaseStorage<Key, Value>::Del, key);
     manager_.DeleteRecord(key);
     return status;
   }
 
+  size_t DelRange(Key from, Key to) {
+    size_t removed = manager_.ExecuteStorageOperation(
+        &BaseStorage<Key, Value>::DelRange, from, to);
+    manager_.DeleteRecordsIf(
+        [&](const Key& key) { return !(key < from) && !(to < key); });
+    return removed;
+  }
+
+  size_t DelPrefix(Key prefix) {
+    size_t removed = manager_.ExecuteStorageOperation(
+        &BaseStorage<Key, Value>::DelPrefix, prefix);
+    manager_.DeleteRecordsIf(
+        [&](const Key& key) { return HasKeyPrefix(key, prefix); });
+    return removed;
+  }
+
   bool Update(Key key, Value value) {
-    return manager_.ExecuteStorageOperation(&BaseStorage<Key, Value>::Update,
-                                            key, value);
+    return manager_.ExecuteKeyOperation(key, &BaseStorage<Key, Value>::Update,
+                                        key, value);
   }
 
   std::vector<Key> Keys() {
@@ -45,9 +74,14 @@ class Controller {
   }
 
   bool Rename(Key key, Key new_key) {
-    manager_.RenameRecord(key, new_key);
-    return manager_.ExecuteStorageOperation(&BaseStorage<Key, Value>::Rename,
-                                            key, new_key);
+    manager_.ExpireRecord(new_key);
+    manager_.ExpireRecord(key);
+    bool status = manager_.ExecuteKeyOperation(
+        key, &BaseStorage<Key, Value>::Rename, key, new_key);
+    if (status) {
+      manager_.RenameRecord(key, new_key);
+    }
+    return status;
   }
 
   size_t TTL(Key key) { return manager_.GetTTL(key); }
@@ -61,6 +95,31 @@ class Controller {
     return manager_.ExecuteStorageOperation(&BaseStorage<Key, Value>::Showall);
   }
 
+  std::vector<std::pair<Key, Value>> Range(
+      Key from, Key to, size_t limit = std::numeric_limits<size_t>::max()) {
+    return manager_.ExecuteStorageOperation(&BaseStorage<Key, Value>::Scan,
+                                            from, to, limit);
+  }
+
+  size_t Rank(Key key) {
+    return manager_.ExecuteStorageOperation(&BaseStorage<Key, Value>::Rank,
+                                            key);
+  }
+
+  Key Select(size_t index) {
+    return manager_.ExecuteStorageOperation(&BaseStorage<Key, Value>::Select,
+                                            index);
+  }
+
+  size_t CountRange(Key from, Key to) {
+    return manager_.ExecuteStorageOperation(
+        &BaseStorage<Key, Value>::CountRange, from, to);
+  }
+
+  void Compact() {
+    manager_.ExecuteStorageOperation(&BaseStorage<Key, Value>::Compact);
+  }
+
   std::pair<bool, size_t> Upload(const std::string& path) {
     return s21::FileManager::ImportFromDat(model_, path);
   }
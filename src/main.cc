@@ -1,19 +1,24 @@
 #include "model/bplustree/b_plus_tree.h"
 #include "model/bst/self_balancing_binary_search_tree.h"
 #include "model/common/student.h"
+#include "model/hashtable/cuckoo_hash_table.h"
 #include "model/hashtable/hash_table.h"
 #include "view/mainmenu.h"
 
 int main() {
-  s21::HashTable<std::string, s21::Student> hashtable;
+  s21::HashTable<std::string, s21::Student> hashtable(
+      s21::RehashPolicy::kIncremental);
   s21::SelfBalancingBinarySearchTree<std::string, s21::Student> sbbst;
   s21::BPlusTree<std::string, s21::Student> bplustree;
+  s21::CuckooHashTable<std::string, s21::Student> cuckoo;
 
   s21::Controller controller_1(hashtable);
   s21::Controller controller_2(sbbst);
   s21::Controller controller_3(bplustree);
+  s21::Controller controller_4(cuckoo);
 
-  s21::MainMenu mainmenu(controller_1, controller_2, controller_3);
+  s21::MainMenu mainmenu(controller_1, controller_2, controller_3,
+                         controller_4);
 
   mainmenu.Start();
 
@@ -2,6 +2,7 @@
 #define TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_B_PLUS_TREE_H_
 
 #include <fstream>
+#include <memory>
 #include <stdexcept>
 
 #include "model/bplustree/tree.h"
@@ -10,17 +11,43 @@
 namespace s21 {
 
 template <typename Key, typename Value,
-          typename ValueEqual = std::equal_to<Value>>
+          typename ValueEqual = std::equal_to<Value>,
+          size_t Degree = kDefaultDegree>
 class BPlusTree : public BaseStorage<Key, Value> {
  public:
+  class Cursor : public BaseCursor<Key, Value> {
+   public:
+    explicit Cursor(const Tree<Key, Value, Degree>& tree) : cursor_(tree) {}
+
+    bool IsValid() const override { return cursor_.IsValid(); }
+    void Seek(const Key& key) override { cursor_.Seek(key); }
+    void SeekToFirst() override { cursor_.SeekToFirst(); }
+    void SeekToLast() override { cursor_.SeekToLast(); }
+    void Next() override { cursor_.Next(); }
+    void Prev() override { cursor_.Prev(); }
+    const Key& GetKey() const override { return cursor_.GetKey(); }
+    const Value& GetValue() const override { return cursor_.GetValue(); }
+
+   private:
+    typename Tree<Key, Value, Degree>::Cursor cursor_;
+  };
+
   ~BPlusTree() = default;
 
   BPlusTree() {}
 
+  explicit BPlusTree(RebalancePolicy policy) : tree_(policy) {}
+
+  BPlusTree(RebalancePolicy policy, SlabPages pages) : tree_(policy, pages) {}
+
   BPlusTree(const BPlusTree& other) : tree_(other.tree_) {}
 
   BPlusTree(BPlusTree&& other) noexcept : tree_(std::move(other.tree_)) {}
 
+  std::unique_ptr<BaseStorage<Key, Value>> Clone() const override {
+    return std::make_unique<BPlusTree>(*this);
+  }
+
   bool Set(const Key& key, const Value& value) {
     return tree_.Insert(key, value);
   };
@@ -34,6 +61,17 @@ class BPlusTree : public BaseStorage<Key, Value> {
 
   bool Del(const Key& key) { return tree_.Remove(key); };
 
+  size_t DelRange(const Key& from, const Key& to) {
+    return tree_.RemoveWhile(from,
+                             [&to](const Key& key) { return !(to < key); });
+  }
+
+  size_t DelPrefix(const Key& prefix) {
+    return tree_.RemoveWhile(prefix, [&prefix](const Key& key) {
+      return HasKeyPrefix(key, prefix);
+    });
+  }
+
   bool Update(const Key& key, const Value& value) {
     try {
       return tree_.Update(key, value);
@@ -75,6 +113,31 @@ class BPlusTree : public BaseStorage<Key, Value> {
     return result;
   };
 
+  bool HasBulkLoad() const override { return true; }
+
+  size_t SetBatch(std::vector<std::pair<Key, Value>> records) {
+    return tree_.BulkLoad(std::move(records));
+  }
+
+  void Compact() { tree_.Compact(); }
+
+  void Freeze() { tree_.Freeze(); }
+
+  void Thaw() { tree_.Thaw(); }
+
+  bool IsFrozen() const { return tree_.IsFrozen(); }
+
+  size_t GetSize() const { return tree_.GetSize(); }
+
+  std::unique_ptr<BaseCursor<Key, Value>> GetCursor() const {
+    return std::make_unique<Cursor>(tree_);
+  }
+
+  std::vector<std::pair<Key, Value>> Scan(const Key& from, const Key& to,
+                                          size_t limit) const {
+    return tree_.Scan(from, to, limit);
+  }
+
   std::vector<Value> Showall() const {
     std::vector<Value> values;
     for (auto it = tree_.Begin(); it != tree_.End(); ++it) {
@@ -84,7 +147,7 @@ class BPlusTree : public BaseStorage<Key, Value> {
   };
 
  private:
-  Tree<Key, Value> tree_;
+  Tree<Key, Value, Degree> tree_;
 };
 }  // namespace s21
 
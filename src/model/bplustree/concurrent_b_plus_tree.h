@@ -0,0 +1,178 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_CONCURRENT_B_PLUS_TREE_H_
+#define TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_CONCURRENT_B_PLUS_TREE_H_
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "model/bplustree/concurrent_tree.h"
+#include "model/common/basestorage.h"
+
+namespace s21 {
+
+// B+ tree storage that is safe to use from many threads without the global
+// storage mutex: point reads and range scans never block each other and
+// writers only latch the nodes they change.
+template <typename Key, typename Value,
+          typename ValueEqual = std::equal_to<Value>,
+          size_t Degree = kDefaultDegree>
+class ConcurrentBPlusTree : public BaseStorage<Key, Value> {
+ public:
+  // Holds a copy of the record it points at and finds its neighbours with
+  // a fresh descent, so it never keeps a latch or a reference to a leaf.
+  class Cursor : public BaseCursor<Key, Value> {
+   public:
+    explicit Cursor(const ConcurrentTree<Key, Value, Degree>& tree)
+        : tree_(tree) {}
+
+    bool IsValid() const override { return record_.has_value(); }
+
+    void Seek(const Key& key) override { SeekFrom(&key, nullptr); }
+
+    void SeekToFirst() override { SeekFrom(nullptr, nullptr); }
+
+    void SeekToLast() override { SeekBefore(nullptr); }
+
+    void Next() override {
+      Key key = std::move(record_->first);
+      SeekFrom(&key, &key);
+    }
+
+    void Prev() override {
+      Key key = std::move(record_->first);
+      SeekBefore(&key);
+    }
+
+    const Key& GetKey() const override { return record_->first; }
+
+    const Value& GetValue() const override { return record_->second; }
+
+   private:
+    // First record not less than from and greater than after.
+    void SeekFrom(const Key* from, const Key* after) {
+      record_.reset();
+      tree_.ForEach(from, [this, after](const auto& record) {
+        if (after != nullptr && !(*after < record.key)) {
+          return true;
+        }
+        record_.emplace(record.key, record.value);
+        return false;
+      });
+    }
+
+    // Last record less than before, or the last one when before is null.
+    void SeekBefore(const Key* before) {
+      record_.reset();
+      tree_.ForEachBefore(before, [this](const auto& record) {
+        record_.emplace(record.key, record.value);
+        return false;
+      });
+    }
+
+    const ConcurrentTree<Key, Value, Degree>& tree_;
+    std::optional<std::pair<Key, Value>> record_;
+  };
+
+  ConcurrentBPlusTree() {}
+
+  ConcurrentBPlusTree(const ConcurrentBPlusTree& other) : tree_(other.tree_) {}
+
+  ConcurrentBPlusTree& operator=(const ConcurrentBPlusTree&) = delete;
+
+  ~ConcurrentBPlusTree() override = default;
+
+  bool IsThreadSafe() const override { return true; }
+
+  // Leaves are read under their versions, and the copy is built bottom-up
+  // from their records in linear time. Writers are not blocked.
+  std::unique_ptr<BaseStorage<Key, Value>> Clone() const override {
+    return std::make_unique<ConcurrentBPlusTree>(*this);
+  }
+
+  bool Set(const Key& key, const Value& value) override {
+    return tree_.Insert(key, value);
+  }
+
+  Value Get(const Key& key) const override { return tree_.Search(key); }
+
+  bool Exists(const Key& key) const override { return tree_.Exists(key); }
+
+  bool Del(const Key& key) override { return tree_.Remove(key); }
+
+  bool Update(const Key& key, const Value& value) override {
+    return tree_.Update(key, value);
+  }
+
+  std::vector<Key> Keys() const override {
+    std::vector<Key> keys;
+    tree_.ForEach(nullptr, [&keys](const auto& record) {
+      keys.push_back(record.key);
+      return true;
+    });
+    return keys;
+  }
+
+  // The value is copied under the new key before the old key is removed,
+  // so a reader always finds the record under at least one of them. A
+  // value updated in between is carried over, and when the old key is gone
+  // by then the copy is removed again.
+  bool Rename(const Key& key, const Key& new_key) override {
+    Value value;
+    if (!tree_.Search(key, &value) || !tree_.Insert(new_key, value)) {
+      return false;
+    }
+
+    Value removed;
+    if (!tree_.Remove(key, &removed)) {
+      tree_.Remove(new_key);
+      return false;
+    }
+    if (!ValueEqual()(removed, value)) {
+      tree_.Update(new_key, removed);
+    }
+    return true;
+  }
+
+  std::vector<Key> Find(const Value& value) const override {
+    std::vector<Key> result;
+    ValueEqual equal;
+
+    tree_.ForEach(nullptr, [&](const auto& record) {
+      if (equal(record.value, value)) {
+        result.push_back(record.key);
+      }
+      return true;
+    });
+
+    return result;
+  }
+
+  std::vector<Value> Showall() const override {
+    std::vector<Value> values;
+    tree_.ForEach(nullptr, [&values](const auto& record) {
+      values.push_back(record.value);
+      return true;
+    });
+    return values;
+  }
+
+  std::vector<std::pair<Key, Value>> Scan(const Key& from, const Key& to,
+                                          size_t limit) const override {
+    return tree_.Scan(from, to, limit);
+  }
+
+  std::unique_ptr<BaseCursor<Key, Value>> GetCursor() const override {
+    return std::make_unique<Cursor>(tree_);
+  }
+
+  size_t GetSize() const { return tree_.GetSize(); }
+
+ private:
+  ConcurrentTree<Key, Value, Degree> tree_;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_CONCURRENT_B_PLUS_TREE_H_
@@ -0,0 +1,954 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_CONCURRENT_TREE_H_
+#define TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_CONCURRENT_TREE_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "model/bplustree/key_prefix.h"
+#include "model/bplustree/tree.h"
+#include "model/common/epochreclaimer.h"
+
+namespace s21 {
+
+// B+ tree with optimistic lock coupling. Every node carries a version
+// latch: readers remember the version, read the node without writing to
+// shared memory and validate the version afterwards, restarting the
+// operation if a writer got in between. Writers lock only the nodes they
+// modify by upgrading a version they have read, and an upgrade never waits,
+// so there are no deadlocks.
+//
+// Records and separator keys are immutable once published and nodes only
+// hold pointers to them, so a reader never sees a half written key or
+// value. Unlinked nodes, records and keys are freed by an EpochReclaimer,
+// where a reader writes only to the epoch slot of its own thread.
+template <typename Key, typename Value, size_t Degree = kDefaultDegree>
+class ConcurrentTree {
+  static_assert(Degree > 0, "Tree degree must be positive");
+
+ public:
+  // Full nodes are split on the way down, so a node never overflows.
+  static constexpr size_t kCapacity = 2 * Degree;
+  // Nodes below it are merged with a neighbour when the two fit into one.
+  static constexpr size_t kMergeThreshold = Degree / 2;
+
+  struct Record {
+    Key key;
+    Value value;
+  };
+
+  ConcurrentTree() : root_(new Leaf()) {}
+
+  // Copies the records of other leaf by leaf, each leaf validated before
+  // its records are read, and builds full nodes bottom-up in O(n). Writers
+  // of other are not blocked.
+  ConcurrentTree(const ConcurrentTree& other) {
+    std::vector<const Record*> records;
+    records.reserve(other.GetSize());
+    other.ForEach(nullptr, [&records](const Record& record) {
+      records.push_back(new Record{record.key, record.value});
+      return true;
+    });
+    root_.store(Build(records));
+    size_.store(records.size());
+  }
+
+  ConcurrentTree& operator=(const ConcurrentTree&) = delete;
+
+  ~ConcurrentTree() { Clear(root_.load()); }
+
+  bool Insert(const Key& key, const Value& value) {
+    EpochReclaimer::Guard guard(reclaimer_);
+    bool inserted = false;
+    while (!TryInsert(key, value, &inserted)) {
+    }
+    return inserted;
+  }
+
+  // The removed value is stored to value when it is not null.
+  bool Remove(const Key& key, Value* value = nullptr) {
+    EpochReclaimer::Guard guard(reclaimer_);
+    bool removed = false;
+    while (!TryRemove(key, value, &removed)) {
+    }
+    return removed;
+  }
+
+  bool Update(const Key& key, const Value& value) {
+    EpochReclaimer::Guard guard(reclaimer_);
+    bool updated = false;
+    while (!TryUpdate(key, value, &updated)) {
+    }
+    return updated;
+  }
+
+  Value Search(const Key& key) const {
+    EpochReclaimer::Guard guard(reclaimer_);
+    const Record* record = nullptr;
+    while (!TryFind(key, &record)) {
+    }
+    if (record == nullptr) {
+      throw std::invalid_argument("Key not found");
+    }
+    return record->value;
+  }
+
+  // Stores the value to value and returns true when key is present.
+  bool Search(const Key& key, Value* value) const {
+    EpochReclaimer::Guard guard(reclaimer_);
+    const Record* record = nullptr;
+    while (!TryFind(key, &record)) {
+    }
+    if (record == nullptr) {
+      return false;
+    }
+    *value = record->value;
+    return true;
+  }
+
+  bool Exists(const Key& key) const {
+    EpochReclaimer::Guard guard(reclaimer_);
+    const Record* record = nullptr;
+    while (!TryFind(key, &record)) {
+    }
+    return record != nullptr;
+  }
+
+  // Calls visit for the records in key order, starting from the first key
+  // not less than from or from the smallest one when from is null, until
+  // it returns false. Every leaf is validated before its records are
+  // visited, and a restarted scan resumes after the last visited key.
+  template <typename Visitor>
+  void ForEach(const Key* from, Visitor visit) const {
+    EpochReclaimer::Guard guard(reclaimer_);
+    std::optional<Key> last;
+    std::vector<const Record*> batch;
+    batch.reserve(kCapacity);
+
+    while (true) {
+      const Key* start = last ? &*last : from;
+      Leaf* leaf = nullptr;
+      uint64_t version = 0;
+      if (!FindLeaf(start, &leaf, &version)) {
+        continue;
+      }
+      size_t index = start == nullptr ? 0
+                     : last           ? UpperBound(leaf, *last)
+                                      : LowerBound(leaf, *from);
+
+      while (true) {
+        batch.clear();
+        for (size_t i = index, size = Size(leaf); i < size; ++i) {
+          batch.push_back(leaf->records[i].load(std::memory_order_acquire));
+        }
+        Leaf* next = leaf->next.load(std::memory_order_acquire);
+        if (!Validate(leaf, version)) {
+          break;
+        }
+        for (const Record* record : batch) {
+          if (!visit(*record)) {
+            return;
+          }
+        }
+        if (!batch.empty()) {
+          last = batch.back()->key;
+        }
+
+        uint64_t next_version = 0;
+        if (next == nullptr) {
+          return;
+        }
+        if (!ReadLock(next, &next_version) || !Validate(leaf, version)) {
+          break;
+        }
+        leaf = next;
+        version = next_version;
+        index = 0;
+      }
+    }
+  }
+
+  // Calls visit for the records in descending key order, starting from the
+  // last key less than before or from the largest one when before is null,
+  // until it returns false. Leaves are not linked backwards, so the walk
+  // descends again below the lower separator of each leaf it leaves.
+  template <typename Visitor>
+  void ForEachBefore(const Key* before, Visitor visit) const {
+    EpochReclaimer::Guard guard(reclaimer_);
+    std::optional<Key> bound;
+    if (before != nullptr) {
+      bound = *before;
+    }
+    std::vector<const Record*> batch;
+    batch.reserve(kCapacity);
+
+    while (true) {
+      Leaf* leaf = nullptr;
+      uint64_t version = 0;
+      const Key* fence = nullptr;
+      if (!FindLeafBefore(bound ? &*bound : nullptr, &leaf, &version,
+                          &fence)) {
+        continue;
+      }
+
+      batch.clear();
+      for (size_t i = bound ? LowerBound(leaf, *bound) : Size(leaf); i > 0;
+           --i) {
+        batch.push_back(leaf->records[i - 1].load(std::memory_order_acquire));
+      }
+      if (!Validate(leaf, version)) {
+        continue;
+      }
+      for (const Record* record : batch) {
+        if (!visit(*record)) {
+          return;
+        }
+      }
+      if (fence == nullptr) {
+        return;
+      }
+      bound = *fence;
+    }
+  }
+
+  std::vector<std::pair<Key, Value>> Scan(const Key& from, const Key& to,
+                                          size_t limit) const {
+    std::vector<std::pair<Key, Value>> result;
+    if (limit == 0) {
+      return result;
+    }
+
+    ForEach(&from, [&](const Record& record) {
+      if (to < record.key) {
+        return false;
+      }
+      result.emplace_back(record.key, record.value);
+      return result.size() < limit;
+    });
+
+    return result;
+  }
+
+  size_t GetSize() const { return size_.load(); }
+
+ private:
+  using Prefix = KeyPrefix<Key>;
+
+  static constexpr uint64_t kObsolete = 1;
+  static constexpr uint64_t kLocked = 2;
+
+  struct Node {
+    explicit Node(bool leaf) : is_leaf(leaf) {}
+
+    const bool is_leaf;
+    std::atomic<uint64_t> version{0};
+    std::atomic<size_t> size{0};
+    std::array<std::atomic<uint64_t>, kCapacity> prefixes{};
+  };
+
+  struct Leaf : Node {
+    Leaf() : Node(true) {}
+
+    std::array<std::atomic<const Record*>, kCapacity> records{};
+    std::atomic<Leaf*> next{};
+  };
+
+  struct Inner : Node {
+    Inner() : Node(false) {}
+
+    std::array<std::atomic<const Key*>, kCapacity> keys{};
+    std::array<std::atomic<Node*>, kCapacity + 1> children{};
+  };
+
+  static Leaf* AsLeaf(Node* node) { return static_cast<Leaf*>(node); }
+
+  static const Leaf* AsLeaf(const Node* node) {
+    return static_cast<const Leaf*>(node);
+  }
+
+  static Inner* AsInner(Node* node) { return static_cast<Inner*>(node); }
+
+  static const Inner* AsInner(const Node* node) {
+    return static_cast<const Inner*>(node);
+  }
+
+  // Waits for the writer holding the latch, fails on an unlinked node.
+  static bool ReadLock(const Node* node, uint64_t* version) {
+    uint64_t current = node->version.load(std::memory_order_acquire);
+    while (current & kLocked) {
+      std::this_thread::yield();
+      current = node->version.load(std::memory_order_acquire);
+    }
+    *version = current;
+    return (current & kObsolete) == 0;
+  }
+
+  // Readers load node fields with acquire ordering, so the version load
+  // cannot move ahead of them.
+  static bool Validate(const Node* node, uint64_t version) {
+    return node->version.load(std::memory_order_acquire) == version;
+  }
+
+  static bool Upgrade(Node* node, uint64_t version) {
+    return node->version.compare_exchange_strong(version, version + kLocked,
+                                                 std::memory_order_acquire);
+  }
+
+  // Used while other latches are held, so it never waits.
+  static bool TryLock(Node* node) {
+    uint64_t version = node->version.load(std::memory_order_acquire);
+    return (version & (kLocked | kObsolete)) == 0 && Upgrade(node, version);
+  }
+
+  static void Unlock(Node* node) {
+    node->version.fetch_add(kLocked, std::memory_order_release);
+  }
+
+  static void UnlockObsolete(Node* node) {
+    node->version.fetch_add(kLocked | kObsolete, std::memory_order_release);
+  }
+
+  // Optimistic readers may see any size a writer has stored, never a
+  // larger one than the arrays hold.
+  static size_t Size(const Node* node) {
+    return std::min(node->size.load(std::memory_order_acquire), kCapacity);
+  }
+
+  // Null only in a state a writer is changing, which fails validation.
+  static const Key* KeyAt(const Node* node, size_t index) {
+    if (node->is_leaf) {
+      const Record* record =
+          AsLeaf(node)->records[index].load(std::memory_order_acquire);
+      return record == nullptr ? nullptr : &record->key;
+    }
+    return AsInner(node)->keys[index].load(std::memory_order_acquire);
+  }
+
+  // Whether the key at index is less than key, full keys are compared only
+  // when the prefixes tie.
+  static bool IsBelow(const Node* node, size_t index, const Key& key,
+                      uint64_t prefix) {
+    if constexpr (Prefix::kEnabled) {
+      uint64_t own = node->prefixes[index].load(std::memory_order_acquire);
+      if (own != prefix || Prefix::kExact) {
+        return own < prefix;
+      }
+    }
+    const Key* own_key = KeyAt(node, index);
+    return own_key != nullptr && *own_key < key;
+  }
+
+  static bool IsAbove(const Node* node, size_t index, const Key& key,
+                      uint64_t prefix) {
+    if constexpr (Prefix::kEnabled) {
+      uint64_t own = node->prefixes[index].load(std::memory_order_acquire);
+      if (own != prefix || Prefix::kExact) {
+        return prefix < own;
+      }
+    }
+    const Key* own_key = KeyAt(node, index);
+    return own_key != nullptr && key < *own_key;
+  }
+
+  static size_t LowerBound(const Node* node, const Key& key) {
+    uint64_t prefix = Prefix::Get(key);
+    size_t low = 0;
+    size_t high = Size(node);
+    while (low < high) {
+      size_t mid = low + (high - low) / 2;
+      if (IsBelow(node, mid, key, prefix)) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    return low;
+  }
+
+  static size_t UpperBound(const Node* node, const Key& key) {
+    uint64_t prefix = Prefix::Get(key);
+    size_t low = 0;
+    size_t high = Size(node);
+    while (low < high) {
+      size_t mid = low + (high - low) / 2;
+      if (IsAbove(node, mid, key, prefix)) {
+        high = mid;
+      } else {
+        low = mid + 1;
+      }
+    }
+    return low;
+  }
+
+  static const Record* FindRecord(const Leaf* leaf, const Key& key) {
+    size_t index = LowerBound(leaf, key);
+    if (index == Size(leaf)) {
+      return nullptr;
+    }
+    const Record* record =
+        leaf->records[index].load(std::memory_order_acquire);
+    return record != nullptr && record->key == key ? record : nullptr;
+  }
+
+  // Copies count items between arrays, overlapping ranges included.
+  template <typename T, size_t N, size_t M>
+  static void MoveItems(const std::array<std::atomic<T>, N>& src,
+                        size_t from, std::array<std::atomic<T>, M>& dst,
+                        size_t to, size_t count) {
+    auto move = [&](size_t i) {
+      dst[to + i].store(src[from + i].load(std::memory_order_relaxed),
+                        std::memory_order_release);
+    };
+    if (static_cast<const void*>(&src) == &dst && from < to) {
+      for (size_t i = count; i > 0; --i) {
+        move(i - 1);
+      }
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        move(i);
+      }
+    }
+  }
+
+  static void SetSize(Node* node, size_t size) {
+    node->size.store(size, std::memory_order_release);
+  }
+
+  static void InsertIntoLeaf(Leaf* leaf, size_t index, const Record* record) {
+    size_t size = Size(leaf);
+    MoveItems(leaf->prefixes, index, leaf->prefixes, index + 1, size - index);
+    MoveItems(leaf->records, index, leaf->records, index + 1, size - index);
+    leaf->prefixes[index].store(Prefix::Get(record->key));
+    leaf->records[index].store(record, std::memory_order_release);
+    SetSize(leaf, size + 1);
+  }
+
+  static void EraseFromLeaf(Leaf* leaf, size_t index) {
+    size_t size = Size(leaf);
+    MoveItems(leaf->prefixes, index + 1, leaf->prefixes, index,
+              size - index - 1);
+    MoveItems(leaf->records, index + 1, leaf->records, index,
+              size - index - 1);
+    SetSize(leaf, size - 1);
+  }
+
+  // The child goes right after the key, at index + 1.
+  static void InsertIntoInner(Inner* inner, size_t index, const Key* key,
+                              Node* child) {
+    size_t size = Size(inner);
+    MoveItems(inner->prefixes, index, inner->prefixes, index + 1,
+              size - index);
+    MoveItems(inner->keys, index, inner->keys, index + 1, size - index);
+    MoveItems(inner->children, index + 1, inner->children, index + 2,
+              size - index);
+    inner->prefixes[index].store(Prefix::Get(*key));
+    inner->keys[index].store(key, std::memory_order_release);
+    inner->children[index + 1].store(child, std::memory_order_release);
+    SetSize(inner, size + 1);
+  }
+
+  static void EraseFromInner(Inner* inner, size_t index) {
+    size_t size = Size(inner);
+    MoveItems(inner->prefixes, index + 1, inner->prefixes, index,
+              size - index - 1);
+    MoveItems(inner->keys, index + 1, inner->keys, index, size - index - 1);
+    MoveItems(inner->children, index + 2, inner->children, index + 1,
+              size - index - 1);
+    SetSize(inner, size - 1);
+  }
+
+  static size_t ChildIndex(const Inner* parent, const Node* child) {
+    size_t index = 0;
+    while (parent->children[index].load(std::memory_order_acquire) != child) {
+      ++index;
+    }
+    return index;
+  }
+
+  // Descends to the leaf that may hold key, or to the leftmost leaf when
+  // key is null. Every child is latched before its parent is validated, so
+  // the leaf is the right one as long as its own version holds.
+  bool FindLeaf(const Key* key, Leaf** leaf, uint64_t* version) const {
+    Node* node = root_.load(std::memory_order_acquire);
+    if (!ReadLock(node, version) ||
+        node != root_.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    while (!node->is_leaf) {
+      size_t index = key == nullptr ? 0 : UpperBound(node, *key);
+      Node* child =
+          AsInner(node)->children[index].load(std::memory_order_acquire);
+      uint64_t child_version = 0;
+      if (child == nullptr || !ReadLock(child, &child_version) ||
+          !Validate(node, *version)) {
+        return false;
+      }
+      node = child;
+      *version = child_version;
+    }
+    *leaf = AsLeaf(node);
+
+    return true;
+  }
+
+  // Descends to the leaf whose range ends right below key, or to the
+  // rightmost leaf when key is null. fence is the separator the leaf's
+  // keys start from, null for the leftmost leaf.
+  bool FindLeafBefore(const Key* key, Leaf** leaf, uint64_t* version,
+                      const Key** fence) const {
+    Node* node = root_.load(std::memory_order_acquire);
+    if (!ReadLock(node, version) ||
+        node != root_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    *fence = nullptr;
+
+    while (!node->is_leaf) {
+      const Inner* inner = AsInner(node);
+      size_t index = key == nullptr ? Size(node) : LowerBound(node, *key);
+      Node* child = inner->children[index].load(std::memory_order_acquire);
+      const Key* low = index == 0
+                           ? nullptr
+                           : inner->keys[index - 1].load(
+                                 std::memory_order_acquire);
+      uint64_t child_version = 0;
+      if (child == nullptr || (index > 0 && low == nullptr) ||
+          !ReadLock(child, &child_version) || !Validate(node, *version)) {
+        return false;
+      }
+      if (low != nullptr) {
+        *fence = low;
+      }
+      node = child;
+      *version = child_version;
+    }
+    *leaf = AsLeaf(node);
+
+    return true;
+  }
+
+  bool TryFind(const Key& key, const Record** record) const {
+    Leaf* leaf = nullptr;
+    uint64_t version = 0;
+    if (!FindLeaf(&key, &leaf, &version)) {
+      return false;
+    }
+    *record = FindRecord(leaf, key);
+    return Validate(leaf, version);
+  }
+
+  // Locks node and its parent, or only node when it is the root.
+  static bool LockWithParent(Inner* parent, uint64_t parent_version,
+                             Node* node, uint64_t version) {
+    if (parent != nullptr && !Upgrade(parent, parent_version)) {
+      return false;
+    }
+    if (!Upgrade(node, version)) {
+      if (parent != nullptr) {
+        Unlock(parent);
+      }
+      return false;
+    }
+    return true;
+  }
+
+  static void UnlockWithParent(Inner* parent, Node* node) {
+    Unlock(node);
+    if (parent != nullptr) {
+      Unlock(parent);
+    }
+  }
+
+  bool TryInsert(const Key& key, const Value& value, bool* inserted) {
+    Node* node = root_.load(std::memory_order_acquire);
+    uint64_t version = 0;
+    if (!ReadLock(node, &version) ||
+        node != root_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    Inner* parent = nullptr;
+    uint64_t parent_version = 0;
+
+    while (true) {
+      if (Size(node) == kCapacity) {
+        if (LockWithParent(parent, parent_version, node, version)) {
+          Split(parent, node);
+          UnlockWithParent(parent, node);
+        }
+        return false;
+      }
+      if (node->is_leaf) {
+        break;
+      }
+
+      size_t index = UpperBound(node, key);
+      Node* child =
+          AsInner(node)->children[index].load(std::memory_order_acquire);
+      uint64_t child_version = 0;
+      if (child == nullptr || !ReadLock(child, &child_version) ||
+          !Validate(node, version)) {
+        return false;
+      }
+      parent = AsInner(node);
+      parent_version = version;
+      node = child;
+      version = child_version;
+    }
+
+    Leaf* leaf = AsLeaf(node);
+    if (!Upgrade(leaf, version)) {
+      return false;
+    }
+    size_t index = LowerBound(leaf, key);
+    if (index < Size(leaf) && leaf->records[index].load()->key == key) {
+      Unlock(leaf);
+      *inserted = false;
+      return true;
+    }
+    InsertIntoLeaf(leaf, index, new Record{key, value});
+    Unlock(leaf);
+    size_.fetch_add(1);
+    *inserted = true;
+
+    return true;
+  }
+
+  bool TryRemove(const Key& key, Value* value, bool* removed) {
+    Node* node = root_.load(std::memory_order_acquire);
+    uint64_t version = 0;
+    if (!ReadLock(node, &version) ||
+        node != root_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    if (!node->is_leaf && Size(node) == 0) {
+      CollapseRoot(AsInner(node), version);
+      return false;
+    }
+    Inner* parent = nullptr;
+    uint64_t parent_version = 0;
+
+    while (!node->is_leaf) {
+      if (parent != nullptr && Size(node) < kMergeThreshold &&
+          CanMerge(parent, node)) {
+        if (LockWithParent(parent, parent_version, node, version)) {
+          MergeWithNeighbour(parent, node);
+          Unlock(parent);
+        }
+        return false;
+      }
+
+      size_t index = UpperBound(node, key);
+      Node* child =
+          AsInner(node)->children[index].load(std::memory_order_acquire);
+      uint64_t child_version = 0;
+      if (child == nullptr || !ReadLock(child, &child_version) ||
+          !Validate(node, version)) {
+        return false;
+      }
+      parent = AsInner(node);
+      parent_version = version;
+      node = child;
+      version = child_version;
+    }
+
+    Leaf* leaf = AsLeaf(node);
+    if (!Upgrade(leaf, version)) {
+      return false;
+    }
+    size_t index = LowerBound(leaf, key);
+    const Record* record = index < Size(leaf) ? leaf->records[index].load()
+                                              : nullptr;
+    if (record == nullptr || !(record->key == key)) {
+      Unlock(leaf);
+      *removed = false;
+      return true;
+    }
+    if (value != nullptr) {
+      *value = record->value;
+    }
+    EraseFromLeaf(leaf, index);
+
+    // The record is gone either way, the merge is only attempted.
+    if (parent != nullptr && Size(leaf) < kMergeThreshold &&
+        Upgrade(parent, parent_version)) {
+      MergeWithNeighbour(parent, leaf);
+      Unlock(parent);
+    } else {
+      Unlock(leaf);
+    }
+    reclaimer_.Retire(record);
+    size_.fetch_sub(1);
+    *removed = true;
+
+    return true;
+  }
+
+  bool TryUpdate(const Key& key, const Value& value, bool* updated) {
+    Leaf* leaf = nullptr;
+    uint64_t version = 0;
+    if (!FindLeaf(&key, &leaf, &version) || !Upgrade(leaf, version)) {
+      return false;
+    }
+    size_t index = LowerBound(leaf, key);
+    const Record* record = index < Size(leaf) ? leaf->records[index].load()
+                                              : nullptr;
+    if (record == nullptr || !(record->key == key)) {
+      Unlock(leaf);
+      *updated = false;
+      return true;
+    }
+    leaf->records[index].store(new Record{key, value},
+                               std::memory_order_release);
+    Unlock(leaf);
+    reclaimer_.Retire(record);
+    *updated = true;
+
+    return true;
+  }
+
+  // Both nodes are locked, parent is null when node is the root.
+  void Split(Inner* parent, Node* node) {
+    const Key* separator = nullptr;
+    Node* right = node->is_leaf ? SplitLeaf(AsLeaf(node), &separator)
+                                : SplitInner(AsInner(node), &separator);
+
+    if (parent == nullptr) {
+      Inner* root = new Inner();
+      root->children[0].store(node, std::memory_order_release);
+      InsertIntoInner(root, 0, separator, right);
+      root_.store(root, std::memory_order_release);
+    } else {
+      InsertIntoInner(parent, UpperBound(parent, *separator), separator,
+                      right);
+    }
+  }
+
+  static Node* SplitLeaf(Leaf* leaf, const Key** separator) {
+    Leaf* right = new Leaf();
+    MoveItems(leaf->prefixes, Degree, right->prefixes, 0, Degree);
+    MoveItems(leaf->records, Degree, right->records, 0, Degree);
+    SetSize(right, Degree);
+    right->next.store(leaf->next.load(), std::memory_order_release);
+
+    leaf->next.store(right, std::memory_order_release);
+    SetSize(leaf, Degree);
+    *separator = new Key(right->records[0].load()->key);
+
+    return right;
+  }
+
+  // The middle key moves up to the parent.
+  static Node* SplitInner(Inner* inner, const Key** separator) {
+    Inner* right = new Inner();
+    MoveItems(inner->prefixes, Degree + 1, right->prefixes, 0, Degree - 1);
+    MoveItems(inner->keys, Degree + 1, right->keys, 0, Degree - 1);
+    MoveItems(inner->children, Degree + 1, right->children, 0, Degree);
+    SetSize(right, Degree - 1);
+
+    *separator = inner->keys[Degree].load();
+    SetSize(inner, Degree);
+
+    return right;
+  }
+
+  static bool Fits(const Node* left, const Node* right) {
+    size_t size = Size(left) + Size(right) + (left->is_leaf ? 0 : 1);
+    return size < kCapacity;
+  }
+
+  // Picks the left neighbour under the same parent, or the right one for
+  // the first child. The pair is returned in key order.
+  static bool GetPair(const Inner* parent, const Node* node, size_t* index,
+                      Node** left, Node** right) {
+    if (Size(parent) == 0) {
+      return false;
+    }
+    size_t position = 0;
+    while (position <= Size(parent) &&
+           parent->children[position].load(std::memory_order_acquire) !=
+               node) {
+      ++position;
+    }
+    if (position > Size(parent)) {
+      return false;
+    }
+    *index = position == 0 ? 0 : position - 1;
+    *left = parent->children[*index].load(std::memory_order_acquire);
+    *right = parent->children[*index + 1].load(std::memory_order_acquire);
+    return *left != nullptr && *right != nullptr;
+  }
+
+  // Optimistic check that keeps descents from restarting on an underfull
+  // node whose neighbour is too large to merge with.
+  static bool CanMerge(const Inner* parent, const Node* node) {
+    size_t index = 0;
+    Node* left = nullptr;
+    Node* right = nullptr;
+    return GetPair(parent, node, &index, &left, &right) && Fits(left, right);
+  }
+
+  // Parent and node are locked. Merges node with its neighbour when they
+  // fit into one node and unlocks node, parent stays locked.
+  void MergeWithNeighbour(Inner* parent, Node* node) {
+    size_t index = 0;
+    Node* left = nullptr;
+    Node* right = nullptr;
+    if (!GetPair(parent, node, &index, &left, &right)) {
+      Unlock(node);
+      return;
+    }
+    Node* neighbour = left == node ? right : left;
+    if (!TryLock(neighbour)) {
+      Unlock(node);
+      return;
+    }
+    if (!Fits(left, right)) {
+      Unlock(left);
+      Unlock(right);
+      return;
+    }
+
+    const Key* separator = parent->keys[index].load();
+    if (left->is_leaf) {
+      Leaf* left_leaf = AsLeaf(left);
+      Leaf* right_leaf = AsLeaf(right);
+      size_t size = Size(left);
+      MoveItems(right->prefixes, 0, left->prefixes, size, Size(right));
+      MoveItems(right_leaf->records, 0, left_leaf->records, size,
+                Size(right));
+      left_leaf->next.store(right_leaf->next.load(),
+                            std::memory_order_release);
+      SetSize(left, size + Size(right));
+      reclaimer_.Retire(separator);
+    } else {
+      Inner* left_inner = AsInner(left);
+      Inner* right_inner = AsInner(right);
+      InsertIntoInner(left_inner, Size(left), separator,
+                      right_inner->children[0].load());
+      size_t size = Size(left);
+      MoveItems(right->prefixes, 0, left->prefixes, size, Size(right));
+      MoveItems(right_inner->keys, 0, left_inner->keys, size, Size(right));
+      MoveItems(right_inner->children, 1, left_inner->children, size + 1,
+                Size(right));
+      SetSize(left, size + Size(right));
+    }
+    EraseFromInner(parent, index);
+
+    Unlock(left);
+    UnlockObsolete(right);
+    if (right->is_leaf) {
+      reclaimer_.Retire(AsLeaf(right));
+    } else {
+      reclaimer_.Retire(AsInner(right));
+    }
+  }
+
+  // A root left with a single child after a merge is replaced by it.
+  void CollapseRoot(Inner* root, uint64_t version) {
+    if (!Upgrade(root, version)) {
+      return;
+    }
+    root_.store(root->children[0].load(), std::memory_order_release);
+    UnlockObsolete(root);
+    reclaimer_.Retire(root);
+  }
+
+  // Groups are evened out, so none gets less than half of capacity.
+  static size_t GetGroupsCount(size_t count, size_t capacity) {
+    return (count + capacity - 1) / capacity;
+  }
+
+  static size_t GetGroupSize(size_t index, size_t count, size_t groups) {
+    return count / groups + (index < count % groups ? 1 : 0);
+  }
+
+  // Fills leaves and then inner nodes level by level. lows holds the
+  // smallest key under each node of the level, the separators of the
+  // parents are copies of them.
+  static Node* Build(const std::vector<const Record*>& records) {
+    if (records.empty()) {
+      return new Leaf();
+    }
+
+    std::vector<Node*> level;
+    std::vector<const Key*> lows;
+    size_t groups = GetGroupsCount(records.size(), kCapacity);
+    level.reserve(groups);
+    lows.reserve(groups);
+    Leaf* previous = nullptr;
+    for (size_t i = 0, pos = 0; i < groups; ++i) {
+      Leaf* leaf = new Leaf();
+      size_t size = GetGroupSize(i, records.size(), groups);
+      lows.push_back(&records[pos]->key);
+      for (size_t j = 0; j < size; ++j, ++pos) {
+        leaf->prefixes[j].store(Prefix::Get(records[pos]->key));
+        leaf->records[j].store(records[pos]);
+      }
+      SetSize(leaf, size);
+      if (previous != nullptr) {
+        previous->next.store(leaf);
+      }
+      previous = leaf;
+      level.push_back(leaf);
+    }
+
+    while (level.size() > 1) {
+      size_t parent_groups = GetGroupsCount(level.size(), kCapacity + 1);
+      std::vector<Node*> parents;
+      std::vector<const Key*> parent_lows;
+      parents.reserve(parent_groups);
+      parent_lows.reserve(parent_groups);
+      for (size_t i = 0, pos = 0; i < parent_groups; ++i) {
+        Inner* inner = new Inner();
+        size_t size = GetGroupSize(i, level.size(), parent_groups);
+        parent_lows.push_back(lows[pos]);
+        inner->children[0].store(level[pos]);
+        for (size_t j = 1; j < size; ++j) {
+          inner->prefixes[j - 1].store(Prefix::Get(*lows[pos + j]));
+          inner->keys[j - 1].store(new Key(*lows[pos + j]));
+          inner->children[j].store(level[pos + j]);
+        }
+        SetSize(inner, size - 1);
+        pos += size;
+        parents.push_back(inner);
+      }
+      level = std::move(parents);
+      lows = std::move(parent_lows);
+    }
+
+    return level.front();
+  }
+
+  static void Clear(Node* node) {
+    if (node->is_leaf) {
+      Leaf* leaf = AsLeaf(node);
+      for (size_t i = 0; i < Size(leaf); ++i) {
+        delete leaf->records[i].load();
+      }
+      delete leaf;
+      return;
+    }
+    Inner* inner = AsInner(node);
+    for (size_t i = 0; i < Size(inner); ++i) {
+      delete inner->keys[i].load();
+    }
+    for (size_t i = 0; i <= Size(inner); ++i) {
+      Clear(inner->children[i].load());
+    }
+    delete inner;
+  }
+
+  std::atomic<Node*> root_;
+  std::atomic<size_t> size_{0};
+  mutable EpochReclaimer reclaimer_;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_CONCURRENT_TREE_H_
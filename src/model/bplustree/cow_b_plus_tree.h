@@ -0,0 +1,125 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_COW_B_PLUS_TREE_H_
+#define TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_COW_B_PLUS_TREE_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "model/bplustree/cow_tree.h"
+#include "model/common/basestorage.h"
+
+namespace s21 {
+
+// B+ tree storage whose copies are O(1) snapshots. Exports, backups and
+// long scans can run against a snapshot, on another thread too, while
+// writes to the storage go on.
+template <typename Key, typename Value,
+          typename ValueEqual = std::equal_to<Value>,
+          size_t Degree = kDefaultDegree>
+class CowBPlusTree : public BaseStorage<Key, Value> {
+ public:
+  class Cursor : public BaseCursor<Key, Value> {
+   public:
+    explicit Cursor(const CowTree<Key, Value, Degree>& tree)
+        : cursor_(tree) {}
+
+    bool IsValid() const override { return cursor_.IsValid(); }
+    void Seek(const Key& key) override { cursor_.Seek(key); }
+    void SeekToFirst() override { cursor_.SeekToFirst(); }
+    void SeekToLast() override { cursor_.SeekToLast(); }
+    void Next() override { cursor_.Next(); }
+    void Prev() override { cursor_.Prev(); }
+    const Key& GetKey() const override { return cursor_.GetKey(); }
+    const Value& GetValue() const override { return cursor_.GetValue(); }
+
+   private:
+    typename CowTree<Key, Value, Degree>::Cursor cursor_;
+  };
+
+  CowBPlusTree() {}
+
+  CowBPlusTree(const CowBPlusTree&) = default;
+  CowBPlusTree& operator=(const CowBPlusTree&) = default;
+
+  ~CowBPlusTree() override = default;
+
+  CowBPlusTree Snapshot() const { return *this; }
+
+  // Shares every node with this storage until one of them writes.
+  std::unique_ptr<BaseStorage<Key, Value>> Clone() const override {
+    return std::make_unique<CowBPlusTree>(*this);
+  }
+
+  bool Set(const Key& key, const Value& value) override {
+    return tree_.Insert(key, value);
+  }
+
+  Value Get(const Key& key) const override { return tree_.Search(key); }
+
+  bool Exists(const Key& key) const override { return tree_.Exists(key); }
+
+  bool Del(const Key& key) override { return tree_.Remove(key); }
+
+  bool Update(const Key& key, const Value& value) override {
+    return tree_.Update(key, value);
+  }
+
+  std::vector<Key> Keys() const override {
+    std::vector<Key> keys;
+    auto cursor = tree_.GetCursor();
+    for (cursor.SeekToFirst(); cursor.IsValid(); cursor.Next()) {
+      keys.push_back(cursor.GetKey());
+    }
+    return keys;
+  }
+
+  bool Rename(const Key& key, const Key& new_key) override {
+    if (tree_.Exists(new_key) || !tree_.Exists(key)) {
+      return false;
+    }
+    Value value = tree_.Search(key);
+    tree_.Remove(key);
+    return tree_.Insert(new_key, value);
+  }
+
+  std::vector<Key> Find(const Value& value) const override {
+    std::vector<Key> result;
+    ValueEqual equal;
+
+    auto cursor = tree_.GetCursor();
+    for (cursor.SeekToFirst(); cursor.IsValid(); cursor.Next()) {
+      if (equal(cursor.GetValue(), value)) {
+        result.push_back(cursor.GetKey());
+      }
+    }
+
+    return result;
+  }
+
+  std::vector<Value> Showall() const override {
+    std::vector<Value> values;
+    auto cursor = tree_.GetCursor();
+    for (cursor.SeekToFirst(); cursor.IsValid(); cursor.Next()) {
+      values.push_back(cursor.GetValue());
+    }
+    return values;
+  }
+
+  std::unique_ptr<BaseCursor<Key, Value>> GetCursor() const override {
+    return std::make_unique<Cursor>(tree_);
+  }
+
+  std::vector<std::pair<Key, Value>> Scan(const Key& from, const Key& to,
+                                          size_t limit) const override {
+    return tree_.Scan(from, to, limit);
+  }
+
+  size_t GetSize() const { return tree_.GetSize(); }
+
+ private:
+  CowTree<Key, Value, Degree> tree_;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_COW_B_PLUS_TREE_H_
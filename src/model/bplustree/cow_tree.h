@@ -0,0 +1,537 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_COW_TREE_H_
+#define TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_COW_TREE_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "model/bplustree/tree.h"
+
+namespace s21 {
+
+// Persistent B+ tree. Nodes are shared between versions and reference
+// counted, and a write copies only the shared nodes on the path it
+// changes. Copying a tree is O(1) and gives a snapshot that later writes
+// to either copy leave alone.
+//
+// A node may belong to many versions, so it has no parent or sibling
+// links: writes carry their path down from the root and cursors keep it
+// on a stack. A snapshot may be read and dropped on another thread while
+// the tree it was taken from keeps changing, taking it has to be ordered
+// with the writes.
+template <typename Key, typename Value, size_t Degree = kDefaultDegree>
+class CowTree {
+  static_assert(Degree > 0, "Tree degree must be positive");
+
+ public:
+  // Nodes hold up to 2 * Degree keys and briefly one more before a split.
+  static constexpr size_t kCapacity = 2 * Degree + 1;
+
+  struct Node {
+    explicit Node(bool leaf) : is_leaf(leaf) {}
+
+    std::atomic<size_t> refs{1};
+    bool is_leaf;
+    size_t size{};
+    std::array<Key, kCapacity> keys{};
+  };
+
+  struct Leaf : Node {
+    Leaf() : Node(true) {}
+
+    std::array<Value, kCapacity> values{};
+  };
+
+  struct Inner : Node {
+    Inner() : Node(false) {}
+
+    std::array<Node*, kCapacity + 1> children{};
+  };
+
+  // Keeps the path from the root on a stack, a step past the end of a
+  // leaf climbs to the next subtree.
+  class Cursor {
+   public:
+    explicit Cursor(const CowTree& tree) : root_(tree.root_) {}
+
+    bool IsValid() const { return !path_.empty(); }
+
+    void Seek(const Key& key) {
+      path_.clear();
+      Node* node = root_;
+      while (node != nullptr && !node->is_leaf) {
+        size_t index = UpperBound(node, key);
+        path_.push_back({node, index});
+        node = AsInner(node)->children[index];
+      }
+      if (node != nullptr) {
+        path_.push_back({node, LowerBound(node, key)});
+        if (path_.back().index == node->size) {
+          Next();
+        }
+      }
+    }
+
+    void SeekToFirst() {
+      path_.clear();
+      Descend(root_, false);
+    }
+
+    void SeekToLast() {
+      path_.clear();
+      Descend(root_, true);
+    }
+
+    void Next() {
+      if (++path_.back().index < path_.back().node->size) {
+        return;
+      }
+      path_.pop_back();
+      while (!path_.empty() && path_.back().index == path_.back().node->size) {
+        path_.pop_back();
+      }
+      if (!path_.empty()) {
+        Step& step = path_.back();
+        Descend(AsInner(step.node)->children[++step.index], false);
+      }
+    }
+
+    void Prev() {
+      if (path_.back().index > 0) {
+        --path_.back().index;
+        return;
+      }
+      path_.pop_back();
+      while (!path_.empty() && path_.back().index == 0) {
+        path_.pop_back();
+      }
+      if (!path_.empty()) {
+        Step& step = path_.back();
+        Descend(AsInner(step.node)->children[--step.index], true);
+      }
+    }
+
+    const Key& GetKey() const {
+      return path_.back().node->keys[path_.back().index];
+    }
+
+    const Value& GetValue() const {
+      return AsLeaf(path_.back().node)->values[path_.back().index];
+    }
+
+   private:
+    struct Step {
+      Node* node;
+      size_t index;
+    };
+
+    // An empty tree is a null root, every other node has keys.
+    void Descend(Node* node, bool last) {
+      while (node != nullptr) {
+        size_t index = last ? node->size : 0;
+        if (node->is_leaf) {
+          path_.push_back({node, last ? index - 1 : index});
+          return;
+        }
+        path_.push_back({node, index});
+        node = AsInner(node)->children[index];
+      }
+    }
+
+    Node* root_;
+    std::vector<Step> path_;
+  };
+
+  CowTree() {}
+
+  CowTree(const CowTree& other) : size_(other.size_), root_(other.root_) {
+    Acquire(root_);
+  }
+
+  CowTree(CowTree&& other) noexcept
+      : size_(other.size_), root_(other.root_) {
+    other.size_ = 0;
+    other.root_ = nullptr;
+  }
+
+  CowTree& operator=(const CowTree& other) {
+    Acquire(other.root_);
+    Release(root_);
+    root_ = other.root_;
+    size_ = other.size_;
+    return *this;
+  }
+
+  ~CowTree() { Release(root_); }
+
+  // Same as a copy, named for the call sites that keep it as a
+  // point-in-time view.
+  CowTree Snapshot() const { return *this; }
+
+  bool Exists(const Key& key) const {
+    const Leaf* leaf = SearchLeaf(key);
+    if (leaf == nullptr) {
+      return false;
+    }
+    size_t index = LowerBound(leaf, key);
+    return index < leaf->size && leaf->keys[index] == key;
+  }
+
+  const Value& Search(const Key& key) const {
+    const Leaf* leaf = SearchLeaf(key);
+    if (leaf == nullptr) {
+      throw std::invalid_argument("Key not found");
+    }
+    size_t index = LowerBound(leaf, key);
+    if (index == leaf->size || !(leaf->keys[index] == key)) {
+      throw std::invalid_argument("Key not found");
+    }
+    return leaf->values[index];
+  }
+
+  // Writes look the key up first, so a write that changes nothing copies
+  // nothing either.
+  bool Insert(const Key& key, const Value& value) {
+    if (Exists(key)) {
+      return false;
+    }
+    if (root_ == nullptr) {
+      root_ = new Leaf();
+    }
+    std::vector<Step> path;
+    Leaf* leaf = OwnPath(key, path);
+    size_t index = LowerBound(leaf, key);
+    InsertAt(leaf->keys, leaf->size, index, key);
+    InsertAt(leaf->values, leaf->size, index, value);
+    ++leaf->size;
+    SplitUp(path, leaf);
+    ++size_;
+    return true;
+  }
+
+  bool Remove(const Key& key) {
+    if (!Exists(key)) {
+      return false;
+    }
+    std::vector<Step> path;
+    Leaf* leaf = OwnPath(key, path);
+    size_t index = LowerBound(leaf, key);
+    EraseAt(leaf->keys, leaf->size, index);
+    EraseAt(leaf->values, leaf->size, index);
+    --leaf->size;
+    RebalanceUp(path, leaf);
+    --size_;
+    return true;
+  }
+
+  bool Update(const Key& key, const Value& value) {
+    if (!Exists(key)) {
+      return false;
+    }
+    std::vector<Step> path;
+    Leaf* leaf = OwnPath(key, path);
+    leaf->values[LowerBound(leaf, key)] = value;
+    return true;
+  }
+
+  Cursor GetCursor() const { return Cursor(*this); }
+
+  std::vector<std::pair<Key, Value>> Scan(const Key& from, const Key& to,
+                                          size_t limit) const {
+    std::vector<std::pair<Key, Value>> result;
+    Cursor cursor(*this);
+
+    cursor.Seek(from);
+    while (cursor.IsValid() && result.size() < limit &&
+           !(to < cursor.GetKey())) {
+      result.emplace_back(cursor.GetKey(), cursor.GetValue());
+      cursor.Next();
+    }
+
+    return result;
+  }
+
+  size_t GetSize() const { return size_; }
+
+  // Nodes this version shares with others, for tests.
+  size_t GetSharedCount() const { return CountShared(root_, false); }
+
+ private:
+  // The child at index of an inner node on the way down.
+  struct Step {
+    Inner* node;
+    size_t index;
+  };
+
+  size_t size_ = 0;
+  Node* root_{};
+
+  static Leaf* AsLeaf(Node* node) { return static_cast<Leaf*>(node); }
+
+  static Inner* AsInner(Node* node) { return static_cast<Inner*>(node); }
+
+  static size_t LowerBound(const Node* node, const Key& key) {
+    return std::lower_bound(node->keys.begin(),
+                            node->keys.begin() + node->size, key) -
+           node->keys.begin();
+  }
+
+  static size_t UpperBound(const Node* node, const Key& key) {
+    return std::upper_bound(node->keys.begin(),
+                            node->keys.begin() + node->size, key) -
+           node->keys.begin();
+  }
+
+  template <typename T, size_t N>
+  static void InsertAt(std::array<T, N>& items, size_t size, size_t index,
+                       T item) {
+    std::move_backward(items.begin() + index, items.begin() + size,
+                       items.begin() + size + 1);
+    items[index] = std::move(item);
+  }
+
+  template <typename T, size_t N>
+  static void EraseAt(std::array<T, N>& items, size_t size, size_t index) {
+    std::move(items.begin() + index + 1, items.begin() + size,
+              items.begin() + index);
+  }
+
+  static void Acquire(Node* node) {
+    if (node != nullptr) {
+      node->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  // The last version to let go of a node frees it along with the children
+  // nobody else holds.
+  static void Release(Node* node) {
+    if (node == nullptr ||
+        node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    if (node->is_leaf) {
+      delete AsLeaf(node);
+      return;
+    }
+    for (size_t i = 0; i <= node->size; ++i) {
+      Release(AsInner(node)->children[i]);
+    }
+    delete AsInner(node);
+  }
+
+  // Drops a node this version owns whose children, if any, have already
+  // been handed over to another node.
+  static void DeleteNode(Node* node) {
+    if (node->is_leaf) {
+      delete AsLeaf(node);
+    } else {
+      delete AsInner(node);
+    }
+  }
+
+  static Node* Copy(Node* node) {
+    if (node->is_leaf) {
+      Leaf* copy = new Leaf();
+      std::copy_n(AsLeaf(node)->values.begin(), node->size,
+                  copy->values.begin());
+      std::copy_n(node->keys.begin(), node->size, copy->keys.begin());
+      copy->size = node->size;
+      return copy;
+    }
+    Inner* copy = new Inner();
+    for (size_t i = 0; i <= node->size; ++i) {
+      copy->children[i] = AsInner(node)->children[i];
+      Acquire(copy->children[i]);
+    }
+    std::copy_n(node->keys.begin(), node->size, copy->keys.begin());
+    copy->size = node->size;
+    return copy;
+  }
+
+  // A node only this version holds is changed in place, a shared one is
+  // swapped for a private copy first. The copy holds the children too, so
+  // they become shared and the path gets copied on the way down.
+  static Node* Own(Node*& slot) {
+    if (slot->refs.load(std::memory_order_acquire) != 1) {
+      Node* copy = Copy(slot);
+      Release(slot);
+      slot = copy;
+    }
+    return slot;
+  }
+
+  static size_t CountShared(Node* node, bool shared) {
+    if (node == nullptr) {
+      return 0;
+    }
+    shared = shared || node->refs.load(std::memory_order_acquire) > 1;
+    size_t count = shared ? 1 : 0;
+    if (!node->is_leaf) {
+      for (size_t i = 0; i <= node->size; ++i) {
+        count += CountShared(AsInner(node)->children[i], shared);
+      }
+    }
+    return count;
+  }
+
+  const Leaf* SearchLeaf(const Key& key) const {
+    Node* node = root_;
+    while (node != nullptr && !node->is_leaf) {
+      node = AsInner(node)->children[UpperBound(node, key)];
+    }
+    return AsLeaf(node);
+  }
+
+  Leaf* OwnPath(const Key& key, std::vector<Step>& path) {
+    Node* node = Own(root_);
+    while (!node->is_leaf) {
+      Inner* inner = AsInner(node);
+      size_t index = UpperBound(inner, key);
+      path.push_back({inner, index});
+      node = Own(inner->children[index]);
+    }
+    return AsLeaf(node);
+  }
+
+  void SplitUp(std::vector<Step>& path, Node* node) {
+    while (node->size > 2 * Degree) {
+      Node* right = nullptr;
+      Key separator;
+      if (node->is_leaf) {
+        right = new Leaf();
+        std::move(AsLeaf(node)->values.begin() + Degree,
+                  AsLeaf(node)->values.begin() + node->size,
+                  AsLeaf(right)->values.begin());
+        std::move(node->keys.begin() + Degree,
+                  node->keys.begin() + node->size, right->keys.begin());
+        right->size = node->size - Degree;
+        separator = right->keys[0];
+      } else {
+        right = new Inner();
+        std::move(AsInner(node)->children.begin() + Degree + 1,
+                  AsInner(node)->children.begin() + node->size + 1,
+                  AsInner(right)->children.begin());
+        std::move(node->keys.begin() + Degree + 1,
+                  node->keys.begin() + node->size, right->keys.begin());
+        right->size = node->size - Degree - 1;
+        separator = std::move(node->keys[Degree]);
+      }
+      node->size = Degree;
+
+      if (path.empty()) {
+        Inner* root = new Inner();
+        root->children[0] = node;
+        root->children[1] = right;
+        root->keys[0] = std::move(separator);
+        root->size = 1;
+        root_ = root;
+        return;
+      }
+      auto [parent, index] = path.back();
+      path.pop_back();
+      InsertAt(parent->keys, parent->size, index, std::move(separator));
+      InsertAt(parent->children, parent->size + 1, index + 1, right);
+      ++parent->size;
+      node = parent;
+    }
+  }
+
+  // Neighbours are copied too when they are shared, only borrows and
+  // merges touch them.
+  void RebalanceUp(std::vector<Step>& path, Node* node) {
+    while (!path.empty() && node->size < Degree) {
+      auto [parent, index] = path.back();
+      path.pop_back();
+      if (index > 0 && parent->children[index - 1]->size > Degree) {
+        BorrowFromLeft(parent, index);
+      } else if (index < parent->size &&
+                 parent->children[index + 1]->size > Degree) {
+        BorrowFromRight(parent, index);
+      } else if (index > 0) {
+        Merge(parent, index - 1);
+      } else {
+        Merge(parent, index);
+      }
+      node = parent;
+    }
+
+    if (root_->size > 0) {
+      return;
+    }
+    Node* root = root_;
+    root_ = root->is_leaf ? nullptr : AsInner(root)->children[0];
+    DeleteNode(root);
+  }
+
+  static void BorrowFromLeft(Inner* parent, size_t index) {
+    Node* left = Own(parent->children[index - 1]);
+    Node* node = parent->children[index];
+    size_t last = left->size - 1;
+    if (node->is_leaf) {
+      InsertAt(AsLeaf(node)->values, node->size, 0,
+               std::move(AsLeaf(left)->values[last]));
+      InsertAt(node->keys, node->size, 0, std::move(left->keys[last]));
+      parent->keys[index - 1] = node->keys[0];
+    } else {
+      InsertAt(AsInner(node)->children, node->size + 1, 0,
+               AsInner(left)->children[left->size]);
+      InsertAt(node->keys, node->size, 0,
+               std::move(parent->keys[index - 1]));
+      parent->keys[index - 1] = std::move(left->keys[last]);
+    }
+    --left->size;
+    ++node->size;
+  }
+
+  static void BorrowFromRight(Inner* parent, size_t index) {
+    Node* node = parent->children[index];
+    Node* right = Own(parent->children[index + 1]);
+    if (node->is_leaf) {
+      AsLeaf(node)->values[node->size] = std::move(AsLeaf(right)->values[0]);
+      node->keys[node->size] = std::move(right->keys[0]);
+      EraseAt(AsLeaf(right)->values, right->size, 0);
+      EraseAt(right->keys, right->size, 0);
+      parent->keys[index] = right->keys[0];
+    } else {
+      AsInner(node)->children[node->size + 1] = AsInner(right)->children[0];
+      node->keys[node->size] = std::move(parent->keys[index]);
+      parent->keys[index] = std::move(right->keys[0]);
+      EraseAt(AsInner(right)->children, right->size + 1, 0);
+      EraseAt(right->keys, right->size, 0);
+    }
+    --right->size;
+    ++node->size;
+  }
+
+  // Moves the child at index + 1 into the one at index. The separator
+  // between them comes down into merged inner nodes.
+  static void Merge(Inner* parent, size_t index) {
+    Node* left = Own(parent->children[index]);
+    Node* right = Own(parent->children[index + 1]);
+    if (left->is_leaf) {
+      std::move(AsLeaf(right)->values.begin(),
+                AsLeaf(right)->values.begin() + right->size,
+                AsLeaf(left)->values.begin() + left->size);
+    } else {
+      left->keys[left->size++] = std::move(parent->keys[index]);
+      std::move(AsInner(right)->children.begin(),
+                AsInner(right)->children.begin() + right->size + 1,
+                AsInner(left)->children.begin() + left->size);
+    }
+    std::move(right->keys.begin(), right->keys.begin() + right->size,
+              left->keys.begin() + left->size);
+    left->size += right->size;
+
+    EraseAt(parent->keys, parent->size, index);
+    EraseAt(parent->children, parent->size + 1, index + 1);
+    --parent->size;
+    DeleteNode(right);
+  }
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_COW_TREE_H_
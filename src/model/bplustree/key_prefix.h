@@ -0,0 +1,107 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_KEY_PREFIX_H_
+#define TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_KEY_PREFIX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+namespace s21 {
+
+// Order-preserving 64-bit image of a key: a < b implies Get(a) <= Get(b).
+// Nodes keep the prefixes of their keys next to each other, so an in-node
+// search compares packed integers and touches full keys only on a tie.
+// Exact prefixes are injective, then a tie already means equal keys.
+template <typename Key, typename = void>
+struct KeyPrefix {
+  static constexpr bool kEnabled = false;
+  static constexpr bool kExact = false;
+
+  static uint64_t Get(const Key&) { return 0; }
+};
+
+template <typename Key>
+struct KeyPrefix<Key, std::enable_if_t<std::is_integral_v<Key>>> {
+  static constexpr bool kEnabled = true;
+  static constexpr bool kExact = true;
+
+  static uint64_t Get(Key key) {
+    if constexpr (std::is_signed_v<Key>) {
+      return static_cast<uint64_t>(static_cast<int64_t>(key)) ^
+             (uint64_t{1} << 63);
+    } else {
+      return static_cast<uint64_t>(key);
+    }
+  }
+};
+
+// The first eight bytes in big-endian order, zero padded. Nodes that strip
+// the common prefix of their keys take it from the remaining suffix.
+template <>
+struct KeyPrefix<std::string> {
+  static constexpr bool kEnabled = true;
+  static constexpr bool kExact = false;
+
+  static uint64_t Get(std::string_view key) {
+    uint64_t prefix = 0;
+    size_t length = key.size() < 8 ? key.size() : 8;
+    for (size_t i = 0; i < length; ++i) {
+      prefix |= static_cast<uint64_t>(static_cast<unsigned char>(key[i]))
+                << (56 - 8 * i);
+    }
+    return prefix;
+  }
+};
+
+// Number of values below target, counted without branches so that the
+// loop runs over whole vectors.
+inline size_t CountLess(const uint64_t* values, size_t count,
+                        uint64_t target) {
+  size_t result = 0;
+  size_t i = 0;
+#if defined(__AVX2__)
+  const __m256i flip = _mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+  const __m256i bound =
+      _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(target)), flip);
+  for (; i + 4 <= count; i += 4) {
+    __m256i chunk = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)),
+        flip);
+    int mask = _mm256_movemask_pd(
+        _mm256_castsi256_pd(_mm256_cmpgt_epi64(bound, chunk)));
+    result += __builtin_popcount(mask);
+  }
+#elif defined(__SSE4_2__)
+  const __m128i flip = _mm_set1_epi64x(std::numeric_limits<int64_t>::min());
+  const __m128i bound =
+      _mm_xor_si128(_mm_set1_epi64x(static_cast<int64_t>(target)), flip);
+  for (; i + 2 <= count; i += 2) {
+    __m128i chunk = _mm_xor_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)), flip);
+    int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(bound, chunk)));
+    result += __builtin_popcount(mask);
+  }
+#endif
+  for (; i < count; ++i) {
+    result += values[i] < target ? 1 : 0;
+  }
+  return result;
+}
+
+inline size_t CountLessOrEqual(const uint64_t* values, size_t count,
+                               uint64_t target) {
+  if (target == std::numeric_limits<uint64_t>::max()) {
+    return count;
+  }
+  return CountLess(values, count, target + 1);
+}
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_KEY_PREFIX_H_
@@ -0,0 +1,98 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_LEARNED_INDEX_H_
+#define TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_LEARNED_INDEX_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace s21 {
+
+// Piecewise linear model of where a key sits in a sorted array, built in
+// one pass over the order-preserving 64-bit images of the keys like a PGM
+// index. Each segment predicts the position of the images it was built
+// from to within kEpsilon, and there are few enough segments for their
+// search to stay in cache.
+class LearnedIndex {
+ public:
+  static constexpr size_t kEpsilon = 8;
+
+  // Images are non-decreasing, a run of equal ones maps to its first
+  // position. A segment grows while some line through its first point
+  // still passes within kEpsilon of every point, the allowed slopes
+  // narrow down with each point.
+  void Build(const std::vector<uint64_t>& images) {
+    firsts_.clear();
+    segments_.clear();
+    size_ = images.size();
+    if (images.empty()) {
+      return;
+    }
+
+    const double epsilon = static_cast<double>(kEpsilon);
+    size_t start = 0;
+    double low = 0;
+    double high = std::numeric_limits<double>::infinity();
+    for (size_t i = 1; i < images.size(); ++i) {
+      if (images[i] == images[i - 1]) {
+        continue;
+      }
+      double dx = static_cast<double>(images[i] - images[start]);
+      double dy = static_cast<double>(i - start);
+      double new_low = std::max(low, (dy - epsilon) / dx);
+      double new_high = std::min(high, (dy + epsilon) / dx);
+      if (new_low > new_high) {
+        AddSegment(images[start], start, low, high);
+        start = i;
+        low = 0;
+        high = std::numeric_limits<double>::infinity();
+      } else {
+        low = new_low;
+        high = new_high;
+      }
+    }
+    AddSegment(images[start], start, low, high);
+  }
+
+  // Never past the start of the next segment, so images between two
+  // segments stay close as well.
+  size_t Predict(uint64_t image) const {
+    size_t next = std::upper_bound(firsts_.begin(), firsts_.end(), image) -
+                  firsts_.begin();
+    if (next == 0) {
+      return 0;
+    }
+    const Segment& segment = segments_[next - 1];
+    double position =
+        static_cast<double>(segment.position) +
+        segment.slope * static_cast<double>(image - firsts_[next - 1]);
+    size_t limit =
+        next < segments_.size() ? segments_[next].position : size_ - 1;
+    return std::min(static_cast<size_t>(position), limit);
+  }
+
+  size_t GetSegmentsCount() const { return segments_.size(); }
+
+ private:
+  struct Segment {
+    size_t position;
+    double slope;
+  };
+
+  void AddSegment(uint64_t first, size_t position, double low, double high) {
+    double slope = high == std::numeric_limits<double>::infinity()
+                       ? low
+                       : (low + high) / 2;
+    firsts_.push_back(first);
+    segments_.push_back({position, slope});
+  }
+
+  std::vector<uint64_t> firsts_;
+  std::vector<Segment> segments_;
+  size_t size_ = 0;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_LEARNED_INDEX_H_
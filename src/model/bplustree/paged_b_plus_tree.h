@@ -0,0 +1,135 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_PAGED_B_PLUS_TREE_H_
+#define TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_PAGED_B_PLUS_TREE_H_
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "model/bplustree/paged_tree.h"
+#include "model/common/basestorage.h"
+
+namespace s21 {
+
+// B+ tree storage kept in a local file. Records survive a restart of the
+// program and only the recently used pages are held in memory, so the
+// dataset may be larger than RAM.
+template <typename Key, typename Value,
+          typename ValueEqual = std::equal_to<Value>>
+class PagedBPlusTree : public BaseStorage<Key, Value> {
+ public:
+  class Cursor : public BaseCursor<Key, Value> {
+   public:
+    explicit Cursor(const PagedTree<Key, Value>& tree) : cursor_(tree) {}
+
+    bool IsValid() const override { return cursor_.IsValid(); }
+    void Seek(const Key& key) override { cursor_.Seek(key); }
+    void SeekToFirst() override { cursor_.SeekToFirst(); }
+    void SeekToLast() override { cursor_.SeekToLast(); }
+    void Next() override { cursor_.Next(); }
+    void Prev() override { cursor_.Prev(); }
+    const Key& GetKey() const override { return cursor_.GetKey(); }
+    const Value& GetValue() const override { return cursor_.GetValue(); }
+
+   private:
+    typename PagedTree<Key, Value>::Cursor cursor_;
+  };
+
+  explicit PagedBPlusTree(const std::string& path,
+                          size_t cached_pages = kDefaultCachedPages)
+      : tree_(path, cached_pages) {}
+
+  PagedBPlusTree(const PagedBPlusTree&) = delete;
+  PagedBPlusTree& operator=(const PagedBPlusTree&) = delete;
+
+  ~PagedBPlusTree() override = default;
+
+  // A copy would need a page file of its own.
+  std::unique_ptr<BaseStorage<Key, Value>> Clone() const override {
+    throw std::logic_error("Paged storage cannot be cloned");
+  }
+
+  bool Set(const Key& key, const Value& value) override {
+    return tree_.Insert(key, value);
+  }
+
+  Value Get(const Key& key) const override { return tree_.Search(key); }
+
+  bool Exists(const Key& key) const override { return tree_.Exists(key); }
+
+  bool Del(const Key& key) override { return tree_.Remove(key); }
+
+  bool Update(const Key& key, const Value& value) override {
+    return tree_.Update(key, value);
+  }
+
+  std::vector<Key> Keys() const override {
+    std::vector<Key> keys;
+    tree_.ForEach(nullptr, [&keys](const Key& key, const Value&) {
+      keys.push_back(key);
+      return true;
+    });
+    return keys;
+  }
+
+  bool Rename(const Key& key, const Key& new_key) override {
+    if (tree_.Exists(new_key) || !tree_.Exists(key)) {
+      return false;
+    }
+    Value value = tree_.Search(key);
+    tree_.Remove(key);
+    return tree_.Insert(new_key, value);
+  }
+
+  std::vector<Key> Find(const Value& value) const override {
+    std::vector<Key> result;
+    ValueEqual equal;
+
+    tree_.ForEach(nullptr, [&](const Key& key, const Value& record) {
+      if (equal(record, value)) {
+        result.push_back(key);
+      }
+      return true;
+    });
+
+    return result;
+  }
+
+  std::vector<Value> Showall() const override {
+    std::vector<Value> values;
+    tree_.ForEach(nullptr, [&values](const Key&, const Value& value) {
+      values.push_back(value);
+      return true;
+    });
+    return values;
+  }
+
+  std::unique_ptr<BaseCursor<Key, Value>> GetCursor() const override {
+    return std::make_unique<Cursor>(tree_);
+  }
+
+  std::vector<std::pair<Key, Value>> Scan(const Key& from, const Key& to,
+                                          size_t limit) const override {
+    std::vector<std::pair<Key, Value>> result;
+    tree_.ForEach(&from, [&](const Key& key, const Value& value) {
+      if (result.size() == limit || to < key) {
+        return false;
+      }
+      result.emplace_back(key, value);
+      return true;
+    });
+    return result;
+  }
+
+  void Flush() { tree_.Flush(); }
+
+  size_t GetSize() const { return tree_.GetSize(); }
+
+ private:
+  PagedTree<Key, Value> tree_;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_PAGED_B_PLUS_TREE_H_
@@ -0,0 +1,483 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_PAGED_TREE_H_
+#define TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_PAGED_TREE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "model/common/buffermanager.h"
+#include "model/common/pagecodec.h"
+#include "model/common/pagefile.h"
+
+namespace s21 {
+
+inline constexpr size_t kDefaultCachedPages = 1024;
+
+// B+ tree whose nodes are pages of a PageFile. Nodes hold as many records
+// as fit in a page and split by bytes, so keys and values may have any
+// length up to kMaxRecordBytes. Deletes free a node once it is empty, as
+// RebalancePolicy::kFreeAtEmpty does for Tree. At most cached_pages
+// decoded nodes stay in memory between operations.
+template <typename Key, typename Value>
+class PagedTree {
+  struct Node;
+
+ public:
+  static constexpr size_t kPageSize = PageFile::kPageSize;
+  // Checksum, type, count and the two level links.
+  static constexpr size_t kHeaderBytes = 16;
+  // A quarter of the page, both halves of a split always fit.
+  static constexpr size_t kMaxRecordBytes = (kPageSize - kHeaderBytes) / 4;
+
+  class Cursor {
+   public:
+    explicit Cursor(const PagedTree& tree) : tree_(&tree) {}
+
+    bool IsValid() const { return ind_ < keys_.size(); }
+
+    void Seek(const Key& key) {
+      const Node* leaf = tree_->SearchLeaf(key, nullptr);
+      Load(leaf, tree_->LowerBound(leaf, key));
+    }
+
+    void SeekToFirst() { Load(tree_->EdgeLeaf(false), 0); }
+
+    void SeekToLast() {
+      const Node* leaf = tree_->EdgeLeaf(true);
+      Load(leaf, leaf->keys.empty() ? 0 : leaf->keys.size() - 1);
+    }
+
+    void Next() {
+      if (++ind_ == keys_.size() && next_ != kNoPage) {
+        Load(tree_->Fetch(next_), 0);
+      }
+    }
+
+    void Prev() {
+      if (ind_ > 0) {
+        --ind_;
+      } else if (prev_ != kNoPage) {
+        const Node* leaf = tree_->Fetch(prev_);
+        Load(leaf, leaf->keys.size() - 1);
+      } else {
+        ind_ = keys_.size();
+      }
+    }
+
+    const Key& GetKey() const { return keys_[ind_]; }
+
+    const Value& GetValue() const { return values_[ind_]; }
+
+   private:
+    // The leaf is copied, decoded nodes may be evicted by later calls.
+    void Load(const Node* leaf, size_t ind) {
+      keys_ = leaf->keys;
+      values_ = leaf->values;
+      prev_ = leaf->prev;
+      next_ = leaf->next;
+      ind_ = ind;
+      if (ind_ == keys_.size() && next_ != kNoPage) {
+        Load(tree_->Fetch(next_), 0);
+      }
+      tree_->buffers_.Trim();
+    }
+
+    const PagedTree* tree_;
+    std::vector<Key> keys_;
+    std::vector<Value> values_;
+    PageId prev_ = kNoPage;
+    PageId next_ = kNoPage;
+    size_t ind_ = 0;
+  };
+
+  explicit PagedTree(const std::string& path,
+                     size_t cached_pages = kDefaultCachedPages)
+      : file_(path), buffers_(file_, cached_pages) {
+    if (file_.GetRoot() == kNoPage) {
+      Node* root = buffers_.New();
+      file_.SetRoot(root->id);
+      Flush();
+    }
+  }
+
+  PagedTree(const PagedTree&) = delete;
+  PagedTree& operator=(const PagedTree&) = delete;
+
+  ~PagedTree() { Flush(); }
+
+  bool Exists(const Key& key) const {
+    const Node* leaf = SearchLeaf(key, nullptr);
+    size_t index = LowerBound(leaf, key);
+    bool found = index < leaf->keys.size() && leaf->keys[index] == key;
+    buffers_.Trim();
+    return found;
+  }
+
+  Value Search(const Key& key) const {
+    const Node* leaf = SearchLeaf(key, nullptr);
+    size_t index = LowerBound(leaf, key);
+    if (index == leaf->keys.size() || !(leaf->keys[index] == key)) {
+      throw std::invalid_argument("Key not found");
+    }
+    Value value = leaf->values[index];
+    buffers_.Trim();
+    return value;
+  }
+
+  bool Insert(const Key& key, const Value& value) {
+    CheckRecordSize(key, value);
+    Path path;
+    Node* leaf = SearchLeaf(key, &path);
+    size_t index = LowerBound(leaf, key);
+    if (index < leaf->keys.size() && leaf->keys[index] == key) {
+      return false;
+    }
+
+    leaf->keys.insert(leaf->keys.begin() + index, key);
+    leaf->values.insert(leaf->values.begin() + index, value);
+    leaf->bytes += RecordSize(key, value);
+    leaf->dirty = true;
+    SplitIfFull(leaf, path);
+    file_.SetRecordsCount(file_.GetRecordsCount() + 1);
+    buffers_.Trim();
+    return true;
+  }
+
+  bool Update(const Key& key, const Value& value) {
+    CheckRecordSize(key, value);
+    Path path;
+    Node* leaf = SearchLeaf(key, &path);
+    size_t index = LowerBound(leaf, key);
+    if (index == leaf->keys.size() || !(leaf->keys[index] == key)) {
+      return false;
+    }
+
+    leaf->bytes -= PageCodec<Value>::Size(leaf->values[index]);
+    leaf->bytes += PageCodec<Value>::Size(value);
+    leaf->values[index] = value;
+    leaf->dirty = true;
+    SplitIfFull(leaf, path);
+    buffers_.Trim();
+    return true;
+  }
+
+  bool Remove(const Key& key) {
+    Path path;
+    Node* leaf = SearchLeaf(key, &path);
+    size_t index = LowerBound(leaf, key);
+    if (index == leaf->keys.size() || !(leaf->keys[index] == key)) {
+      return false;
+    }
+
+    leaf->bytes -= RecordSize(leaf->keys[index], leaf->values[index]);
+    leaf->keys.erase(leaf->keys.begin() + index);
+    leaf->values.erase(leaf->values.begin() + index);
+    leaf->dirty = true;
+    if (leaf->keys.empty() && !path.empty()) {
+      RemoveEmptyLeaf(leaf, path);
+    }
+    file_.SetRecordsCount(file_.GetRecordsCount() - 1);
+    buffers_.Trim();
+    return true;
+  }
+
+  // Calls visitor(key, value) in key order starting from the first key
+  // that is not less than *from, until the visitor returns false.
+  template <typename Visitor>
+  void ForEach(const Key* from, Visitor visitor) const {
+    const Node* leaf =
+        from == nullptr ? EdgeLeaf(false) : SearchLeaf(*from, nullptr);
+    size_t index = from == nullptr ? 0 : LowerBound(leaf, *from);
+    while (true) {
+      for (; index < leaf->keys.size(); ++index) {
+        if (!visitor(leaf->keys[index], leaf->values[index])) {
+          buffers_.Trim();
+          return;
+        }
+      }
+      PageId next = leaf->next;
+      buffers_.Trim();
+      if (next == kNoPage) {
+        return;
+      }
+      leaf = Fetch(next);
+      index = 0;
+    }
+  }
+
+  // Writes the cached nodes and the superblock and syncs the file.
+  void Flush() {
+    buffers_.Flush();
+    file_.Sync();
+  }
+
+  size_t GetSize() const { return file_.GetRecordsCount(); }
+
+  size_t GetCachedPages() const { return buffers_.GetCachedCount(); }
+
+  size_t GetPagesCount() const { return file_.GetPagesCount(); }
+
+ private:
+  struct Node {
+    static constexpr uint8_t kLeaf = 1;
+    static constexpr uint8_t kInner = 2;
+
+    PageId id = kNoPage;
+    bool dirty = false;
+    bool is_leaf = true;
+    PageId prev = kNoPage;
+    PageId next = kNoPage;
+    std::vector<Key> keys;
+    std::vector<Value> values;
+    std::vector<PageId> children;
+    size_t bytes = kHeaderBytes;
+
+    void Load(const char* page) {
+      uint8_t type;
+      uint16_t count;
+      std::memcpy(&type, page + 4, sizeof(type));
+      std::memcpy(&count, page + 6, sizeof(count));
+      std::memcpy(&prev, page + 8, sizeof(prev));
+      std::memcpy(&next, page + 12, sizeof(next));
+      is_leaf = type == kLeaf;
+      keys.resize(count);
+      const char* in = page + kHeaderBytes;
+      if (is_leaf) {
+        values.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+          in = PageCodec<Key>::Read(in, keys[i]);
+          in = PageCodec<Value>::Read(in, values[i]);
+        }
+      } else {
+        children.resize(count + 1);
+        in = PageCodec<PageId>::Read(in, children[0]);
+        for (size_t i = 0; i < count; ++i) {
+          in = PageCodec<Key>::Read(in, keys[i]);
+          in = PageCodec<PageId>::Read(in, children[i + 1]);
+        }
+      }
+      bytes = static_cast<size_t>(in - page);
+    }
+
+    void Store(char* page) const {
+      uint8_t type = is_leaf ? kLeaf : kInner;
+      uint16_t count = static_cast<uint16_t>(keys.size());
+      std::memset(page, 0, kPageSize);
+      std::memcpy(page + 4, &type, sizeof(type));
+      std::memcpy(page + 6, &count, sizeof(count));
+      std::memcpy(page + 8, &prev, sizeof(prev));
+      std::memcpy(page + 12, &next, sizeof(next));
+      char* out = page + kHeaderBytes;
+      if (is_leaf) {
+        for (size_t i = 0; i < count; ++i) {
+          out = PageCodec<Key>::Write(out, keys[i]);
+          out = PageCodec<Value>::Write(out, values[i]);
+        }
+      } else {
+        out = PageCodec<PageId>::Write(out, children[0]);
+        for (size_t i = 0; i < count; ++i) {
+          out = PageCodec<Key>::Write(out, keys[i]);
+          out = PageCodec<PageId>::Write(out, children[i + 1]);
+        }
+      }
+    }
+  };
+
+  // Inner nodes on the way to a leaf and the child index taken in each.
+  using Path = std::vector<std::pair<Node*, size_t>>;
+
+  static size_t RecordSize(const Key& key, const Value& value) {
+    return PageCodec<Key>::Size(key) + PageCodec<Value>::Size(value);
+  }
+
+  static size_t EntrySize(const Key& key) {
+    return PageCodec<Key>::Size(key) + sizeof(PageId);
+  }
+
+  static void CheckRecordSize(const Key& key, const Value& value) {
+    if (RecordSize(key, value) > kMaxRecordBytes) {
+      throw std::length_error("Record does not fit in a page");
+    }
+  }
+
+  static size_t LowerBound(const Node* node, const Key& key) {
+    return std::lower_bound(node->keys.begin(), node->keys.end(), key) -
+           node->keys.begin();
+  }
+
+  static size_t UpperBound(const Node* node, const Key& key) {
+    return std::upper_bound(node->keys.begin(), node->keys.end(), key) -
+           node->keys.begin();
+  }
+
+  Node* Fetch(PageId id) const { return buffers_.Fetch(id); }
+
+  Node* SearchLeaf(const Key& key, Path* path) const {
+    Node* node = Fetch(file_.GetRoot());
+    while (!node->is_leaf) {
+      size_t index = UpperBound(node, key);
+      if (path != nullptr) {
+        path->emplace_back(node, index);
+      }
+      node = Fetch(node->children[index]);
+    }
+    return node;
+  }
+
+  Node* EdgeLeaf(bool rightmost) const {
+    Node* node = Fetch(file_.GetRoot());
+    while (!node->is_leaf) {
+      node = Fetch(rightmost ? node->children.back() : node->children[0]);
+    }
+    return node;
+  }
+
+  void SplitIfFull(Node* node, Path& path) {
+    while (node->bytes > kPageSize) {
+      Node* right = buffers_.New();
+      Key separator = node->is_leaf ? SplitLeaf(node, right)
+                                    : SplitInner(node, right);
+      if (path.empty()) {
+        Node* root = buffers_.New();
+        root->is_leaf = false;
+        root->keys.push_back(std::move(separator));
+        root->children = {node->id, right->id};
+        root->bytes += sizeof(PageId) + EntrySize(root->keys[0]);
+        file_.SetRoot(root->id);
+        return;
+      }
+
+      auto [parent, index] = path.back();
+      path.pop_back();
+      parent->bytes += EntrySize(separator);
+      parent->keys.insert(parent->keys.begin() + index, std::move(separator));
+      parent->children.insert(parent->children.begin() + index + 1,
+                              right->id);
+      parent->dirty = true;
+      node = parent;
+    }
+  }
+
+  // Leaves split by bytes, the first key of the right half separates them.
+  Key SplitLeaf(Node* leaf, Node* right) {
+    size_t half = (leaf->bytes - kHeaderBytes) / 2;
+    size_t bytes = 0;
+    size_t mid = 0;
+    while (bytes < half) {
+      bytes += RecordSize(leaf->keys[mid], leaf->values[mid]);
+      ++mid;
+    }
+    mid = std::min(mid, leaf->keys.size() - 1);
+
+    right->keys.assign(std::make_move_iterator(leaf->keys.begin() + mid),
+                       std::make_move_iterator(leaf->keys.end()));
+    right->values.assign(std::make_move_iterator(leaf->values.begin() + mid),
+                         std::make_move_iterator(leaf->values.end()));
+    leaf->keys.resize(mid);
+    leaf->values.resize(mid);
+    leaf->bytes = kHeaderBytes;
+    for (size_t i = 0; i < mid; ++i) {
+      leaf->bytes += RecordSize(leaf->keys[i], leaf->values[i]);
+    }
+    for (size_t i = 0; i < right->keys.size(); ++i) {
+      right->bytes += RecordSize(right->keys[i], right->values[i]);
+    }
+
+    right->prev = leaf->id;
+    right->next = leaf->next;
+    if (leaf->next != kNoPage) {
+      Node* next = Fetch(leaf->next);
+      next->prev = right->id;
+      next->dirty = true;
+    }
+    leaf->next = right->id;
+    leaf->dirty = true;
+    return right->keys[0];
+  }
+
+  // The middle key moves up, the keys around it stay with their children.
+  Key SplitInner(Node* node, Node* right) {
+    right->is_leaf = false;
+    size_t half = (node->bytes - kHeaderBytes) / 2;
+    size_t bytes = sizeof(PageId);
+    size_t mid = 0;
+    while (bytes < half) {
+      bytes += EntrySize(node->keys[mid]);
+      ++mid;
+    }
+    mid = std::min(mid, node->keys.size() - 1);
+    Key separator = std::move(node->keys[mid]);
+
+    right->keys.assign(std::make_move_iterator(node->keys.begin() + mid + 1),
+                       std::make_move_iterator(node->keys.end()));
+    right->children.assign(node->children.begin() + mid + 1,
+                           node->children.end());
+    node->keys.resize(mid);
+    node->children.resize(mid + 1);
+    node->bytes = kHeaderBytes + sizeof(PageId);
+    for (const Key& key : node->keys) {
+      node->bytes += EntrySize(key);
+    }
+    right->bytes += sizeof(PageId);
+    for (const Key& key : right->keys) {
+      right->bytes += EntrySize(key);
+    }
+    node->dirty = true;
+    return separator;
+  }
+
+  // Unlinks the leaf and drops every ancestor left without children, then
+  // shortens the tree while the root has a single child.
+  void RemoveEmptyLeaf(Node* leaf, Path& path) {
+    if (leaf->prev != kNoPage) {
+      Node* prev = Fetch(leaf->prev);
+      prev->next = leaf->next;
+      prev->dirty = true;
+    }
+    if (leaf->next != kNoPage) {
+      Node* next = Fetch(leaf->next);
+      next->prev = leaf->prev;
+      next->dirty = true;
+    }
+
+    Node* node = leaf;
+    while (!path.empty()) {
+      auto [parent, index] = path.back();
+      path.pop_back();
+      buffers_.Drop(node);
+      parent->children.erase(parent->children.begin() + index);
+      if (!parent->keys.empty()) {
+        size_t key = index == 0 ? 0 : index - 1;
+        parent->bytes -= EntrySize(parent->keys[key]);
+        parent->keys.erase(parent->keys.begin() + key);
+      } else {
+        parent->bytes -= sizeof(PageId);
+      }
+      parent->dirty = true;
+      if (!parent->children.empty()) {
+        break;
+      }
+      node = parent;
+    }
+
+    Node* root = Fetch(file_.GetRoot());
+    while (!root->is_leaf && root->children.size() == 1) {
+      Node* child = Fetch(root->children[0]);
+      buffers_.Drop(root);
+      file_.SetRoot(child->id);
+      root = child;
+    }
+  }
+
+  PageFile file_;
+  mutable BufferManager<Node> buffers_;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_PAGED_TREE_H_
@@ -2,47 +2,101 @@
 #define TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_TREE_H_
 
 #include <algorithm>
+#include <array>
+#include <iterator>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
+#include "model/bplustree/key_prefix.h"
+#include "model/bplustree/learned_index.h"
+#include "model/common/slaballocator.h"
+
 namespace s21 {
 
-template <typename Key, typename Value>
+// Minimum number of keys in a non-root node, nodes hold up to twice as many.
+// Larger nodes make the tree shallower but the in-node search longer.
+inline constexpr size_t kDefaultDegree = 16;
+
+// kMerge keeps every node at least half full by borrowing and merging after
+// deletes. kFreeAtEmpty removes a leaf only once it is empty, so bursts of
+// deletes cost a shift inside the leaf each, Compact packs nodes again.
+enum class RebalancePolicy {
+  kMerge,
+  kFreeAtEmpty,
+};
+
+// Part shared by all keys of a node, only string keys have one.
+template <bool kEnabled>
+struct NodeCommonPrefix {};
+
+template <>
+struct NodeCommonPrefix<true> {
+  std::string common_prefix;
+};
+
+template <typename Key, typename Value, size_t Degree = kDefaultDegree>
 class Tree {
+  static_assert(Degree > 0, "Tree degree must be positive");
+
  public:
-  struct Node {
+  // A node holds up to 2 * Degree keys and briefly one more before it is
+  // split. Keys, their prefixes and the payload live in inline arrays, so
+  // a node is a single allocation and a descent touches one block per
+  // level.
+  static constexpr size_t kCapacity = 2 * Degree + 1;
+  // Keys kept by the left node when a run of appends splits the rightmost
+  // node, about 90% of it, so ascending keys leave nodes nearly full.
+  static constexpr size_t kAppendSplit =
+      std::max(Degree, kCapacity * 9 / 10 - 1);
+  // String nodes store their common prefix once and only the suffixes in
+  // keys. Short suffixes fit into the string's inline buffer, and prefixes
+  // taken from suffixes tell more keys apart.
+  static constexpr bool kTruncated = std::is_same_v<Key, std::string>;
+
+  struct Leaf;
+  struct Inner;
+
+  struct Node : NodeCommonPrefix<kTruncated> {
     bool is_leaf{true};
-    Node* parent{};
-    std::vector<Key> keys{};
-    std::vector<Node*> children{};
-    std::vector<Value> values{};
+    size_t size{};
+    Inner* parent{};
     Node* left{};
     Node* right{};
+    std::array<uint64_t, kCapacity> prefixes{};
+    std::array<Key, kCapacity> keys{};
+  };
 
-    explicit Node(size_t degree, bool is_leaf = true) : is_leaf(is_leaf) {
-      keys.reserve(degree);
-      if (!is_leaf) {
-        children.reserve(degree + 1);
-      } else {
-        values.reserve(degree);
-      }
-    }
+  struct Leaf : Node {
+    std::array<Value, kCapacity> values{};
+  };
+
+  struct Inner : Node {
+    Inner() { this->is_leaf = false; }
+
+    std::array<Node*, kCapacity + 1> children{};
   };
 
-  static constexpr size_t kDefaultDegree = 100;
+  static constexpr size_t kDegree = Degree;
+  static constexpr float kDefaultFillFactor = 1;
+  static constexpr size_t kBulkMergeRatio = 16;
+  // Leaves of a frozen tree keep a few free slots, so most inserts into it
+  // do not split a leaf.
+  static constexpr float kFrozenFillFactor = 0.875f;
 
   class Iterator {
    public:
-    explicit Iterator(Node* node, size_t ind = 0) : node_(node), ind_(ind){};
+    explicit Iterator(Leaf* node, size_t ind = 0) : node_(node), ind_(ind){};
 
     Iterator& operator++() noexcept {
       if (node_ == nullptr) {
         return *this;
       }
       ind_ += 1;
-      if (ind_ >= node_->keys.size()) {
-        node_ = node_->right;
+      if (ind_ >= node_->size) {
+        node_ = static_cast<Leaf*>(node_->right);
         ind_ = 0;
       }
       return *this;
@@ -56,362 +110,1314 @@ class Tree {
       return node_ == other.node_ && ind_ == other.ind_;
     }
 
-    std::pair<const Key&, Value&> operator*() const {
-      return {node_->keys[ind_], node_->values[ind_]};
+    std::pair<Key, Value&> operator*() const {
+      return {KeyAt(node_, ind_), node_->values[ind_]};
     }
 
    private:
-    Node* node_;
+    Leaf* node_;
     size_t ind_;
   };
 
-  Tree() {}
+  // Walks the leaf chain in both directions, so a seek costs one descent
+  // and every step after it is O(1).
+  class Cursor {
+   public:
+    explicit Cursor(const Tree& tree) : tree_(&tree) {}
+
+    bool IsValid() const { return node_ != nullptr; }
+
+    void Seek(const Key& key) {
+      node_ = tree_->SearchLeaf(key);
+      if (node_ == nullptr) {
+        return;
+      }
+      ind_ = LowerBound(node_, key);
+      if (ind_ == node_->size) {
+        node_ = static_cast<Leaf*>(node_->right);
+        ind_ = 0;
+      }
+      Load();
+    }
+
+    void SeekToFirst() {
+      node_ = tree_->begin_;
+      ind_ = 0;
+      Load();
+    }
+
+    void SeekToLast() {
+      node_ = tree_->last_;
+      ind_ = node_ == nullptr ? 0 : node_->size - 1;
+      Load();
+    }
+
+    void Next() {
+      if (++ind_ >= node_->size) {
+        node_ = static_cast<Leaf*>(node_->right);
+        ind_ = 0;
+      }
+      Load();
+    }
+
+    void Prev() {
+      if (ind_ > 0) {
+        --ind_;
+      } else {
+        node_ = static_cast<Leaf*>(node_->left);
+        ind_ = node_ == nullptr ? 0 : node_->size - 1;
+      }
+      Load();
+    }
+
+    const Key& GetKey() const {
+      if constexpr (kTruncated) {
+        return key_;
+      } else {
+        return node_->keys[ind_];
+      }
+    }
 
-  explicit Tree(size_t degree) noexcept : degree_(degree) {}
+    const Value& GetValue() const { return node_->values[ind_]; }
 
-  Tree(const Tree& other) : degree_(other.degree_) {
-    for (auto it = other.Begin(); it != other.End(); ++it) {
-      Insert((*it).first, (*it).second);
+   private:
+    // Truncated keys are put together once per position.
+    void Load() {
+      if constexpr (kTruncated) {
+        if (node_ != nullptr) {
+          key_ = KeyAt(node_, ind_);
+        }
+      }
     }
+
+    const Tree* tree_;
+    Leaf* node_{};
+    size_t ind_{};
+    Key key_{};
+  };
+
+  Tree() {}
+
+  explicit Tree(RebalancePolicy policy) : policy_(policy) {}
+
+  Tree(RebalancePolicy policy, SlabPages pages)
+      : policy_(policy), pages_(pages), leaves_(pages), inners_(pages) {}
+
+  Tree(const Tree& other)
+      : policy_(other.policy_),
+        pages_(other.pages_),
+        leaves_(other.pages_),
+        inners_(other.pages_),
+        size_(other.size_),
+        frozen_(other.frozen_),
+        fences_(other.fences_),
+        index_(other.index_),
+        edits_(other.edits_) {
+    CopyNodes(other);
   }
 
   Tree(Tree&& other) noexcept
-      : degree_(other.degree_),
+      : policy_(other.policy_),
+        pages_(other.pages_),
+        leaves_(std::move(other.leaves_)),
+        inners_(std::move(other.inners_)),
+        size_(other.size_),
         root_(std::move(other.root_)),
-        begin_(std::move(other.begin_)) {
+        begin_(std::move(other.begin_)),
+        last_(std::move(other.last_)),
+        frozen_(other.frozen_),
+        table_(std::move(other.table_)),
+        fences_(std::move(other.fences_)),
+        index_(std::move(other.index_)),
+        edits_(other.edits_) {
+    other.size_ = 0;
     other.root_ = nullptr;
     other.begin_ = nullptr;
+    other.last_ = nullptr;
   }
 
-  ~Tree() { Clear(root_); }
+  ~Tree() { ReleaseNodes(); }
 
   bool Exists(const Key& key) const {
-    Node* leaf = SearchLeaf(key);
+    Leaf* leaf = SearchLeaf(key);
     if (leaf == nullptr) {
       return false;
     }
-    auto it = std::lower_bound(leaf->keys.begin(), leaf->keys.end(), key);
-    return it != leaf->keys.end() && *it == key;
+    size_t index = LowerBound(leaf, key);
+    return index < leaf->size && KeyEquals(leaf, index, key);
   }
 
+  // A key past the largest one goes straight to the last leaf. After two
+  // such inserts in a row the tree treats the load as sequential and
+  // splits the rightmost nodes unevenly.
   bool Insert(const Key& key, const Value& value) {
-    Node* leaf = SearchLeaf(key);
+    if (frozen_) {
+      return InsertIntoFrozen(key, value);
+    }
+    bool append = IsAppend(key);
+    bool sequential = append && appending_;
+    appending_ = append;
+
+    Leaf* leaf = append ? last_ : SearchLeaf(key);
     if (leaf == nullptr) {
-      root_ = new Node(degree_, true);
-      root_->is_leaf = true;
-      root_->keys.push_back(key);
-      root_->values.push_back(value);
-      begin_ = root_;
+      root_ = begin_ = last_ = leaf = leaves_.New();
+      InsertIntoLeaf(leaf, 0, key, value);
+      size_ = 1;
       return true;
     }
-    auto middle_it =
-        std::lower_bound(leaf->keys.begin(), leaf->keys.end(), key);
-    if (middle_it != leaf->keys.end() && *middle_it == key) {
+    size_t index = append ? leaf->size : LowerBound(leaf, key);
+    if (index < leaf->size && KeyEquals(leaf, index, key)) {
       return false;
-    };
-    size_t insert_index = std::distance(leaf->keys.begin(), middle_it);
-
-    if (middle_it == leaf->keys.end()) {
-      leaf->values.push_back(value);
-      leaf->keys.push_back(key);
-    } else if (*middle_it == key) {
-      leaf->values[insert_index] = value;
-    } else {
-      leaf->values.push_back(value);
-      leaf->keys.push_back(key);
-      std::rotate(leaf->keys.begin() + insert_index, leaf->keys.end() - 1,
-                  leaf->keys.end());
-      std::rotate(leaf->values.begin() + insert_index, leaf->values.end() - 1,
-                  leaf->values.end());
     }
-    if (leaf->keys.size() > 2 * degree_) {
-      Split(leaf);
+
+    InsertIntoLeaf(leaf, index, key, value);
+    if (leaf->size > 2 * Degree) {
+      Split(leaf, sequential);
     }
+    ++size_;
     return true;
   }
 
   bool Remove(const Key& key) {
-    Node* leaf = SearchLeaf(key);
+    if (frozen_) {
+      return RemoveFromFrozen(key);
+    }
+    Leaf* leaf = SearchLeaf(key);
     if (leaf == nullptr) {
       return false;
     }
-    return RemoveKey(leaf, key);
+    size_t index = LowerBound(leaf, key);
+    if (index == leaf->size || !KeyEquals(leaf, index, key)) {
+      return false;
+    }
+
+    EraseFromLeaf(leaf, index);
+    RebalanceAfterErase(leaf);
+    --size_;
+    return true;
+  }
+
+  // Removes the run of keys that starts at the first key not less than
+  // from and lasts while matches(key) holds, returns its length. Leaves
+  // emptied by the run are unlinked together with the subtrees left
+  // without keys, and under kMerge only the two paths along the edges of
+  // the run are rebalanced, once, at the end.
+  template <typename Matches>
+  size_t RemoveWhile(const Key& from, Matches matches) {
+    Leaf* leaf = SearchLeaf(from);
+    if (leaf == nullptr) {
+      return 0;
+    }
+    size_t slot = frozen_ ? FrozenSlot(from) : 0;
+    size_t index = LowerBound(leaf, from);
+    std::vector<Key> edges;
+    if (index > 0) {
+      edges.push_back(KeyAt(leaf, index - 1));
+    } else if (leaf->left != nullptr) {
+      edges.push_back(KeyAt(leaf->left, leaf->left->size - 1));
+    }
+
+    size_t removed = 0;
+    while (leaf != nullptr) {
+      size_t end = index;
+      while (end < leaf->size && matches(KeyAt(leaf, end))) {
+        ++end;
+      }
+      if (end > index) {
+        EraseFromLeaf(leaf, index, end - index);
+        removed += end - index;
+      }
+      if (index < leaf->size) {
+        edges.push_back(KeyAt(leaf, index));
+        break;
+      }
+      Leaf* next = AsLeaf(leaf->right);
+      if (frozen_) {
+        if (leaf->size == 0) {
+          DropFrozenLeaf(slot);
+        } else {
+          ++slot;
+        }
+      } else if (leaf->size == 0) {
+        if (leaf == root_) {
+          UpdateRoot(leaf);
+        } else {
+          RemoveEmptyLeaf(leaf);
+        }
+      }
+      leaf = next;
+      index = 0;
+    }
+
+    size_ -= removed;
+    if (removed > 0 && !frozen_ && policy_ == RebalancePolicy::kMerge) {
+      bool repaired = true;
+      while (repaired) {
+        repaired = false;
+        for (const Key& edge : edges) {
+          repaired = RepairPath(edge) || repaired;
+        }
+      }
+    }
+    return removed;
   }
 
   const Value& Search(const Key& key) const {
-    Node* leaf = SearchLeaf(key);
+    Leaf* leaf = SearchLeaf(key);
     if (leaf == nullptr) {
       throw std::invalid_argument("Key not found");
     }
-    auto it = std::lower_bound(leaf->keys.begin(), leaf->keys.end(), key);
-    if (it == leaf->keys.end() || *it != key) {
+    size_t index = LowerBound(leaf, key);
+    if (index == leaf->size || !KeyEquals(leaf, index, key)) {
       throw std::invalid_argument("Key not found");
     }
-    size_t index = std::distance(leaf->keys.begin(), it);
     return leaf->values[index];
   }
 
   bool Update(const Key& key, const Value& value) {
-    Node* leaf = SearchLeaf(key);
+    Leaf* leaf = SearchLeaf(key);
     if (leaf == nullptr) {
       return false;
     }
-    auto it = std::lower_bound(leaf->keys.begin(), leaf->keys.end(), key);
-    if (it == leaf->keys.end() || *it != key) {
+    size_t index = LowerBound(leaf, key);
+    if (index == leaf->size || !KeyEquals(leaf, index, key)) {
       return false;
     }
-    size_t index = std::distance(leaf->keys.begin(), it);
     leaf->values[index] = value;
     return true;
   }
 
+  // Deletes leave nodes half empty, so the entries are packed into full
+  // nodes again.
+  void Compact() {
+    std::vector<std::pair<Key, Value>> items = ExtractAll();
+    Rebuild(items, 1);
+  }
+
+  // Builds the tree bottom-up from a batch of records, in O(n) once the
+  // batch is sorted. Keys already in the tree and repeated keys of the
+  // batch keep their first value, like with Insert. Returns the number of
+  // inserted keys.
+  size_t BulkLoad(std::vector<std::pair<Key, Value>> items,
+                  float fill_factor = kDefaultFillFactor) {
+    auto key_less = [](const auto& a, const auto& b) {
+      return a.first < b.first;
+    };
+    auto key_equal = [](const auto& a, const auto& b) {
+      return a.first == b.first;
+    };
+    if (!std::is_sorted(items.begin(), items.end(), key_less)) {
+      std::stable_sort(items.begin(), items.end(), key_less);
+    }
+    items.erase(std::unique(items.begin(), items.end(), key_equal),
+                items.end());
+
+    // Rebuilding costs O(tree + batch), a small batch is cheaper to insert.
+    if (items.size() * kBulkMergeRatio < size_) {
+      size_t inserted = 0;
+      for (auto& [key, value] : items) {
+        inserted += Insert(key, value) ? 1 : 0;
+      }
+      return inserted;
+    }
+
+    size_t old_size = size_;
+    std::vector<std::pair<Key, Value>> existing = ExtractAll();
+    if (!existing.empty()) {
+      items = Merge(existing, items);
+    }
+    Rebuild(items, fill_factor);
+
+    return size_ - old_size;
+  }
+
+  Cursor GetCursor() const { return Cursor(*this); }
+
+  std::vector<std::pair<Key, Value>> Scan(const Key& from, const Key& to,
+                                          size_t limit) const {
+    std::vector<std::pair<Key, Value>> result;
+    Cursor cursor(*this);
+
+    cursor.Seek(from);
+    while (cursor.IsValid() && result.size() < limit &&
+           !(to < cursor.GetKey())) {
+      result.emplace_back(cursor.GetKey(), cursor.GetValue());
+      cursor.Next();
+    }
+
+    return result;
+  }
+
+  size_t GetSize() const { return size_; }
+
+  size_t GetLeavesCount() const { return leaves_.GetAllocated(); }
+
+  // For read-mostly data: the inner levels are dropped and a search finds
+  // its leaf through a learned model over the first keys of the leaves,
+  // which costs a few probes into one small array instead of a descent.
+  // Writes go to the leaves in place, a full leaf splits without a parent
+  // and the model is retrained once enough leaves have come or gone. Only
+  // keys with an order-preserving 64-bit image can be frozen.
+  void Freeze() {
+    static_assert(Prefix::kEnabled, "Frozen trees need key images");
+    if (frozen_) {
+      return;
+    }
+    std::vector<std::pair<Key, Value>> items = ExtractAll();
+    frozen_ = true;
+    Rebuild(items, 1);
+  }
+
+  // Builds the inner levels again, the leaves are packed on the way.
+  void Thaw() {
+    if (!frozen_) {
+      return;
+    }
+    std::vector<std::pair<Key, Value>> items = ExtractAll();
+    frozen_ = false;
+    Rebuild(items, 1);
+  }
+
+  bool IsFrozen() const { return frozen_; }
+
+  size_t GetModelSegmentsCount() const { return index_.GetSegmentsCount(); }
+
   Iterator Begin() const { return Iterator(begin_); }
 
   Iterator End() const { return Iterator(nullptr); }
 
  private:
-  size_t degree_ = kDefaultDegree;
+  using Prefix = KeyPrefix<Key>;
+
+  RebalancePolicy policy_ = RebalancePolicy::kMerge;
+  SlabPages pages_ = SlabPages::kRegular;
+  SlabAllocator<Leaf> leaves_;
+  SlabAllocator<Inner> inners_;
+  size_t size_ = 0;
   Node* root_{};
-  Node* begin_{};
+  Leaf* begin_{};
+  Leaf* last_{};
+  bool appending_ = false;
+  // A frozen tree keeps its leaves in key order in table_, next to the
+  // images of keys no greater than their first keys, and index_ predicts
+  // a slot from an image. edits_ counts the slots shifted since then.
+  bool frozen_ = false;
+  std::vector<Leaf*> table_;
+  std::vector<uint64_t> fences_;
+  LearnedIndex index_;
+  size_t edits_ = 0;
+
+  static Leaf* AsLeaf(Node* node) { return static_cast<Leaf*>(node); }
+
+  static Inner* AsInner(Node* node) { return static_cast<Inner*>(node); }
+
+  // A deleted last leaf is either merged into or unlinked from its left
+  // neighbour, which becomes the last one.
+  void DeleteNode(Node* node) {
+    if (node->is_leaf) {
+      if (node == last_) {
+        last_ = AsLeaf(node->left);
+      }
+      leaves_.Delete(AsLeaf(node));
+    } else {
+      inners_.Delete(AsInner(node));
+    }
+  }
 
   void Clear(Node* node) {
     if (node == nullptr) {
       return;
     }
-    for (auto child : node->children) {
-      Clear(child);
+    if (!node->is_leaf) {
+      for (size_t i = 0; i <= node->size; ++i) {
+        Clear(AsInner(node)->children[i]);
+      }
     }
-    delete node;
+    DeleteNode(node);
   }
 
-  void BorrowFromLeftNeighbor(Node* left, Node* right) {
-    right->keys.insert(right->keys.begin(), left->keys.back());
-    left->keys.pop_back();
+  // Drops the whole tree by releasing the slabs, nodes are visited only
+  // when their keys or values have to be destroyed.
+  void ReleaseNodes() {
+    if (!std::is_trivially_destructible_v<Leaf> ||
+        !std::is_trivially_destructible_v<Inner>) {
+      for (Leaf* leaf : table_) {
+        DeleteNode(leaf);
+      }
+      Clear(root_);
+    }
+    leaves_.Release();
+    inners_.Release();
+    root_ = nullptr;
+    begin_ = nullptr;
+    last_ = nullptr;
+    table_.clear();
+    fences_.clear();
+    index_ = LearnedIndex();
+    edits_ = 0;
+  }
 
-    if (right->is_leaf) {
-      right->values.insert(right->values.begin(), left->values.back());
-      left->values.pop_back();
+  bool IsAppend(const Key& key) const {
+    return last_ != nullptr && last_->size > 0 &&
+           LowerBound(last_, key) == last_->size;
+  }
+
+  // The prefix compare narrows the search down to the run of keys sharing
+  // the prefix of probe, full keys are compared only inside that run.
+  template <typename Probe>
+  static size_t LowerBoundIn(const Node* node, const Probe& probe) {
+    if constexpr (Prefix::kEnabled) {
+      uint64_t prefix = Prefix::Get(probe);
+      size_t first = CountLess(node->prefixes.data(), node->size, prefix);
+      if constexpr (Prefix::kExact) {
+        return first;
+      } else {
+        size_t last =
+            CountLessOrEqual(node->prefixes.data(), node->size, prefix);
+        return std::lower_bound(node->keys.begin() + first,
+                                node->keys.begin() + last, probe) -
+               node->keys.begin();
+      }
     } else {
-      Node* borrowed = left->children.back();
-      right->children.insert(right->children.begin(), borrowed);
-      borrowed->parent = right;
-      left->children.pop_back();
+      return std::lower_bound(node->keys.begin(),
+                              node->keys.begin() + node->size, probe) -
+             node->keys.begin();
     }
-    RecursiveUpdateKeys(right->parent);
   }
 
-  void BorrowFromRightNeighbor(Node* left, Node* right) {
-    left->keys.push_back(right->keys.front());
-    right->keys.erase(right->keys.begin());
+  template <typename Probe>
+  static size_t UpperBoundIn(const Node* node, const Probe& probe) {
+    if constexpr (Prefix::kEnabled) {
+      uint64_t prefix = Prefix::Get(probe);
+      size_t last = CountLessOrEqual(node->prefixes.data(), node->size, prefix);
+      if constexpr (Prefix::kExact) {
+        return last;
+      } else {
+        size_t first = CountLess(node->prefixes.data(), node->size, prefix);
+        return std::upper_bound(node->keys.begin() + first,
+                                node->keys.begin() + last, probe) -
+               node->keys.begin();
+      }
+    } else {
+      return std::upper_bound(node->keys.begin(),
+                              node->keys.begin() + node->size, probe) -
+             node->keys.begin();
+    }
+  }
 
-    if (left->is_leaf) {
-      left->values.push_back(right->values.front());
-      right->values.erase(right->values.begin());
+  // A key outside the common prefix of a node sorts before or after all of
+  // its keys, otherwise only its suffix is searched for.
+  static size_t LowerBound(const Node* node, const Key& key) {
+    if constexpr (kTruncated) {
+      int order = CompareCommonPrefix(node, key);
+      if (order != 0) {
+        return order < 0 ? 0 : node->size;
+      }
+      return LowerBoundIn(node, Suffix(node, key));
     } else {
-      Node* borrowed = right->children.front();
-      left->children.push_back(borrowed);
-      borrowed->parent = left;
-      right->children.erase(right->children.begin());
+      return LowerBoundIn(node, key);
     }
-    RecursiveUpdateKeys(right->parent);
   }
 
-  void MergeNodes(Node* left, Node* right) {
-    if (left->is_leaf) {
-      std::move(right->keys.begin(), right->keys.end(),
-                std::back_inserter(left->keys));
-      std::move(right->values.begin(), right->values.end(),
-                std::back_inserter(left->values));
+  static size_t UpperBound(const Node* node, const Key& key) {
+    if constexpr (kTruncated) {
+      int order = CompareCommonPrefix(node, key);
+      if (order != 0) {
+        return order < 0 ? 0 : node->size;
+      }
+      return UpperBoundIn(node, Suffix(node, key));
+    } else {
+      return UpperBoundIn(node, key);
+    }
+  }
+
+  static int CompareCommonPrefix(const Node* node, const Key& key) {
+    const std::string& common = node->common_prefix;
+    return key.compare(0, common.size(), common);
+  }
+
+  static std::string_view Suffix(const Node* node, const Key& key) {
+    return std::string_view(key).substr(node->common_prefix.size());
+  }
+
+  static Key KeyAt(const Node* node, size_t index) {
+    if constexpr (kTruncated) {
+      return node->common_prefix + node->keys[index];
+    } else {
+      return node->keys[index];
+    }
+  }
+
+  static bool KeyEquals(const Node* node, size_t index, const Key& key) {
+    if constexpr (kTruncated) {
+      return CompareCommonPrefix(node, key) == 0 &&
+             node->keys[index] == Suffix(node, key);
+    } else {
+      return node->keys[index] == key;
+    }
+  }
+
+  static size_t CommonLength(std::string_view a, std::string_view b) {
+    size_t length = std::min(a.size(), b.size());
+    return std::mismatch(a.begin(), a.begin() + length, b.begin()).first -
+           a.begin();
+  }
+
+  // Shortest key that is greater than left and not greater than right,
+  // the rest of right does not help to route a search.
+  static Key ShortestSeparator(const Key& left, const Key& right) {
+    if constexpr (kTruncated) {
+      return right.substr(0, CommonLength(left, right) + 1);
     } else {
-      for (auto& item : right->children) {
-        left->keys.push_back(item->keys.front());
+      return right;
+    }
+  }
+
+  static Key Separator(Node* left, Node* right) {
+    return ShortestSeparator(SearchMaxKey(left), SearchMinKey(right));
+  }
+
+  // Moves the end of the common prefix from length on back into the keys.
+  static void ShrinkCommonPrefix(Node* node, size_t length) {
+    std::string& common = node->common_prefix;
+    if (length == common.size()) {
+      return;
+    }
+    std::string_view cut = std::string_view(common).substr(length);
+    for (size_t i = 0; i < node->size; ++i) {
+      node->keys[i].insert(0, cut);
+      node->prefixes[i] = Prefix::Get(node->keys[i]);
+    }
+    common.resize(length);
+  }
+
+  // Nodes only shrink their common prefix on the way, splits and merges
+  // extend it again to what the remaining keys share.
+  static void ExtendCommonPrefix(Node* node) {
+    if constexpr (kTruncated) {
+      if (node->size == 0) {
+        return;
+      }
+      size_t length =
+          CommonLength(node->keys[0], node->keys[node->size - 1]);
+      if (length == 0) {
+        return;
       }
-      std::move(right->children.begin(), right->children.end(),
-                std::back_inserter(left->children));
-      for (auto& item : left->children) {
-        item->parent = left;
+      node->common_prefix.append(node->keys[0], 0, length);
+      for (size_t i = 0; i < node->size; ++i) {
+        node->keys[i].erase(0, length);
+        node->prefixes[i] = Prefix::Get(node->keys[i]);
       }
     }
-    if (right->right != nullptr) {
-      right->right->left = left;
+  }
+
+  template <typename T, size_t N>
+  static void InsertAt(std::array<T, N>& items, size_t size, size_t index,
+                       T item) {
+    std::move_backward(items.begin() + index, items.begin() + size,
+                       items.begin() + size + 1);
+    items[index] = std::move(item);
+  }
+
+  template <typename T, size_t N>
+  static void EraseAt(std::array<T, N>& items, size_t size, size_t index,
+                      size_t count = 1) {
+    std::move(items.begin() + index + count, items.begin() + size,
+              items.begin() + index);
+  }
+
+  // Every key write goes through these, so prefixes stay in sync. Keys take
+  // full values and are stored relative to the common prefix.
+  static void InsertKey(Node* node, size_t index, Key key) {
+    if constexpr (kTruncated) {
+      ShrinkCommonPrefix(node, CommonLength(node->common_prefix, key));
+      key.erase(0, node->common_prefix.size());
     }
-    left->right = right->right;
-    for (size_t i = 0; i < right->parent->children.size(); ++i) {
-      Node* item = right->parent->children[i];
-      if (item == right) {
-        RemoveKey(right->parent, right->parent->keys[i - 1]);
-        break;
-      }
+    if constexpr (Prefix::kEnabled) {
+      InsertAt(node->prefixes, node->size, index, Prefix::Get(key));
+    }
+    InsertAt(node->keys, node->size, index, std::move(key));
+    ++node->size;
+  }
+
+  static void EraseKey(Node* node, size_t index, size_t count = 1) {
+    if constexpr (Prefix::kEnabled) {
+      EraseAt(node->prefixes, node->size, index, count);
     }
-    UpdateKeys(left->parent);
-    delete right;
+    EraseAt(node->keys, node->size, index, count);
+    node->size -= count;
+  }
+
+  static void SetKey(Node* node, size_t index, Key key) {
+    if constexpr (kTruncated) {
+      ShrinkCommonPrefix(node, CommonLength(node->common_prefix, key));
+      key.erase(0, node->common_prefix.size());
+    }
+    if constexpr (Prefix::kEnabled) {
+      node->prefixes[index] = Prefix::Get(key);
+    }
+    node->keys[index] = std::move(key);
+  }
+
+  static void InsertIntoLeaf(Leaf* leaf, size_t index, Key key, Value value) {
+    InsertAt(leaf->values, leaf->size, index, std::move(value));
+    InsertKey(leaf, index, std::move(key));
+  }
+
+  static void EraseFromLeaf(Leaf* leaf, size_t index, size_t count = 1) {
+    EraseAt(leaf->values, leaf->size, index, count);
+    EraseKey(leaf, index, count);
+  }
+
+  // The child goes right after the key, at index + 1.
+  static void InsertIntoInner(Inner* inner, size_t index, Key key,
+                              Node* child) {
+    InsertAt(inner->children, inner->size + 1, index + 1, child);
+    InsertKey(inner, index, std::move(key));
+    child->parent = inner;
   }
 
-  void MoveDataToNewNode(Node* src, Node* dst, size_t border) {
+  static void EraseFromInner(Inner* inner, size_t index) {
+    EraseAt(inner->children, inner->size + 1, index + 1);
+    EraseKey(inner, index);
+  }
+
+  // Moves the entries from index on to the end of dst. Suffixes are moved
+  // as they are, so both nodes first agree on the common prefix.
+  static void MoveTail(Node* src, Node* dst, size_t index) {
+    if constexpr (kTruncated) {
+      if (dst->size == 0) {
+        dst->common_prefix = src->common_prefix;
+      } else {
+        size_t length =
+            CommonLength(src->common_prefix, dst->common_prefix);
+        ShrinkCommonPrefix(src, length);
+        ShrinkCommonPrefix(dst, length);
+      }
+    }
+    size_t count = src->size - index;
+    if constexpr (Prefix::kEnabled) {
+      std::move(src->prefixes.begin() + index,
+                src->prefixes.begin() + src->size,
+                dst->prefixes.begin() + dst->size);
+    }
+    std::move(src->keys.begin() + index, src->keys.begin() + src->size,
+              dst->keys.begin() + dst->size);
     if (src->is_leaf) {
-      std::move(src->keys.begin() + border, src->keys.end(),
-                std::back_inserter(dst->keys));
-      std::move(src->values.begin() + border, src->values.end(),
-                std::back_inserter(dst->values));
-      src->keys.erase(src->keys.begin() + border, src->keys.end());
-      src->values.erase(src->values.begin() + border, src->values.end());
+      std::move(AsLeaf(src)->values.begin() + index,
+                AsLeaf(src)->values.begin() + src->size,
+                AsLeaf(dst)->values.begin() + dst->size);
+    }
+    src->size -= count;
+    dst->size += count;
+  }
+
+  // Children are ordered by key, so any key of a child finds its slot.
+  static size_t ChildIndex(const Inner* parent, const Node* child) {
+    if (child->size > 0) {
+      return UpperBound(parent, KeyAt(child, 0));
+    }
+    size_t index = 0;
+    while (parent->children[index] != child) {
+      ++index;
+    }
+    return index;
+  }
+
+  std::vector<std::pair<Key, Value>> ExtractAll() {
+    std::vector<std::pair<Key, Value>> items;
+    items.reserve(size_);
+    for (Leaf* node = begin_; node != nullptr; node = AsLeaf(node->right)) {
+      for (size_t i = 0; i < node->size; ++i) {
+        items.emplace_back(KeyAt(node, i), std::move(node->values[i]));
+      }
+    }
+    ReleaseNodes();
+    size_ = 0;
+
+    return items;
+  }
+
+  static std::vector<std::pair<Key, Value>> Merge(
+      std::vector<std::pair<Key, Value>>& first,
+      std::vector<std::pair<Key, Value>>& second) {
+    std::vector<std::pair<Key, Value>> result;
+    result.reserve(first.size() + second.size());
+
+    size_t i = 0;
+    size_t j = 0;
+    while (i < first.size() && j < second.size()) {
+      if (second[j].first < first[i].first) {
+        result.push_back(std::move(second[j++]));
+      } else {
+        j += first[i].first < second[j].first ? 0 : 1;
+        result.push_back(std::move(first[i++]));
+      }
+    }
+    std::move(first.begin() + i, first.end(), std::back_inserter(result));
+    std::move(second.begin() + j, second.end(), std::back_inserter(result));
+
+    return result;
+  }
+
+  void Build(std::vector<std::pair<Key, Value>>& items, float fill_factor) {
+    size_ = items.size();
+    if (items.empty()) {
+      return;
+    }
+
+    std::vector<Node*> level = BuildLeaves(items, fill_factor);
+    begin_ = AsLeaf(level.front());
+    last_ = AsLeaf(level.back());
+    while (level.size() > 1) {
+      level = BuildParents(level, fill_factor);
+    }
+    root_ = level.front();
+  }
+
+  // Frozen leaves are filled to kFrozenFillFactor at most.
+  void Rebuild(std::vector<std::pair<Key, Value>>& items, float fill_factor) {
+    if (!frozen_) {
+      Build(items, fill_factor);
+      return;
+    }
+    size_ = items.size();
+    if (items.empty()) {
+      return;
+    }
+    for (Node* leaf :
+         BuildLeaves(items, std::min(fill_factor, kFrozenFillFactor))) {
+      table_.push_back(AsLeaf(leaf));
+      fences_.push_back(Prefix::Get(KeyAt(leaf, 0)));
+    }
+    begin_ = table_.front();
+    last_ = table_.back();
+    index_.Build(fences_);
+  }
+
+  static bool IsBeforeLeaf(const Leaf* leaf, const Key& key) {
+    return LowerBound(leaf, key) == 0 && !KeyEquals(leaf, 0, key);
+  }
+
+  // The prediction is off by at most kEpsilon plus the edits, the fences
+  // next to it settle the slot. Images of string keys may tie, then the
+  // first keys of the leaves decide, found by galloping to the left.
+  size_t FrozenSlot(const Key& key) const {
+    uint64_t image = Prefix::Get(key);
+    size_t slot = std::min(index_.Predict(image), fences_.size() - 1);
+    while (slot > 0 && image < fences_[slot]) {
+      --slot;
+    }
+    while (slot + 1 < fences_.size() && fences_[slot + 1] <= image) {
+      ++slot;
+    }
+    if constexpr (!Prefix::kExact) {
+      size_t step = 1;
+      while (slot > 0 && IsBeforeLeaf(table_[slot], key)) {
+        size_t low = slot > step ? slot - step : 0;
+        if (low == 0 || !IsBeforeLeaf(table_[low], key)) {
+          auto after = std::partition_point(
+              table_.begin() + low + 1, table_.begin() + slot,
+              [&key](const Leaf* leaf) { return !IsBeforeLeaf(leaf, key); });
+          return after - table_.begin() - 1;
+        }
+        slot = low;
+        step *= 2;
+      }
+    }
+    return slot;
+  }
+
+  // Only a key below every fence lowers one, the first.
+  bool InsertIntoFrozen(const Key& key, const Value& value) {
+    if (table_.empty()) {
+      Leaf* leaf = leaves_.New();
+      InsertIntoLeaf(leaf, 0, key, value);
+      begin_ = last_ = leaf;
+      table_.push_back(leaf);
+      fences_.push_back(Prefix::Get(key));
+      index_.Build(fences_);
+      size_ = 1;
+      return true;
+    }
+    size_t slot = FrozenSlot(key);
+    Leaf* leaf = table_[slot];
+    size_t index = LowerBound(leaf, key);
+    if (index < leaf->size && KeyEquals(leaf, index, key)) {
+      return false;
+    }
+
+    InsertIntoLeaf(leaf, index, key, value);
+    fences_[slot] = std::min(fences_[slot], Prefix::Get(key));
+    if (leaf->size > 2 * Degree) {
+      SplitFrozenLeaf(slot);
+    }
+    ++size_;
+    return true;
+  }
+
+  bool RemoveFromFrozen(const Key& key) {
+    if (table_.empty()) {
+      return false;
+    }
+    size_t slot = FrozenSlot(key);
+    Leaf* leaf = table_[slot];
+    size_t index = LowerBound(leaf, key);
+    if (index == leaf->size || !KeyEquals(leaf, index, key)) {
+      return false;
+    }
+
+    EraseFromLeaf(leaf, index);
+    if (leaf->size == 0) {
+      DropFrozenLeaf(slot);
+    }
+    --size_;
+    return true;
+  }
+
+  void SplitFrozenLeaf(size_t slot) {
+    Leaf* leaf = table_[slot];
+    Leaf* new_leaf = leaves_.New();
+    MoveTail(leaf, new_leaf, Degree);
+    ExtendCommonPrefix(leaf);
+    ExtendCommonPrefix(new_leaf);
+    LinkAfter(leaf, new_leaf);
+    if (leaf == last_) {
+      last_ = new_leaf;
+    }
+    table_.insert(table_.begin() + slot + 1, new_leaf);
+    fences_.insert(fences_.begin() + slot + 1,
+                   Prefix::Get(KeyAt(new_leaf, 0)));
+    CountEdit();
+  }
+
+  void DropFrozenLeaf(size_t slot) {
+    Leaf* leaf = table_[slot];
+    if (leaf->left != nullptr) {
+      leaf->left->right = leaf->right;
+    }
+    if (leaf->right != nullptr) {
+      leaf->right->left = leaf->left;
+    }
+    if (begin_ == leaf) {
+      begin_ = AsLeaf(leaf->right);
+    }
+    DeleteNode(leaf);
+    table_.erase(table_.begin() + slot);
+    fences_.erase(fences_.begin() + slot);
+    CountEdit();
+  }
+
+  // Every split or dropped leaf shifts the slots after it by one, past
+  // kEpsilon of them the model is trained again.
+  void CountEdit() {
+    if (++edits_ > LearnedIndex::kEpsilon) {
+      index_.Build(fences_);
+      edits_ = 0;
+    }
+  }
+
+  static size_t GetCapacity(float fill_factor, size_t min_size,
+                            size_t max_size) {
+    auto capacity = static_cast<size_t>(fill_factor * max_size + 0.5f);
+    return std::clamp(capacity, min_size, max_size);
+  }
+
+  // Fewest groups of at most capacity entries, but never so many that a
+  // group gets fewer than min_size of them. Groups are evened out.
+  static size_t GetGroupsCount(size_t count, size_t capacity,
+                               size_t min_size) {
+    size_t groups = (count + capacity - 1) / capacity;
+    return std::max<size_t>(1, std::min(groups, count / min_size));
+  }
+
+  static size_t GetGroupSize(size_t index, size_t count, size_t groups) {
+    return count / groups + (index < count % groups ? 1 : 0);
+  }
+
+  static void LinkAfter(Node* node, Node* new_node) {
+    new_node->left = node;
+    new_node->right = node->right;
+    if (node->right) {
+      node->right->left = new_node;
+    }
+    node->right = new_node;
+  }
+
+  static void LinkLevel(const std::vector<Node*>& level) {
+    for (size_t i = 1; i < level.size(); ++i) {
+      level[i - 1]->right = level[i];
+      level[i]->left = level[i - 1];
+    }
+  }
+
+  // Copies the nodes of other level by level, so the copy keeps their fill
+  // and separators and takes linear time. A frozen tree has its leaves
+  // only, in table_.
+  void CopyNodes(const Tree& other) {
+    std::vector<const Node*> level(other.table_.begin(), other.table_.end());
+    if (other.root_ != nullptr) {
+      level.push_back(other.root_);
+    }
+    std::vector<Node*> copies;
+    for (const Node* node : level) {
+      copies.push_back(CopyNode(node));
+    }
+    root_ = frozen_ || copies.empty() ? nullptr : copies.front();
+
+    while (!level.empty() && !level.front()->is_leaf) {
+      std::vector<const Node*> children;
+      std::vector<Node*> child_copies;
+      for (size_t i = 0; i < level.size(); ++i) {
+        const Inner* inner = static_cast<const Inner*>(level[i]);
+        Inner* copy = AsInner(copies[i]);
+        for (size_t j = 0; j <= inner->size; ++j) {
+          copy->children[j] = CopyNode(inner->children[j]);
+          copy->children[j]->parent = copy;
+          children.push_back(inner->children[j]);
+          child_copies.push_back(copy->children[j]);
+        }
+      }
+      LinkLevel(copies);
+      level = std::move(children);
+      copies = std::move(child_copies);
+    }
+    LinkLevel(copies);
+
+    if (!copies.empty()) {
+      begin_ = AsLeaf(copies.front());
+      last_ = AsLeaf(copies.back());
+    }
+    if (frozen_) {
+      for (Node* leaf : copies) {
+        table_.push_back(AsLeaf(leaf));
+      }
+    }
+  }
+
+  Node* CopyNode(const Node* node) {
+    Node* copy = node->is_leaf
+                     ? static_cast<Node*>(
+                           leaves_.New(*static_cast<const Leaf*>(node)))
+                     : inners_.New(*static_cast<const Inner*>(node));
+    copy->parent = nullptr;
+    copy->left = nullptr;
+    copy->right = nullptr;
+    return copy;
+  }
+
+  std::vector<Node*> BuildLeaves(
+      std::vector<std::pair<Key, Value>>& items, float fill_factor) {
+    size_t capacity = GetCapacity(fill_factor, Degree, 2 * Degree);
+    size_t groups = GetGroupsCount(items.size(), capacity, Degree);
+    std::vector<Node*> leaves;
+    leaves.reserve(groups);
+
+    for (size_t i = 0, pos = 0; i < groups; ++i) {
+      Leaf* leaf = leaves_.New();
+      size_t size = GetGroupSize(i, items.size(), groups);
+      if constexpr (kTruncated) {
+        const Key& first = items[pos].first;
+        const Key& last = items[pos + size - 1].first;
+        leaf->common_prefix = first.substr(0, CommonLength(first, last));
+      }
+      for (size_t end = pos + size; pos < end; ++pos) {
+        InsertIntoLeaf(leaf, leaf->size, std::move(items[pos].first),
+                       std::move(items[pos].second));
+      }
+      leaves.push_back(leaf);
+    }
+    LinkLevel(leaves);
+
+    return leaves;
+  }
+
+  std::vector<Node*> BuildParents(const std::vector<Node*>& children,
+                                  float fill_factor) {
+    size_t capacity = GetCapacity(fill_factor, Degree + 1, 2 * Degree + 1);
+    size_t groups = GetGroupsCount(children.size(), capacity, Degree + 1);
+    std::vector<Node*> parents;
+    parents.reserve(groups);
+
+    for (size_t i = 0, pos = 0; i < groups; ++i) {
+      Inner* parent = inners_.New();
+      parent->children[0] = children[pos];
+      children[pos++]->parent = parent;
+      size_t size = GetGroupSize(i, children.size(), groups);
+      for (size_t end = pos + size - 1; pos < end; ++pos) {
+        InsertIntoInner(parent, parent->size,
+                        Separator(children[pos - 1], children[pos]),
+                        children[pos]);
+      }
+      ExtendCommonPrefix(parent);
+      parents.push_back(parent);
+    }
+    LinkLevel(parents);
+
+    return parents;
+  }
+
+  // Separators only have to lie between the keys of their neighbouring
+  // subtrees, so moving a key between two nodes changes just the separator
+  // of their lowest common ancestor.
+  std::pair<Inner*, size_t> FindSeparator(Node* right) {
+    Node* node = right;
+    while (true) {
+      Inner* parent = node->parent;
+      size_t index = ChildIndex(parent, node);
+      if (index > 0) {
+        return {parent, index - 1};
+      }
+      node = parent;
+    }
+  }
+
+  void BorrowFromLeftNeighbor(Node* left, Node* right) {
+    auto [owner, index] = FindSeparator(right);
+    if (right->is_leaf) {
+      size_t last = left->size - 1;
+      InsertIntoLeaf(AsLeaf(right), 0, KeyAt(left, last),
+                     std::move(AsLeaf(left)->values[last]));
+      EraseFromLeaf(AsLeaf(left), last);
+      SetKey(owner, index,
+             ShortestSeparator(KeyAt(left, last - 1), KeyAt(right, 0)));
     } else {
-      std::move(src->keys.begin() + border + 1, src->keys.end(),
-                std::back_inserter(dst->keys));
-      src->keys.erase(src->keys.begin() + border, src->keys.end());
-      std::move(src->children.begin() + border + 1, src->children.end(),
-                std::back_inserter(dst->children));
-      for (auto& item : dst->children) {
-        item->parent = dst;
+      Inner* inner = AsInner(right);
+      Node* borrowed = AsInner(left)->children[left->size];
+      InsertAt(inner->children, inner->size + 1, 0, borrowed);
+      InsertKey(inner, 0, KeyAt(owner, index));
+      borrowed->parent = inner;
+      SetKey(owner, index, KeyAt(left, left->size - 1));
+      EraseKey(left, left->size - 1);
+    }
+  }
+
+  void BorrowFromRightNeighbor(Node* left, Node* right) {
+    auto [owner, index] = FindSeparator(right);
+    if (left->is_leaf) {
+      InsertIntoLeaf(AsLeaf(left), left->size, KeyAt(right, 0),
+                     std::move(AsLeaf(right)->values[0]));
+      EraseFromLeaf(AsLeaf(right), 0);
+      SetKey(owner, index, ShortestSeparator(KeyAt(left, left->size - 1),
+                                             KeyAt(right, 0)));
+    } else {
+      Inner* inner = AsInner(right);
+      Node* borrowed = inner->children[0];
+      InsertIntoInner(AsInner(left), left->size, KeyAt(owner, index),
+                      borrowed);
+      SetKey(owner, index, KeyAt(right, 0));
+      EraseAt(inner->children, inner->size + 1, 0);
+      EraseKey(inner, 0);
+    }
+  }
+
+  // The nodes share the parent, whose separator moves down between the
+  // children of merged inner nodes.
+  void MergeNodes(Node* left, Node* right) {
+    Inner* parent = right->parent;
+    size_t index = ChildIndex(parent, right) - 1;
+    if (!left->is_leaf) {
+      Inner* inner_left = AsInner(left);
+      Inner* inner_right = AsInner(right);
+      InsertIntoInner(inner_left, left->size, KeyAt(parent, index),
+                      inner_right->children[0]);
+      for (size_t i = 1; i <= right->size; ++i) {
+        inner_left->children[left->size + i] = inner_right->children[i];
+        inner_right->children[i]->parent = inner_left;
       }
-      src->children.erase(src->children.begin() + border + 1,
-                          src->children.end());
     }
+    MoveTail(right, left, 0);
+    ExtendCommonPrefix(left);
+    if (right->right != nullptr) {
+      right->right->left = left;
+    }
+    left->right = right->right;
+
+    EraseFromInner(parent, index);
+    DeleteNode(right);
+    RebalanceAfterErase(parent);
   }
 
-  void Rebalance(Node* node) {
+  // Returns false when the node has no neighbour to borrow from or merge
+  // with.
+  bool Rebalance(Node* node) {
     Node* left_neighbor = node->left;
     Node* right_neighbor = node->right;
 
-    if (left_neighbor != nullptr && left_neighbor->keys.size() > degree_) {
+    if (left_neighbor != nullptr && left_neighbor->size > Degree) {
       BorrowFromLeftNeighbor(left_neighbor, node);
-    } else if (right_neighbor != nullptr &&
-               right_neighbor->keys.size() > degree_) {
+    } else if (right_neighbor != nullptr && right_neighbor->size > Degree) {
       BorrowFromRightNeighbor(node, right_neighbor);
     } else if (left_neighbor && left_neighbor->parent == node->parent) {
       MergeNodes(left_neighbor, node);
     } else if (right_neighbor && right_neighbor->parent == node->parent) {
       MergeNodes(node, right_neighbor);
+    } else {
+      return false;
     }
+    return true;
   }
 
-  void RecursiveUpdateKeys(Node* node) {
-    while (node) {
-      UpdateKeys(node);
-      node = node->parent;
+  // Brings the nodes on the path to key and their neighbours back to half
+  // full, returns whether anything moved. The nodes a run of removed keys
+  // leaves underfull sit next to each other along its edge, and every
+  // borrow or merge reshapes the path, so the walk starts over from the
+  // root.
+  bool RepairPath(const Key& key) {
+    bool repaired = false;
+    Node* node = root_;
+    while (node != nullptr && !node->is_leaf) {
+      Node* child = AsInner(node)->children[UpperBound(node, key)];
+      node = child;
+      for (Node* near : {child->left, child, child->right}) {
+        if (near != nullptr && near->size < Degree && Rebalance(near)) {
+          repaired = true;
+          node = root_;
+          break;
+        }
+      }
     }
+    return repaired;
   }
 
-  bool RemoveKey(Node* node, const Key& key) {
-    bool is_removed = RemoveKeyFromNode(node, key);
-
+  void RebalanceAfterErase(Node* node) {
     if (node == root_) {
       UpdateRoot(node);
-      return is_removed;
-    }
-    if (node->keys.size() < degree_) {
+    } else if (policy_ == RebalancePolicy::kFreeAtEmpty) {
+      if (node->size == 0) {
+        RemoveEmptyLeaf(AsLeaf(node));
+      }
+    } else if (node->size < Degree) {
       Rebalance(node);
-    } else {
-      RecursiveUpdateKeys(node->parent);
     }
-    return is_removed;
   }
 
-  bool RemoveKeyFromNode(Node* node, const Key& key) {
-    auto it = std::lower_bound(node->keys.begin(), node->keys.end(), key);
-    size_t index = std::distance(node->keys.begin(), it);
-    if (it == node->keys.end() || node->keys.size() == 0) {
-      return false;
+  // The leaf goes away together with the ancestors it was the only
+  // descendant of, nothing else is touched.
+  void RemoveEmptyLeaf(Leaf* leaf) {
+    Node* top = leaf;
+    while (top->parent->size == 0) {
+      top = top->parent;
     }
-    node->keys.erase(it);
-    if (node->is_leaf) {
-      node->values.erase(node->values.begin() + index);
+    for (Node* node = leaf;; node = node->parent) {
+      if (node->left != nullptr) {
+        node->left->right = node->right;
+      }
+      if (node->right != nullptr) {
+        node->right->left = node->left;
+      }
+      if (node == top) {
+        break;
+      }
+    }
+    if (begin_ == leaf) {
+      begin_ = AsLeaf(leaf->right);
+    }
+
+    Inner* parent = top->parent;
+    size_t index = ChildIndex(parent, top);
+    if (index == 0) {
+      EraseAt(parent->children, parent->size + 1, 0);
+      EraseKey(parent, 0);
     } else {
-      node->children.erase(node->children.begin() + index + 1);
+      EraseFromInner(parent, index - 1);
+    }
+    Clear(top);
+    while (!root_->is_leaf && root_->size == 0) {
+      UpdateRoot(root_);
     }
-    return true;
   }
 
-  Node* SearchLeaf(const Key& key) const {
+  Leaf* SearchLeaf(const Key& key) const {
+    if (frozen_) {
+      return table_.empty() ? nullptr : table_[FrozenSlot(key)];
+    }
     if (root_ == nullptr) {
       return nullptr;
     }
     Node* node = root_;
     while (!node->is_leaf) {
-      auto it = std::upper_bound(node->keys.begin(), node->keys.end(), key);
-      if (it == node->keys.end()) {
-        node = node->children.back();
-      } else if (it == node->keys.begin() && key < node->keys.front()) {
-        node = node->children.front();
-      } else {
-        size_t index = std::distance(node->keys.begin(), it);
-        node = node->children[index];
-      }
+      node = AsInner(node)->children[UpperBound(node, key)];
     }
-    return node;
+    return AsLeaf(node);
   }
 
-  const Key& SearchMinKey(Node* node) const {
+  static Key SearchMinKey(Node* node) {
     while (!node->is_leaf) {
-      node = node->children[0];
+      node = AsInner(node)->children[0];
     }
-    return node->keys[0];
+    return KeyAt(node, 0);
   }
 
-  void Split(Node* node) {
-    Node* new_node = new Node(degree_, node->is_leaf);
-    new_node->left = node;
-    new_node->right = node->right;
-    if (node->right) {
-      node->right->left = new_node;
+  static Key SearchMaxKey(Node* node) {
+    while (!node->is_leaf) {
+      node = AsInner(node)->children[node->size];
     }
-    node->right = new_node;
-    Key mid_key = node->keys[degree_];
-    new_node->is_leaf = node->is_leaf;
-    new_node->parent = node->parent;
-    MoveDataToNewNode(node, new_node, degree_);
+    return KeyAt(node, node->size - 1);
+  }
+
+  // The left node keeps Degree keys, or kAppendSplit when sequential
+  // inserts split the rightmost node of a level.
+  void Split(Node* node, bool sequential = false) {
+    size_t keep = sequential && node->right == nullptr ? kAppendSplit : Degree;
+    Node* new_node = nullptr;
+    Key mid_key;
+    if (node->is_leaf) {
+      new_node = leaves_.New();
+      MoveTail(node, new_node, keep);
+      mid_key = ShortestSeparator(KeyAt(node, keep - 1), KeyAt(new_node, 0));
+      if (node == last_) {
+        last_ = AsLeaf(new_node);
+      }
+    } else {
+      Inner* inner = AsInner(node);
+      Inner* new_inner = inners_.New();
+      std::move(inner->children.begin() + keep + 1,
+                inner->children.begin() + node->size + 1,
+                new_inner->children.begin());
+      for (size_t i = 0; i < node->size - keep; ++i) {
+        new_inner->children[i]->parent = new_inner;
+      }
+      MoveTail(node, new_inner, keep + 1);
+      mid_key = KeyAt(node, keep);
+      EraseKey(node, keep);
+      new_node = new_inner;
+    }
+    ExtendCommonPrefix(node);
+    ExtendCommonPrefix(new_node);
+    LinkAfter(node, new_node);
+
     if (node == root_) {
-      Node* new_root = new Node(degree_, false);
-      new_root->is_leaf = false;
-      new_root->keys.push_back(mid_key);
-      new_root->children.push_back(node);
-      new_root->children.push_back(new_node);
-      root_ = new_root;
+      Inner* new_root = inners_.New();
+      new_root->children[0] = node;
       node->parent = new_root;
-      new_node->parent = new_root;
+      InsertIntoInner(new_root, 0, std::move(mid_key), new_node);
+      root_ = new_root;
       return;
     }
 
-    Node* parent = node->parent;
-    auto mid_it = std::lower_bound(parent->keys.begin(), parent->keys.end(),
-                                   new_node->keys.front());
-    size_t mid_index = std::distance(parent->keys.begin(), mid_it);
-
-    parent->keys.push_back(mid_key);
-    parent->children.push_back(new_node);
-    std::rotate(parent->keys.begin() + mid_index, parent->keys.end() - 1,
-                parent->keys.end());
-    std::rotate(parent->children.begin() + mid_index + 1,
-                parent->children.end() - 1, parent->children.end());
-
-    if (parent->keys.size() > 2 * degree_) {
-      Split(parent);
+    Inner* parent = node->parent;
+    InsertIntoInner(parent, ChildIndex(parent, node), std::move(mid_key),
+                    new_node);
+    if (parent->size > 2 * Degree) {
+      Split(parent, sequential);
     }
   }
 
   void UpdateRoot(Node* node) {
-    if (node->keys.size() > 0) {
+    if (node->size > 0) {
       return;
     }
     if (!node->is_leaf) {
-      root_ = node->children[0];
+      root_ = AsInner(node)->children[0];
       root_->parent = nullptr;
     } else {
       root_ = nullptr;
+      begin_ = nullptr;
     }
-    delete node;
-  }
-
-  void UpdateKeys(Node* node) {
-    if (node == nullptr) {
-      return;
-    }
-    for (size_t i = 0; i < node->keys.size(); ++i) {
-      Key key = SearchMinKey(node->children[i + 1]);
-      node->keys[i] = key;
-    }
+    DeleteNode(node);
   }
 };
 }  // namespace s21
 
-#endif  // TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_TREE_H_
\ No newline at end of file
+#endif  // TRANSACTIONS_SOURCE_MODEL_BPLUSTREE_TREE_H_
@@ -0,0 +1,169 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_BST_NODE_SLAB_H_
+#define TRANSACTIONS_SOURCE_MODEL_BST_NODE_SLAB_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+
+// Keeps the nodes of one tree in chunks and names them by 32-bit indices,
+// half the size of a pointer. Chunks never move, so a reference to a node
+// stays valid while others are added. Released slots are chained into a
+// free list and reused first, and trailing chunks left without objects are
+// given back.
+template <typename T>
+class NodeSlab {
+ public:
+  using Index = uint32_t;
+  static constexpr size_t kChunkBytes = size_t{64} << 10;
+  // Indices keep their top bit free for the user.
+  static constexpr size_t kMaxSize = size_t{1} << 31;
+
+  NodeSlab() = default;
+
+  NodeSlab(const NodeSlab&) = delete;
+  NodeSlab& operator=(const NodeSlab&) = delete;
+
+  ~NodeSlab() { Clear(); }
+
+  template <typename... Args>
+  Index New(Args&&... args) {
+    Index index = Allocate();
+    new (GetSlot(index).storage) T(std::forward<Args>(args)...);
+    ++live_[index >> kChunkShift];
+    ++size_;
+    return index;
+  }
+
+  void Delete(Index index) {
+    (*this)[index].~T();
+    GetSlot(index).next = free_;
+    free_ = index;
+    --size_;
+    if (--live_[index >> kChunkShift] == 0 &&
+        (index >> kChunkShift) + 1 == chunks_.size()) {
+      ReleaseTrailingChunks();
+    }
+  }
+
+  T& operator[](Index index) {
+    return *reinterpret_cast<T*>(GetSlot(index).storage);
+  }
+
+  const T& operator[](Index index) const {
+    return *reinterpret_cast<const T*>(GetSlot(index).storage);
+  }
+
+  // Objects without a destructor go away with their chunks, the others
+  // are found in one pass over the used slots.
+  void Clear() {
+    if (!std::is_trivially_destructible<T>::value) {
+      std::vector<bool> released(next_);
+      for (Index index = free_; index != kNoSlot;
+           index = GetSlot(index).next) {
+        released[index] = true;
+      }
+      for (Index index = 0; index < next_; ++index) {
+        if (!released[index]) (*this)[index].~T();
+      }
+    }
+    chunks_.clear();
+    live_.clear();
+    next_ = 0;
+    free_ = kNoSlot;
+    size_ = 0;
+  }
+
+  size_t GetSize() const { return size_; }
+
+  size_t GetChunksCount() const { return chunks_.size(); }
+
+  friend void swap(NodeSlab& first, NodeSlab& second) noexcept {
+    using std::swap;
+
+    swap(first.chunks_, second.chunks_);
+    swap(first.live_, second.live_);
+    swap(first.next_, second.next_);
+    swap(first.free_, second.free_);
+    swap(first.size_, second.size_);
+  }
+
+ private:
+  union Slot {
+    Index next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  static constexpr Index kNoSlot = ~Index{0};
+
+  static constexpr size_t GetChunkShift() {
+    size_t shift = 3;
+    while ((size_t{2} << shift) * sizeof(Slot) <= kChunkBytes) ++shift;
+    return shift;
+  }
+
+  static constexpr size_t kChunkShift = GetChunkShift();
+  static constexpr Index kChunkMask = (Index{1} << kChunkShift) - 1;
+
+  Slot& GetSlot(Index index) {
+    return chunks_[index >> kChunkShift][index & kChunkMask];
+  }
+
+  const Slot& GetSlot(Index index) const {
+    return chunks_[index >> kChunkShift][index & kChunkMask];
+  }
+
+  Index Allocate() {
+    if (free_ != kNoSlot) {
+      Index index = free_;
+      free_ = GetSlot(index).next;
+      return index;
+    }
+    if (next_ == kMaxSize) {
+      throw std::length_error("Too many nodes");
+    }
+    if ((next_ & kChunkMask) == 0) {
+      chunks_.emplace_back(new Slot[size_t{1} << kChunkShift]);
+      live_.push_back(0);
+    }
+    return next_++;
+  }
+
+  // The slots of the released chunks are unlinked from the free list in
+  // one walk over it.
+  void ReleaseTrailingChunks() {
+    size_t kept = chunks_.size();
+    while (kept > 0 && live_[kept - 1] == 0) {
+      --kept;
+    }
+    next_ = static_cast<Index>(kept << kChunkShift);
+
+    Index* link = &free_;
+    while (*link != kNoSlot) {
+      if (*link >= next_) {
+        *link = GetSlot(*link).next;
+      } else {
+        link = &GetSlot(*link).next;
+      }
+    }
+    chunks_.resize(kept);
+    live_.resize(kept);
+  }
+
+  std::vector<std::unique_ptr<Slot[]>> chunks_;
+  // Objects alive in each chunk.
+  std::vector<Index> live_;
+  Index next_ = 0;
+  Index free_ = kNoSlot;
+  size_t size_ = 0;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_BST_NODE_SLAB_H_
@@ -1,7 +1,12 @@
 #ifndef TRANSACTIONS_SOURCE_MODEL_BST_SELF_BALANCING_BINARY_SEARCH_TREE_H_
 #define TRANSACTIONS_SOURCE_MODEL_BST_SELF_BALANCING_BINARY_SEARCH_TREE_H_
 
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
 #include "../common/basestorage.h"
+#include "node_slab.h"
 
 namespace s21 {
 
@@ -10,25 +15,35 @@ enum Color {
   Red,
 };
 
+// Nodes live in the tree's slab and link to each other by index, index 0
+// is the nil leaf. The colour is the top bit of the parent link, so the
+// links, the colour and the subtree size take 16 bytes.
 template <typename Key, typename Value>
 class BSTNode {
  public:
-  BSTNode* parent = nullptr;
-  BSTNode* link[2] = {nullptr, nullptr};
+  using Index = uint32_t;
+  static constexpr Index kRedBit = Index{1} << 31;
+
+  Index parent = 0;
+  Index link[2] = {0, 0};
+  // Nodes in the subtree rooted here, the nil leaf counts none.
+  Index count = 0;
   std::pair<Key, Value> data;
-  bool color = Color::Black;
 
   BSTNode() = default;
   BSTNode(const Key& key, const Value& value)
-      : data(std::make_pair(key, value)), color(Color::Red){};
+      : parent(kRedBit), count(1), data(std::make_pair(key, value)){};
+
+  Index GetParent() const { return parent & ~kRedBit; }
+
+  void SetParent(Index index) { parent = (parent & kRedBit) | index; }
 
-  explicit BSTNode(const BSTNode& other)
-      : data(other.data), color(other.color){};
+  bool GetColor() const {
+    return (parent & kRedBit) ? Color::Red : Color::Black;
+  }
 
-  BSTNode& operator=(const BSTNode& other) {
-    data = other.data;
-    color = other.color;
-    return *this;
+  void SetColor(bool color) {
+    parent = color == Color::Red ? parent | kRedBit : parent & ~kRedBit;
   }
 };
 
@@ -36,12 +51,9 @@ template <typename Key, typename Value,
           typename ValueEqual = std::equal_to<Value>>
 class SelfBalancingBinarySearchTree : public BaseStorage<Key, Value> {
  public:
-  class BSTIterator;
   using Node = BSTNode<Key, Value>;
-  using Pointer = Node*;
-  using Iterator = BSTIterator;
+  using Index = typename Node::Index;
   using ValueType = std::pair<Key, Value>;
-  Pointer leaf_;
 
   SelfBalancingBinarySearchTree();
 
@@ -49,53 +61,52 @@ class SelfBalancingBinarySearchTree : public BaseStorage<Key, Value> {
       const SelfBalancingBinarySearchTree& other);
   SelfBalancingBinarySearchTree& operator=(
       const SelfBalancingBinarySearchTree& other);
-  ~SelfBalancingBinarySearchTree();
+  ~SelfBalancingBinarySearchTree() = default;
 
-  class BSTIterator {
-    friend class SelfBalancingBinarySearchTree;
+  std::unique_ptr<BaseStorage<Key, Value>> Clone() const override {
+    return std::make_unique<SelfBalancingBinarySearchTree>(*this);
+  }
 
+  class BSTCursor : public BaseCursor<Key, Value> {
    public:
-    BSTIterator(Pointer node, Pointer leaf) : current_(node), leaf_(leaf) {}
-    BSTIterator() : current_(nullptr), leaf_(nullptr) {}
-    BSTIterator(const BSTIterator& obj) {
-      current_ = obj.current_;
-      leaf_ = obj.leaf_;
-    }
-
-    BSTIterator& operator=(const BSTIterator& obj) noexcept {
-      current_ = obj.current_;
-      leaf_ = obj.leaf_;
-      return *this;
-    }
-
-    BSTIterator& operator++() noexcept {
-      if (current_->link[1] != leaf_) {
-        current_ = current_->link[1];
-        while (current_->link[0] != leaf_) {
-          current_ = current_->link[0];
+    explicit BSTCursor(const SelfBalancingBinarySearchTree& tree)
+        : tree_(&tree) {}
+
+    bool IsValid() const override { return node_ != kNil; }
+
+    void Seek(const Key& key) override {
+      node_ = kNil;
+      Index current = tree_->root_;
+      while (current != kNil) {
+        const Node& node = tree_->nodes_[current];
+        if (node.data.first < key) {
+          current = node.link[1];
+        } else {
+          node_ = current;
+          current = node.link[0];
         }
-      } else {
-        Pointer tmp = current_->parent;
-        while (tmp && tmp->data.first < current_->data.first) {
-          current_ = tmp;
-          tmp = tmp->parent;
-        }
-        current_ = tmp;
       }
-      return *this;
     }
 
-    bool operator!=(const BSTIterator& other) const noexcept {
-      return (current_ != other.current_);
-    }
+    void SeekToFirst() override { node_ = tree_->Extreme(tree_->root_, 0); }
 
-    bool IsValid() const { return current_ != nullptr; }
+    void SeekToLast() override { node_ = tree_->Extreme(tree_->root_, 1); }
 
-    ValueType* operator->() const noexcept { return &(current_->data); }
+    void Next() override { node_ = tree_->Step(node_, 1); }
+
+    void Prev() override { node_ = tree_->Step(node_, 0); }
+
+    const Key& GetKey() const override {
+      return tree_->nodes_[node_].data.first;
+    }
+
+    const Value& GetValue() const override {
+      return tree_->nodes_[node_].data.second;
+    }
 
    private:
-    Pointer current_;
-    Pointer leaf_;
+    const SelfBalancingBinarySearchTree* tree_;
+    Index node_ = kNil;
   };
 
   bool Set(const Key& key, const Value& value) override;
@@ -107,131 +118,156 @@ class SelfBalancingBinarySearchTree : public BaseStorage<Key, Value> {
   bool Rename(const Key& key, const Key& new_key) override;
   std::vector<Key> Find(const Value& value) const override;
   std::vector<Value> Showall() const override;
+  std::unique_ptr<BaseCursor<Key, Value>> GetCursor() const override;
+  size_t DelRange(const Key& from, const Key& to) override;
+  size_t DelPrefix(const Key& prefix) override;
+  size_t Rank(const Key& key) const override;
+  Key Select(size_t index) const override;
+  size_t CountRange(const Key& from, const Key& to) const override;
+  void Compact() override;
+  size_t GetSize() const { return size_; }
+  size_t GetChunksCount() const { return nodes_.GetChunksCount(); }
 
  private:
-  Pointer root_;
-  void Swap(Pointer a, Pointer b);
-  void LeftRotation(Pointer node);
-  void RightRotation(Pointer node);
-  void BalanceTree(Pointer node);
-  Iterator Begin() const;
-  Iterator End() const;
+  static constexpr Index kNil = 0;
+
+  NodeSlab<Node> nodes_;
+  Index root_ = kNil;
+  size_t size_ = 0;
+  void LeftRotation(Index node);
+  void RightRotation(Index node);
+  void BalanceTree(Index node);
   void Clear();
-  int CountChildren(Pointer node) const;
-  Pointer GetChild(Pointer node) const;
-  Pointer GetParent(Pointer node) const;
-  Pointer Search(const Key& key) const;
-  bool RemoveNode(Pointer node);
-  void RemoveNodeWithoutChildren(Pointer node);
-  void RemoveNodeWithOneChild(Pointer node);
-  void RemoveNodeWithTwoChild(Pointer node);
-  void RebalanceTree(Pointer node);
-  bool NodeIsLeftChild(Pointer node);
-  Pointer MinValueFromRight(const Pointer node) const;
-  void ExcludeNode(Pointer a, Pointer b);
+  Index CopyNodes(const SelfBalancingBinarySearchTree& other, Index root);
+  int CountChildren(Index node) const;
+  Index GetChild(Index node) const;
+  Index GetParent(Index node) const;
+  Index Search(const Key& key) const;
+  Index Extreme(Index node, bool dir) const;
+  Index Step(Index node, bool dir) const;
+  bool RemoveNode(Index node);
+  void RemoveNodeWithoutChildren(Index node);
+  void RemoveNodeWithOneChild(Index node);
+  void RemoveNodeWithTwoChild(Index node);
+  void RebalanceTree(Index node);
+  bool NodeIsLeftChild(Index node) const;
+  bool IsRed(Index node) const;
+  void ExcludeNode(Index a, Index b);
+  template <typename Matches>
+  size_t RemoveWhile(const Key& from, Matches matches);
+  Index BuildBalanced(const std::vector<Index>& nodes, size_t begin,
+                      size_t end, size_t depth, size_t red_depth);
+  void UpdateCount(Index node);
+  void ShrinkPath(Index node);
+  size_t CountBelow(const Key& key, bool inclusive) const;
 };
 
 template <typename Key, typename Value, typename ValueEqual>
 SelfBalancingBinarySearchTree<Key, Value,
-                              ValueEqual>::SelfBalancingBinarySearchTree()
-    : leaf_(new Node()), root_(nullptr){};
+                              ValueEqual>::SelfBalancingBinarySearchTree() {
+  nodes_.New();
+}
 
 template <typename Key, typename Value, typename ValueEqual>
 SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::
     SelfBalancingBinarySearchTree(const SelfBalancingBinarySearchTree& other)
-    : leaf_(new Node()), root_(other.root_){};
+    : SelfBalancingBinarySearchTree() {
+  *this = other;
+}
 
 template <typename Key, typename Value, typename ValueEqual>
 SelfBalancingBinarySearchTree<Key, Value, ValueEqual>&
 SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::operator=(
     const SelfBalancingBinarySearchTree& other) {
   if (this != &other) {
-    if (root_) delete root_;
-    root_ = other.root_;
-    leaf_ = other.leaf_;
+    Clear();
+    root_ = CopyNodes(other, other.root_);
+    size_ = other.size_;
   }
   return *this;
 }
 
-template <typename Key, typename Value, typename ValueEqual>
-SelfBalancingBinarySearchTree<Key, Value,
-                              ValueEqual>::~SelfBalancingBinarySearchTree() {
-  Clear();
-  delete leaf_;
+// Preorder copy, so every parent lands in the slab before its children
+// and the copy keeps the shape and colours of the source.
+template <typename Key, typename Value, typename ValueEqual>
+typename SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Index
+SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::CopyNodes(
+    const SelfBalancingBinarySearchTree& other, Index root) {
+  if (root == kNil) return kNil;
+
+  Index copy = nodes_.New(other.nodes_[root]);
+  nodes_[copy].SetParent(kNil);
+  std::vector<std::pair<Index, Index>> stack = {{root, copy}};
+  while (!stack.empty()) {
+    auto [source, target] = stack.back();
+    stack.pop_back();
+    for (bool dir : {true, false}) {
+      Index child = other.nodes_[source].link[dir];
+      if (child == kNil) continue;
+      Index child_copy = nodes_.New(other.nodes_[child]);
+      nodes_[child_copy].SetParent(target);
+      nodes_[target].link[dir] = child_copy;
+      stack.emplace_back(child, child_copy);
+    }
+  }
+  return copy;
 }
 
 template <typename Key, typename Value, typename ValueEqual>
 bool SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Set(
     const Key& key, const Value& value) {
-  Pointer tmp = new Node(key, value);
-  if (!root_) {
+  Index parent = kNil;
+  Index current_node = root_;
+  while (current_node != kNil) {
+    const Node& node = nodes_[current_node];
+    if (node.data.first == key) return false;
+    parent = current_node;
+    current_node = (node.data.first > key) ? node.link[0] : node.link[1];
+  }
+
+  Index tmp = nodes_.New(key, value);
+  if (parent == kNil) {
     root_ = tmp;
-    root_->color = Color::Black;
-    root_->link[0] = root_->link[1] = leaf_;
   } else {
-    if (Exists(key)) {
-      delete tmp;
-      return false;
-    } else {
-      Pointer current_node = root_;
-      Pointer parent = root_;
-      while (current_node != leaf_) {
-        parent = current_node;
-        current_node = (current_node->data.first > key) ? current_node->link[0]
-                                                        : current_node->link[1];
-      }
-      current_node = tmp;
-      current_node->parent = parent;
-      current_node->link[0] = current_node->link[1] = leaf_;
-
-      bool dir = parent->data.first > key;
-      parent->link[!dir] = current_node;
-
-      BalanceTree(current_node);
+    nodes_[tmp].SetParent(parent);
+    bool dir = nodes_[parent].data.first > key;
+    nodes_[parent].link[!dir] = tmp;
+    for (Index node = parent; node != kNil; node = GetParent(node)) {
+      ++nodes_[node].count;
     }
   }
+  BalanceTree(tmp);
 
+  ++size_;
   return true;
 }
 
 template <typename Key, typename Value, typename ValueEqual>
 Value SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Get(
     const Key& key) const {
-  if (!root_) throw std::invalid_argument("Key is not exists");
-
-  Pointer current_node = root_;
-  while (current_node != leaf_) {
-    if (current_node->data.first == key) return current_node->data.second;
-    if (current_node->data.first > key)
-      current_node = current_node->link[0];
-    else
-      current_node = current_node->link[1];
-  }
-  throw std::invalid_argument("Key is not exists");
+  Index node = Search(key);
+  if (node == kNil) throw std::invalid_argument("Key is not exists");
+  return nodes_[node].data.second;
 }
 
 template <typename Key, typename Value, typename ValueEqual>
 bool SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Exists(
     const Key& key) const {
-  if (Search(key)) return true;
-  return false;
+  return Search(key) != kNil;
 }
 
 template <typename Key, typename Value, typename ValueEqual>
 bool SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Del(
     const Key& key) {
-  Pointer node = Search(key);
-  if (!node) return false;
-  RemoveNode(node);
-  return true;
+  return RemoveNode(Search(key));
 }
 
 template <typename Key, typename Value, typename ValueEqual>
 bool SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Update(
     const Key& key, const Value& value) {
-  Pointer node = Search(key);
-  if (!node) return false;
-  node->data.second = value;
+  Index node = Search(key);
+  if (node == kNil) return false;
+  nodes_[node].data.second = value;
   return true;
 }
 
@@ -239,13 +275,8 @@ template <typename Key, typename Value, typename ValueEqual>
 std::vector<Key> SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Keys()
     const {
   std::vector<Key> keys;
-  Iterator i = Begin();
-  if (i.IsValid()) {
-    while (i != End()) {
-      keys.push_back(i->first);
-      ++i;
-    }
-    keys.push_back(i->first);
+  for (Index node = Extreme(root_, 0); node != kNil; node = Step(node, 1)) {
+    keys.push_back(nodes_[node].data.first);
   }
   return keys;
 }
@@ -253,9 +284,9 @@ std::vector<Key> SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Keys()
 template <typename Key, typename Value, typename ValueEqual>
 bool SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Rename(
     const Key& key, const Key& new_key) {
-  Pointer node = Search(key);
-  if (!node) return false;
-  Set(new_key, node->data.second);
+  Index node = Search(key);
+  if (node == kNil) return false;
+  Set(new_key, nodes_[node].data.second);
   RemoveNode(node);
   return true;
 }
@@ -264,14 +295,11 @@ template <typename Key, typename Value, typename ValueEqual>
 std::vector<Key> SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Find(
     const Value& value) const {
   std::vector<Key> keys;
-  Iterator i = Begin();
-  if (i.IsValid()) {
-    ValueEqual comparator;
-    while (i != End()) {
-      if (comparator(i->second, value)) keys.push_back(i->first);
-      ++i;
+  ValueEqual comparator;
+  for (Index node = Extreme(root_, 0); node != kNil; node = Step(node, 1)) {
+    if (comparator(nodes_[node].data.second, value)) {
+      keys.push_back(nodes_[node].data.first);
     }
-    if (comparator(i->second, value)) keys.push_back(i->first);
   }
   return keys;
 }
@@ -279,34 +307,224 @@ std::vector<Key> SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Find(
 template <typename Key, typename Value, typename ValueEqual>
 std::vector<Value>
 SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Showall() const {
-  std::vector<Value> nodes;
-  Iterator i = Begin();
-  if (i.IsValid()) {
-    while (i != End()) {
-      nodes.push_back(i->second);
-      ++i;
+  std::vector<Value> values;
+  for (Index node = Extreme(root_, 0); node != kNil; node = Step(node, 1)) {
+    values.push_back(nodes_[node].data.second);
+  }
+  return values;
+}
+
+template <typename Key, typename Value, typename ValueEqual>
+std::unique_ptr<BaseCursor<Key, Value>>
+SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::GetCursor() const {
+  return std::make_unique<BSTCursor>(*this);
+}
+
+template <typename Key, typename Value, typename ValueEqual>
+size_t SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::DelRange(
+    const Key& from, const Key& to) {
+  return RemoveWhile(from, [&to](const Key& key) { return !(to < key); });
+}
+
+template <typename Key, typename Value, typename ValueEqual>
+size_t SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::DelPrefix(
+    const Key& prefix) {
+  return RemoveWhile(prefix, [&prefix](const Key& key) {
+    return HasKeyPrefix(key, prefix);
+  });
+}
+
+template <typename Key, typename Value, typename ValueEqual>
+size_t SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Rank(
+    const Key& key) const {
+  return CountBelow(key, false);
+}
+
+// Subtree sizes tell at every node which side holds the position.
+template <typename Key, typename Value, typename ValueEqual>
+Key SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Select(
+    size_t index) const {
+  if (index >= size_) throw std::out_of_range("Index is out of range");
+
+  Index node = root_;
+  while (index != nodes_[nodes_[node].link[0]].count) {
+    size_t left = nodes_[nodes_[node].link[0]].count;
+    if (index < left) {
+      node = nodes_[node].link[0];
+    } else {
+      index -= left + 1;
+      node = nodes_[node].link[1];
+    }
+  }
+  return nodes_[node].data.first;
+}
+
+template <typename Key, typename Value, typename ValueEqual>
+size_t SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::CountRange(
+    const Key& from, const Key& to) const {
+  if (to < from) return 0;
+  return CountBelow(to, true) - CountBelow(from, false);
+}
+
+// Number of keys less than key, or not greater than it when inclusive.
+// Every step right skips the left subtree and the node itself.
+template <typename Key, typename Value, typename ValueEqual>
+size_t SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::CountBelow(
+    const Key& key, bool inclusive) const {
+  size_t count = 0;
+  Index current = root_;
+  while (current != kNil) {
+    const Node& node = nodes_[current];
+    bool right = inclusive ? !(key < node.data.first) : node.data.first < key;
+    if (right) {
+      count += nodes_[node.link[0]].count + 1;
+      current = node.link[1];
+    } else {
+      current = node.link[0];
+    }
+  }
+  return count;
+}
+
+template <typename Key, typename Value, typename ValueEqual>
+void SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::UpdateCount(
+    Index node) {
+  if (node != kNil) {
+    nodes_[node].count = nodes_[nodes_[node].link[0]].count +
+                         nodes_[nodes_[node].link[1]].count + 1;
+  }
+}
+
+// One node less below node and every node above it.
+template <typename Key, typename Value, typename ValueEqual>
+void SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::ShrinkPath(
+    Index node) {
+  for (; node != kNil; node = GetParent(node)) {
+    --nodes_[node].count;
+  }
+}
+
+// A short run is deleted node by node. When deleting it would cost more
+// than a pass over the whole tree, the remaining nodes are relinked into a
+// balanced tree instead, without any rotations.
+template <typename Key, typename Value, typename ValueEqual>
+template <typename Matches>
+size_t SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::RemoveWhile(
+    const Key& from, Matches matches) {
+  std::vector<Key> keys;
+  BSTCursor cursor(*this);
+  for (cursor.Seek(from); cursor.IsValid() && matches(cursor.GetKey());
+       cursor.Next()) {
+    keys.push_back(cursor.GetKey());
+  }
+  if (keys.size() * std::log2(size_ + 1) < size_) {
+    for (const Key& key : keys) {
+      Del(key);
     }
-    nodes.push_back(i->second);
+    return keys.size();
   }
-  return nodes;
+
+  std::vector<Index> kept;
+  kept.reserve(size_ - keys.size());
+  std::vector<Index> stack;
+  Index node = root_;
+  while (!stack.empty() || node != kNil) {
+    if (node != kNil) {
+      stack.push_back(node);
+      node = nodes_[node].link[0];
+      continue;
+    }
+    node = stack.back();
+    stack.pop_back();
+    Index next = nodes_[node].link[1];
+    const Key& key = nodes_[node].data.first;
+    if (!(key < from) && matches(key)) {
+      nodes_.Delete(node);
+    } else {
+      kept.push_back(node);
+    }
+    node = next;
+  }
+
+  size_ = kept.size();
+  size_t red_depth = static_cast<size_t>(std::log2(kept.size() + 1));
+  root_ = kept.empty() ? kNil
+                       : BuildBalanced(kept, 0, kept.size(), 0, red_depth);
+  nodes_[root_].SetParent(kNil);
+  return keys.size();
+}
+
+// Middle splits leave every nil at depth red_depth or one below, so
+// colouring the nodes of the last, incomplete level red keeps every path
+// with the same number of black nodes.
+template <typename Key, typename Value, typename ValueEqual>
+typename SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Index
+SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::BuildBalanced(
+    const std::vector<Index>& nodes, size_t begin, size_t end, size_t depth,
+    size_t red_depth) {
+  size_t middle = begin + (end - begin) / 2;
+  Index index = nodes[middle];
+  Node& node = nodes_[index];
+  node.SetColor(depth == red_depth ? Color::Red : Color::Black);
+  node.count = static_cast<Index>(end - begin);
+  node.link[0] = node.link[1] = kNil;
+  if (begin < middle) {
+    node.link[0] = BuildBalanced(nodes, begin, middle, depth + 1, red_depth);
+    nodes_[node.link[0]].SetParent(index);
+  }
+  if (middle + 1 < end) {
+    node.link[1] =
+        BuildBalanced(nodes, middle + 1, end, depth + 1, red_depth);
+    nodes_[node.link[1]].SetParent(index);
+  }
+  return index;
 }
 
 template <typename Key, typename Value, typename ValueEqual>
-BSTNode<Key, Value>*
+typename SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Index
 SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Search(
     const Key& key) const {
-  Pointer node = root_;
-  while (node && node != leaf_) {
-    if (node->data.first == key) return node;
-    node = (node->data.first > key) ? node->link[0] : node->link[1];
+  Index current = root_;
+  while (current != kNil) {
+    const Node& node = nodes_[current];
+    if (node.data.first == key) return current;
+    current = (node.data.first > key) ? node.link[0] : node.link[1];
+  }
+  return kNil;
+}
+
+template <typename Key, typename Value, typename ValueEqual>
+typename SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Index
+SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Extreme(
+    Index node, bool dir) const {
+  if (node == kNil) return kNil;
+  while (nodes_[node].link[dir] != kNil) {
+    node = nodes_[node].link[dir];
+  }
+  return node;
+}
+
+// In-order neighbour of node, the successor for dir 1.
+template <typename Key, typename Value, typename ValueEqual>
+typename SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Index
+SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Step(Index node,
+                                                            bool dir) const {
+  if (nodes_[node].link[dir] != kNil) {
+    return Extreme(nodes_[node].link[dir], !dir);
+  }
+  Index parent = GetParent(node);
+  while (parent != kNil && node == nodes_[parent].link[dir]) {
+    node = parent;
+    parent = GetParent(parent);
   }
-  return nullptr;
+  return parent;
 }
 
 template <typename Key, typename Value, typename ValueEqual>
 bool SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::RemoveNode(
-    Pointer node) {
-  if (!node || node == leaf_) return false;
+    Index node) {
+  if (node == kNil) return false;
+  --size_;
   switch (CountChildren(node)) {
     case 0:
       RemoveNodeWithoutChildren(node);
@@ -323,131 +541,126 @@ bool SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::RemoveNode(
 
 template <typename Key, typename Value, typename ValueEqual>
 int SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::CountChildren(
-    Pointer node) const {
-  int count = 0;
-  if (node) {
-    count += node->link[0] != leaf_;
-    count += node->link[1] != leaf_;
-  }
-  return count;
+    Index node) const {
+  return (nodes_[node].link[0] != kNil) + (nodes_[node].link[1] != kNil);
 }
 
 template <typename Key, typename Value, typename ValueEqual>
 void SelfBalancingBinarySearchTree<
-    Key, Value, ValueEqual>::RemoveNodeWithoutChildren(Pointer node) {
-  Pointer parent = GetParent(node);
-  if (!parent) {
-    root_ = nullptr;
+    Key, Value, ValueEqual>::RemoveNodeWithoutChildren(Index node) {
+  // A black leaf shortens its paths, so the tree is rebalanced while the
+  // node still stands in for the missing black, then it is unlinked.
+  if (!IsRed(node)) RebalanceTree(node);
+  Index parent = GetParent(node);
+  ShrinkPath(parent);
+  if (parent == kNil) {
+    root_ = kNil;
   } else {
-    bool dir = (parent->link[1] == node);
-    parent->link[dir] = leaf_;
+    bool dir = (nodes_[parent].link[1] == node);
+    nodes_[parent].link[dir] = kNil;
   }
-  delete node;
+  nodes_.Delete(node);
 }
 
 template <typename Key, typename Value, typename ValueEqual>
 void SelfBalancingBinarySearchTree<
-    Key, Value, ValueEqual>::RemoveNodeWithOneChild(Pointer node) {
-  Pointer child = GetChild(node);
-  bool child_color = child->color;
-  Swap(node, child);
-  node->link[0] = child->link[0];
-  node->link[1] = child->link[1];
-  if (child->link[0] != leaf_) child->link[0]->parent = node;
-  if (child->link[1] != leaf_) child->link[1]->parent = node;
-
-  delete child;
-
-  if (child_color)
-    node->color = Color::Black;
+    Key, Value, ValueEqual>::RemoveNodeWithOneChild(Index node) {
+  Index child = GetChild(node);
+  bool child_color = nodes_[child].GetColor();
+  ShrinkPath(node);
+  std::swap(nodes_[node].data, nodes_[child].data);
+  for (bool dir : {false, true}) {
+    Index grandchild = nodes_[child].link[dir];
+    nodes_[node].link[dir] = grandchild;
+    if (grandchild != kNil) nodes_[grandchild].SetParent(node);
+  }
+
+  nodes_.Delete(child);
+
+  if (child_color == Color::Red)
+    nodes_[node].SetColor(Color::Black);
   else
     RebalanceTree(node);
 }
 
 template <typename Key, typename Value, typename ValueEqual>
 void SelfBalancingBinarySearchTree<
-    Key, Value, ValueEqual>::RemoveNodeWithTwoChild(Pointer node) {
-  Pointer min_node = MinValueFromRight(node);
-  bool color = min_node->color;
-  Pointer child = GetChild(min_node);
-  Pointer parent = GetParent(min_node);
+    Key, Value, ValueEqual>::RemoveNodeWithTwoChild(Index node) {
+  Index min_node = Extreme(nodes_[node].link[1], 0);
+  bool color = nodes_[min_node].GetColor();
+  Index child = GetChild(min_node);
+  Index parent = GetParent(min_node);
+  ShrinkPath(parent);
 
   if (parent == node) {
-    child->parent = min_node;
+    nodes_[child].SetParent(min_node);
   } else {
     ExcludeNode(min_node, child);
-    min_node->link[1] = node->link[1];
-    min_node->link[1]->parent = min_node;
+    nodes_[min_node].link[1] = nodes_[node].link[1];
+    nodes_[nodes_[min_node].link[1]].SetParent(min_node);
   }
 
   ExcludeNode(node, min_node);
-  min_node->link[0] = node->link[0];
-  min_node->link[0]->parent = min_node;
-  min_node->color = node->color;
+  nodes_[min_node].link[0] = nodes_[node].link[0];
+  nodes_[nodes_[min_node].link[0]].SetParent(min_node);
+  nodes_[min_node].SetColor(nodes_[node].GetColor());
+  nodes_[min_node].count = nodes_[node].count;
 
-  delete node;
+  nodes_.Delete(node);
   if (color == Color::Black) RebalanceTree(child);
-  if (child == leaf_) child->parent = nullptr;
+  nodes_[kNil].SetParent(kNil);
 }
 
 template <typename Key, typename Value, typename ValueEqual>
-BSTNode<Key, Value>*
+typename SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Index
 SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::GetParent(
-    Pointer node) const {
-  return node->parent;
+    Index node) const {
+  return nodes_[node].GetParent();
 }
 
 template <typename Key, typename Value, typename ValueEqual>
-BSTNode<Key, Value>*
+typename SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Index
 SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::GetChild(
-    Pointer node) const {
-  Pointer child = node->link[0] != leaf_ ? node->link[0] : node->link[1];
-  return child;
-}
-
-template <typename Key, typename Value, typename ValueEqual>
-void SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Swap(Pointer a,
-                                                                 Pointer b) {
-  std::swap(a->data.first, b->data.first);
-  std::swap(a->data.second, b->data.second);
+    Index node) const {
+  const Node& parent = nodes_[node];
+  return parent.link[0] != kNil ? parent.link[0] : parent.link[1];
 }
 
 template <typename Key, typename Value, typename ValueEqual>
 void SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::RebalanceTree(
-    Pointer node) {
-  while (node != root_ && node->color == Color::Black) {
-    Pointer parent = GetParent(node);
-    Pointer brother;
+    Index node) {
+  while (node != root_ && !IsRed(node)) {
+    Index parent = GetParent(node);
     bool dir = NodeIsLeftChild(node);
 
-    brother = parent->link[dir];
-    if (brother != leaf_ && brother->color == Color::Red) {
-      brother->color = Color::Black;
-      parent->color = Color::Red;
+    Index brother = nodes_[parent].link[dir];
+    if (IsRed(brother)) {
+      nodes_[brother].SetColor(Color::Black);
+      nodes_[parent].SetColor(Color::Red);
       if (dir)
         LeftRotation(parent);
       else
         RightRotation(parent);
-      brother = parent->link[dir];
+      brother = nodes_[parent].link[dir];
     }
-    if (brother != leaf_ && brother->link[!dir]->color == Color::Black &&
-        brother->link[dir]->color == Color::Black) {
-      brother->color = Color::Red;
+    if (!IsRed(nodes_[brother].link[!dir]) &&
+        !IsRed(nodes_[brother].link[dir])) {
+      nodes_[brother].SetColor(Color::Red);
       node = parent;
     } else {
-      if (brother != leaf_ && brother->link[dir]->color == Color::Black) {
-        brother->link[!dir]->color = Color::Black;
-        brother->color = Color::Red;
+      if (!IsRed(nodes_[brother].link[dir])) {
+        nodes_[nodes_[brother].link[!dir]].SetColor(Color::Black);
+        nodes_[brother].SetColor(Color::Red);
         if (dir)
           RightRotation(brother);
         else
           LeftRotation(brother);
 
-        brother = parent->link[dir];
+        brother = nodes_[parent].link[dir];
       }
-      brother->color = parent->color;
-      parent->color = Color::Black;
-      if (brother != leaf_) brother->link[dir]->color = Color::Black;
+      nodes_[brother].SetColor(nodes_[parent].GetColor());
+      nodes_[parent].SetColor(Color::Black);
+      nodes_[nodes_[brother].link[dir]].SetColor(Color::Black);
       if (dir)
         LeftRotation(parent);
       else
@@ -455,133 +668,111 @@ void SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::RebalanceTree(
       node = root_;
     }
   }
-  node->color = Color::Black;
+  nodes_[node].SetColor(Color::Black);
 }
 
 template <typename Key, typename Value, typename ValueEqual>
 bool SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::NodeIsLeftChild(
-    Pointer node) {
-  return GetParent(node)->link[0] == node;
+    Index node) const {
+  return nodes_[GetParent(node)].link[0] == node;
 }
 
 template <typename Key, typename Value, typename ValueEqual>
-void SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::LeftRotation(
-    Pointer node) {
-  Pointer tmp = node->link[1];
-  node->link[1] = tmp == leaf_ ? leaf_ : tmp->link[0];
-  if (tmp != leaf_) {
-    tmp->link[0]->parent = node;
-  }
-  tmp->parent = node->parent;
-  if (node->parent == nullptr) {
-    root_ = tmp;
-  } else {
-    bool dir = NodeIsLeftChild(node);
-    node->parent->link[!dir] = tmp;
-  }
-  tmp->link[0] = node;
-  node->parent = tmp;
+bool SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::IsRed(
+    Index node) const {
+  return nodes_[node].GetColor() == Color::Red;
 }
 
 template <typename Key, typename Value, typename ValueEqual>
-void SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::RightRotation(
-    Pointer node) {
-  Pointer tmp = node->link[0];
-  node->link[0] = tmp == leaf_ ? leaf_ : tmp->link[1];
-  if (tmp != leaf_) {
-    tmp->link[1]->parent = node;
-  }
-  tmp->parent = node->parent;
-  if (node->parent == nullptr) {
-    root_ = tmp;
-  } else {
-    bool dir = NodeIsLeftChild(node);
-    node->parent->link[!dir] = tmp;
-  }
-  tmp->link[1] = node;
-  node->parent = tmp;
+void SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::LeftRotation(
+    Index node) {
+  Index tmp = nodes_[node].link[1];
+  Index inner = nodes_[tmp].link[0];
+  nodes_[node].link[1] = inner;
+  if (inner != kNil) nodes_[inner].SetParent(node);
+  ExcludeNode(node, tmp);
+  nodes_[tmp].link[0] = node;
+  nodes_[node].SetParent(tmp);
+  UpdateCount(node);
+  UpdateCount(tmp);
 }
 
 template <typename Key, typename Value, typename ValueEqual>
-BSTNode<Key, Value>*
-SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::MinValueFromRight(
-    const Pointer node) const {
-  Pointer tmp = node->link[1];
-  while (tmp->link[0] != leaf_) {
-    tmp = tmp->link[0];
-  }
-  return tmp;
+void SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::RightRotation(
+    Index node) {
+  Index tmp = nodes_[node].link[0];
+  Index inner = nodes_[tmp].link[1];
+  nodes_[node].link[0] = inner;
+  if (inner != kNil) nodes_[inner].SetParent(node);
+  ExcludeNode(node, tmp);
+  nodes_[tmp].link[1] = node;
+  nodes_[node].SetParent(tmp);
+  UpdateCount(node);
+  UpdateCount(tmp);
 }
 
 template <typename Key, typename Value, typename ValueEqual>
 void SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::ExcludeNode(
-    Pointer a, Pointer b) {
-  Pointer parent = GetParent(a);
-  if (!parent)
+    Index a, Index b) {
+  Index parent = GetParent(a);
+  if (parent == kNil)
     root_ = b;
   else {
     bool dir = NodeIsLeftChild(a);
-    parent->link[!dir] = b;
+    nodes_[parent].link[!dir] = b;
   }
-  b->parent = parent;
+  nodes_[b].SetParent(parent);
 }
 
 template <typename Key, typename Value, typename ValueEqual>
 void SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::BalanceTree(
-    Pointer node) {
-  while (node->parent != nullptr && node->parent->color == Color::Red) {
-    bool dir = NodeIsLeftChild(node->parent);
-    Pointer uncle = node->parent->parent->link[dir];
-    if (uncle && uncle->color == Color::Red) {
-      uncle->color = Color::Black;
-      node->parent->color = Color::Black;
-      node->parent->parent->color = Color::Red;
-      node = node->parent->parent;
+    Index node) {
+  while (IsRed(GetParent(node))) {
+    Index parent = GetParent(node);
+    Index grandparent = GetParent(parent);
+    bool dir = NodeIsLeftChild(parent);
+    Index uncle = nodes_[grandparent].link[dir];
+    if (IsRed(uncle)) {
+      nodes_[uncle].SetColor(Color::Black);
+      nodes_[parent].SetColor(Color::Black);
+      nodes_[grandparent].SetColor(Color::Red);
+      node = grandparent;
     } else {
-      if (node == node->parent->link[dir]) {
-        node = node->parent;
+      if (node == nodes_[parent].link[dir]) {
+        node = parent;
         if (dir)
           LeftRotation(node);
         else
           RightRotation(node);
+        parent = GetParent(node);
       }
-      node->parent->color = Color::Black;
-      node->parent->parent->color = Color::Red;
+      nodes_[parent].SetColor(Color::Black);
+      nodes_[grandparent].SetColor(Color::Red);
       if (dir)
-        RightRotation(node->parent->parent);
+        RightRotation(grandparent);
       else
-        LeftRotation(node->parent->parent);
+        LeftRotation(grandparent);
     }
   }
-  root_->color = Color::Black;
+  nodes_[root_].SetColor(Color::Black);
 }
 
+// The live nodes are copied in preorder into a fresh slab, which leaves the
+// free slots behind with the old one.
 template <typename Key, typename Value, typename ValueEqual>
-typename SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Iterator
-SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Begin() const {
-  Pointer it = root_;
-  while (it && it->link[0] != leaf_) {
-    it = it->link[0];
-  }
-  return Iterator(it, leaf_);
-}
-
-template <typename Key, typename Value, typename ValueEqual>
-typename SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Iterator
-SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::End() const {
-  Pointer it = root_;
-  while (it && it->link[1] != leaf_) {
-    it = it->link[1];
-  }
-  return Iterator(it, leaf_);
+void SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Compact() {
+  SelfBalancingBinarySearchTree compact(*this);
+  swap(nodes_, compact.nodes_);
+  std::swap(root_, compact.root_);
 }
 
+// Nodes are dropped with the slab, nothing is rebalanced on the way.
 template <typename Key, typename Value, typename ValueEqual>
 void SelfBalancingBinarySearchTree<Key, Value, ValueEqual>::Clear() {
-  while (root_) {
-    Pointer node = Begin().current_;
-    RemoveNode(node);
-  }
+  nodes_.Clear();
+  nodes_.New();
+  root_ = kNil;
+  size_ = 0;
 }
 
 }  // namespace s21
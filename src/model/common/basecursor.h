@@ -0,0 +1,25 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_COMMON_BASECURSOR_H_
+#define TRANSACTIONS_SOURCE_MODEL_COMMON_BASECURSOR_H_
+
+namespace s21 {
+
+// Position in the key order of an ordered storage. A cursor is invalidated
+// by any modification of its storage.
+template <typename Key, typename Value>
+class BaseCursor {
+ public:
+  virtual ~BaseCursor() = default;
+  virtual bool IsValid() const = 0;
+  // Moves to the first key that is not less than key.
+  virtual void Seek(const Key& key) = 0;
+  virtual void SeekToFirst() = 0;
+  virtual void SeekToLast() = 0;
+  virtual void Next() = 0;
+  virtual void Prev() = 0;
+  virtual const Key& GetKey() const = 0;
+  virtual const Value& GetValue() const = 0;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_COMMON_BASECURSOR_H_
@@ -1,9 +1,28 @@
 #ifndef TRANSACTIONS_SOURCE_MODEL_COMMON_BASESTORAGE_H_
 #define TRANSACTIONS_SOURCE_MODEL_COMMON_BASESTORAGE_H_
 
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "model/common/basecursor.h"
+
 namespace s21 {
+
+// Keys other than strings only start with themselves.
+template <typename Key>
+bool HasKeyPrefix(const Key& key, const Key& prefix) {
+  if constexpr (std::is_same_v<Key, std::string>) {
+    return key.compare(0, prefix.size(), prefix) == 0;
+  } else {
+    return key == prefix;
+  }
+}
+
 template <typename Key, typename Value>
 class BaseStorage {
  public:
@@ -17,6 +36,130 @@ class BaseStorage {
   virtual bool Rename(const Key& key, const Key& new_key) = 0;
   virtual std::vector<Key> Find(const Value& value) const = 0;
   virtual std::vector<Value> Showall() const = 0;
+  virtual bool IsThreadSafe() const { return false; }
+  // Independent copy of the storage of the same engine, built in linear
+  // time from the engine's own layout.
+  virtual std::unique_ptr<BaseStorage> Clone() const = 0;
+  // Prepares room for count more records, engines that cannot pre-size
+  // ignore the hint.
+  virtual void Reserve(size_t /*count*/) {}
+  // Whether SetBatch builds the engine in one pass instead of inserting
+  // the records one by one, so that collecting a batch pays off.
+  virtual bool HasBulkLoad() const { return false; }
+  // Inserts a batch of records, existing keys keep their values. Returns
+  // the number of inserted records.
+  virtual size_t SetBatch(std::vector<std::pair<Key, Value>> records) {
+    size_t inserted = 0;
+    for (const auto& [key, value] : records) {
+      inserted += Set(key, value) ? 1 : 0;
+    }
+    return inserted;
+  }
+  // Gives back memory kept for records that have been removed.
+  virtual void Compact() {}
+  // Ordered engines return a cursor over their key order, the others
+  // return nullptr.
+  virtual std::unique_ptr<BaseCursor<Key, Value>> GetCursor() const {
+    return nullptr;
+  }
+  // Removes the records with keys in [from, to] and returns their number.
+  virtual size_t DelRange(const Key& from, const Key& to) {
+    return DelMatching(from, [&from, &to](const Key& key) {
+      return !(key < from) && !(to < key);
+    });
+  }
+  // Removes the records whose keys start with prefix and returns their
+  // number.
+  virtual size_t DelPrefix(const Key& prefix) {
+    return DelMatching(prefix, [&prefix](const Key& key) {
+      return HasKeyPrefix(key, prefix);
+    });
+  }
+  // Records with keys in [from, to], at most limit of them.
+  virtual std::vector<std::pair<Key, Value>> Scan(const Key& from,
+                                                  const Key& to,
+                                                  size_t limit) const {
+    std::unique_ptr<BaseCursor<Key, Value>> cursor = GetOrderedCursor();
+    std::vector<std::pair<Key, Value>> result;
+    cursor->Seek(from);
+    while (cursor->IsValid() && result.size() < limit &&
+           !(to < cursor->GetKey())) {
+      result.emplace_back(cursor->GetKey(), cursor->GetValue());
+      cursor->Next();
+    }
+
+    return result;
+  }
+
+  // Order statistics. Engines that keep subtree sizes answer in
+  // O(log n), other ordered engines walk their cursor.
+  // Number of keys less than key.
+  virtual size_t Rank(const Key& key) const {
+    std::unique_ptr<BaseCursor<Key, Value>> cursor = GetOrderedCursor();
+    size_t rank = 0;
+    for (cursor->SeekToFirst(); cursor->IsValid() && cursor->GetKey() < key;
+         cursor->Next()) {
+      ++rank;
+    }
+    return rank;
+  }
+  // Key at position index of the key order, counting from 0.
+  virtual Key Select(size_t index) const {
+    std::unique_ptr<BaseCursor<Key, Value>> cursor = GetOrderedCursor();
+    cursor->SeekToFirst();
+    for (size_t i = 0; i < index && cursor->IsValid(); ++i) {
+      cursor->Next();
+    }
+    if (!cursor->IsValid()) {
+      throw std::out_of_range("Index is out of range");
+    }
+    return cursor->GetKey();
+  }
+  // Number of keys in [from, to].
+  virtual size_t CountRange(const Key& from, const Key& to) const {
+    std::unique_ptr<BaseCursor<Key, Value>> cursor = GetOrderedCursor();
+    size_t count = 0;
+    for (cursor->Seek(from); cursor->IsValid() && !(to < cursor->GetKey());
+         cursor->Next()) {
+      ++count;
+    }
+    return count;
+  }
+
+ protected:
+  std::unique_ptr<BaseCursor<Key, Value>> GetOrderedCursor() const {
+    std::unique_ptr<BaseCursor<Key, Value>> cursor = GetCursor();
+    if (cursor == nullptr) {
+      throw std::logic_error("Storage is not ordered");
+    }
+    return cursor;
+  }
+
+  // Matching keys form one run of the key order starting at from, ordered
+  // engines walk just that run and unordered ones check every key.
+  template <typename Matches>
+  size_t DelMatching(const Key& from, Matches matches) {
+    std::vector<Key> keys;
+    std::unique_ptr<BaseCursor<Key, Value>> cursor = GetCursor();
+    if (cursor != nullptr) {
+      for (cursor->Seek(from); cursor->IsValid() && matches(cursor->GetKey());
+           cursor->Next()) {
+        keys.push_back(cursor->GetKey());
+      }
+    } else {
+      for (const Key& key : Keys()) {
+        if (matches(key)) {
+          keys.push_back(key);
+        }
+      }
+    }
+
+    size_t removed = 0;
+    for (const Key& key : keys) {
+      removed += Del(key) ? 1 : 0;
+    }
+    return removed;
+  }
 };
 }  // namespace s21
 
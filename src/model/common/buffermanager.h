@@ -0,0 +1,92 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_COMMON_BUFFERMANAGER_H_
+#define TRANSACTIONS_SOURCE_MODEL_COMMON_BUFFERMANAGER_H_
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+
+#include "model/common/pagefile.h"
+
+namespace s21 {
+
+// Keeps decoded pages of a PageFile in memory. Node is a decoded page
+// with an id and a dirty flag that can Load itself from page bytes and
+// Store itself back. The least recently used nodes are written back and
+// dropped by Trim, so pointers returned by Fetch and New stay valid until
+// the next Trim.
+template <typename Node>
+class BufferManager {
+ public:
+  BufferManager(PageFile& file, size_t capacity)
+      : file_(file), capacity_(capacity) {}
+
+  BufferManager(const BufferManager&) = delete;
+  BufferManager& operator=(const BufferManager&) = delete;
+
+  Node* Fetch(PageId id) {
+    auto found = index_.find(id);
+    if (found != index_.end()) {
+      nodes_.splice(nodes_.begin(), nodes_, found->second);
+      return &*found->second;
+    }
+    file_.Verify(id);
+    Node& node = nodes_.emplace_front();
+    index_[id] = nodes_.begin();
+    node.id = id;
+    node.Load(file_.GetPage(id));
+    return &node;
+  }
+
+  Node* New() {
+    PageId id = file_.Allocate();
+    Node& node = nodes_.emplace_front();
+    index_[id] = nodes_.begin();
+    node.id = id;
+    node.dirty = true;
+    return &node;
+  }
+
+  // Gives the page of node back to the file.
+  void Drop(Node* node) {
+    PageId id = node->id;
+    auto found = index_.find(id);
+    nodes_.erase(found->second);
+    index_.erase(found);
+    file_.Free(id);
+  }
+
+  void Trim() {
+    while (nodes_.size() > capacity_) {
+      Node& node = nodes_.back();
+      WriteBack(node);
+      index_.erase(node.id);
+      nodes_.pop_back();
+    }
+  }
+
+  void Flush() {
+    for (Node& node : nodes_) {
+      WriteBack(node);
+    }
+  }
+
+  size_t GetCachedCount() const { return nodes_.size(); }
+
+ private:
+  void WriteBack(Node& node) {
+    if (node.dirty) {
+      node.Store(file_.GetPage(node.id));
+      file_.Seal(node.id);
+      node.dirty = false;
+    }
+  }
+
+  PageFile& file_;
+  size_t capacity_;
+  std::list<Node> nodes_;
+  std::unordered_map<PageId, typename std::list<Node>::iterator> index_;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_COMMON_BUFFERMANAGER_H_
@@ -0,0 +1,151 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_COMMON_EPOCHRECLAIMER_H_
+#define TRANSACTIONS_SOURCE_MODEL_COMMON_EPOCHRECLAIMER_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace s21 {
+
+// Epoch-based reclamation for structures read without locks. Readers pin
+// the current epoch for the duration of an operation, and an object
+// unlinked by a writer is freed only once every operation that could still
+// hold a pointer to it has finished. A reader marks the epoch only in the
+// slot of its own thread, so readers on different cores never write to the
+// same cache line.
+class EpochReclaimer {
+ private:
+  struct Slot;
+
+ public:
+  class Guard {
+   public:
+    explicit Guard(EpochReclaimer& reclaimer)
+        : slot_(reclaimer.GetSlot()), epoch_(reclaimer.Enter(slot_)) {}
+
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+    ~Guard() { Leave(slot_, epoch_); }
+
+   private:
+    Slot& slot_;
+    uint64_t epoch_;
+  };
+
+  EpochReclaimer() = default;
+  EpochReclaimer(const EpochReclaimer&) = delete;
+  EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+  ~EpochReclaimer() {
+    for (auto& retired : limbo_) {
+      Free(retired);
+    }
+  }
+
+  // The object must already be unreachable for operations that start from
+  // now on.
+  template <typename T>
+  void Retire(T* object) {
+    std::lock_guard lock(mtx_);
+    uint64_t epoch = epoch_.load();
+    limbo_[epoch % kEpochs].push_back(
+        {const_cast<void*>(static_cast<const void*>(object)),
+         [](void* ptr) { delete static_cast<T*>(ptr); }});
+    TryAdvance(epoch);
+  }
+
+ private:
+  struct Retired {
+    void* object;
+    void (*deleter)(void*);
+  };
+
+  // An object retired in epoch e is freed when the epoch moves to e + 2,
+  // which needs every operation of e - 1 and e to finish first, so three
+  // generations are enough.
+  static constexpr uint64_t kEpochs = 3;
+  // Threads beyond this many share slots, which stays correct because the
+  // counters are atomic.
+  static constexpr size_t kSlots = 64;
+  static constexpr size_t kCacheLine = 64;
+
+  // Number of operations of one thread running in each epoch.
+  struct alignas(kCacheLine) Slot {
+    std::array<std::atomic<uint32_t>, kEpochs> active{};
+  };
+
+  // Live threads get distinct indices, and an exiting thread hands its
+  // index over to the next one.
+  struct ThreadIndex {
+    ThreadIndex() {
+      std::lock_guard lock(index_mtx_);
+      if (free_indices_.empty()) {
+        value = next_index_++;
+      } else {
+        value = free_indices_.back();
+        free_indices_.pop_back();
+      }
+    }
+
+    ~ThreadIndex() {
+      std::lock_guard lock(index_mtx_);
+      free_indices_.push_back(value);
+    }
+
+    size_t value;
+  };
+
+  Slot& GetSlot() {
+    thread_local const ThreadIndex index;
+    return slots_[index.value % kSlots];
+  }
+
+  uint64_t Enter(Slot& slot) {
+    while (true) {
+      uint64_t epoch = epoch_.load();
+      slot.active[epoch % kEpochs].fetch_add(1);
+      if (epoch_.load() == epoch) {
+        return epoch;
+      }
+      slot.active[epoch % kEpochs].fetch_sub(1);
+    }
+  }
+
+  static void Leave(Slot& slot, uint64_t epoch) {
+    slot.active[epoch % kEpochs].fetch_sub(1);
+  }
+
+  void TryAdvance(uint64_t epoch) {
+    uint64_t previous = (epoch + kEpochs - 1) % kEpochs;
+    for (const Slot& slot : slots_) {
+      if (slot.active[previous].load() != 0) {
+        return;
+      }
+    }
+    epoch_.store(epoch + 1);
+    Free(limbo_[(epoch + 2) % kEpochs]);
+  }
+
+  static void Free(std::vector<Retired>& retired) {
+    for (const Retired& item : retired) {
+      item.deleter(item.object);
+    }
+    retired.clear();
+  }
+
+  static inline std::mutex index_mtx_;
+  static inline std::vector<size_t> free_indices_;
+  static inline size_t next_index_ = 0;
+
+  std::atomic<uint64_t> epoch_{0};
+  std::array<Slot, kSlots> slots_{};
+  std::array<std::vector<Retired>, kEpochs> limbo_;
+  std::mutex mtx_;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_COMMON_EPOCHRECLAIMER_H_
@@ -0,0 +1,197 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_COMMON_EXPIRYHEAP_H_
+#define TRANSACTIONS_SOURCE_MODEL_COMMON_EXPIRYHEAP_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "model/hashtable/seeded_hash.h"
+
+namespace s21 {
+
+// Expiry times of keys in a 4-ary min-heap. The heap keeps each time next
+// to the id of its entry, so sifting stays inside one array, and every
+// entry knows its position in the heap, so a key found through the index
+// is moved or removed without a search. Four children of a node take 64
+// bytes, and the heap is half as deep as a binary one.
+template <typename Key, typename Hasher = SeededHash<Key>>
+class ExpiryHeap {
+ public:
+  using time_type = std::chrono::steady_clock::time_point;
+
+  static constexpr size_t kArity = 4;
+
+  // Sets the expiry time of key, replacing the one it had.
+  void Push(const Key& key, time_type death_time) {
+    auto [it, inserted] = index_.try_emplace(key, 0);
+    if (!inserted) {
+      size_t position = entries_[it->second].position;
+      heap_[position].death_time = death_time;
+      Restore(position);
+      return;
+    }
+
+    size_t id = entries_.size();
+    if (free_.empty()) {
+      entries_.push_back({key, heap_.size()});
+    } else {
+      id = free_.back();
+      free_.pop_back();
+      entries_[id] = {key, heap_.size()};
+    }
+    it->second = id;
+    heap_.push_back({death_time, id});
+    SiftUp(heap_.size() - 1);
+  }
+
+  std::optional<time_type> Find(const Key& key) const {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return std::nullopt;
+    }
+    return heap_[entries_[it->second].position].death_time;
+  }
+
+  bool Erase(const Key& key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return false;
+    }
+    RemoveAt(entries_[it->second].position);
+    return true;
+  }
+
+  // The entry keeps its place, only the index learns the new key. A time
+  // that new_key had is dropped.
+  void Rename(const Key& key, const Key& new_key) {
+    auto it = index_.find(key);
+    if (it == index_.end() || key == new_key) {
+      return;
+    }
+    size_t id = it->second;
+    index_.erase(it);
+    Erase(new_key);
+    entries_[id].key = new_key;
+    index_.emplace(new_key, id);
+  }
+
+  // Drops the matching keys in one pass and heapifies the rest.
+  template <typename Predicate>
+  size_t EraseIf(Predicate matches) {
+    size_t kept = 0;
+    for (const Slot& slot : heap_) {
+      Entry& entry = entries_[slot.entry];
+      if (matches(entry.key)) {
+        index_.erase(entry.key);
+        free_.push_back(slot.entry);
+      } else {
+        entry.position = kept;
+        heap_[kept++] = slot;
+      }
+    }
+    size_t removed = heap_.size() - kept;
+    heap_.resize(kept);
+    for (size_t i = kept / kArity + 1; i-- > 0;) {
+      SiftDown(i);
+    }
+    return removed;
+  }
+
+  bool IsEmpty() const { return heap_.empty(); }
+
+  size_t GetSize() const { return heap_.size(); }
+
+  const Key& GetTopKey() const { return entries_[heap_.front().entry].key; }
+
+  time_type GetTopTime() const { return heap_.front().death_time; }
+
+  void Pop() { RemoveAt(0); }
+
+ private:
+  struct Slot {
+    time_type death_time;
+    size_t entry;
+  };
+
+  struct Entry {
+    Key key;
+    size_t position;
+  };
+
+  void Place(size_t position, const Slot& slot) {
+    heap_[position] = slot;
+    entries_[slot.entry].position = position;
+  }
+
+  void SiftUp(size_t position) {
+    Slot slot = heap_[position];
+    while (position > 0) {
+      size_t parent = (position - 1) / kArity;
+      if (!(slot.death_time < heap_[parent].death_time)) {
+        break;
+      }
+      Place(position, heap_[parent]);
+      position = parent;
+    }
+    Place(position, slot);
+  }
+
+  void SiftDown(size_t position) {
+    if (position >= heap_.size()) {
+      return;
+    }
+    Slot slot = heap_[position];
+    while (true) {
+      size_t first = position * kArity + 1;
+      if (first >= heap_.size()) {
+        break;
+      }
+      size_t last = std::min(first + kArity, heap_.size());
+      size_t best = first;
+      for (size_t child = first + 1; child < last; ++child) {
+        if (heap_[child].death_time < heap_[best].death_time) {
+          best = child;
+        }
+      }
+      if (!(heap_[best].death_time < slot.death_time)) {
+        break;
+      }
+      Place(position, heap_[best]);
+      position = best;
+    }
+    Place(position, slot);
+  }
+
+  void Restore(size_t position) {
+    if (position > 0 && heap_[position].death_time <
+                            heap_[(position - 1) / kArity].death_time) {
+      SiftUp(position);
+    } else {
+      SiftDown(position);
+    }
+  }
+
+  void RemoveAt(size_t position) {
+    size_t id = heap_[position].entry;
+    index_.erase(entries_[id].key);
+    free_.push_back(id);
+    Slot last = heap_.back();
+    heap_.pop_back();
+    if (position < heap_.size()) {
+      Place(position, last);
+      Restore(position);
+    }
+  }
+
+  std::vector<Slot> heap_;
+  std::vector<Entry> entries_;
+  std::vector<size_t> free_;
+  std::unordered_map<Key, size_t, Hasher> index_;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_COMMON_EXPIRYHEAP_H_
@@ -2,6 +2,9 @@
 #define TRANSACTIONS_SOURCE_MODEL_COMMON_FILEMANAGER_H_
 
 #include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 #include "model/common/basestorage.h"
 
@@ -30,6 +33,9 @@ class FileManager {
     return std::pair(true, counter);
   }
 
+  // The records are counted in one cheap pass, so the storage can pre-size
+  // itself. Engines that bulk-load get them in one batch, the others have
+  // them inserted while the file is parsed.
   template <typename Key, typename Value>
   static std::pair<bool, size_t> ImportFromDat(BaseStorage<Key, Value>& storage,
                                                const std::string& filename) {
@@ -41,6 +47,17 @@ class FileManager {
       return std::pair(false, 0);
     }
 
+    size_t count = CountRecords(file);
+    storage.Reserve(count);
+    if (storage.HasBulkLoad()) {
+      std::vector<std::pair<Key, Value>> records;
+      records.reserve(count);
+      while (file >> key && file >> value) {
+        records.emplace_back(key, value);
+      }
+      return std::pair(true, storage.SetBatch(std::move(records)));
+    }
+
     size_t counter = 0;
     while (file >> key && file >> value) {
       if (storage.Set(key, value)) {
@@ -50,8 +67,28 @@ class FileManager {
 
     return std::pair(true, counter);
   }
+
+ private:
+  // Every record is written on its own line, so one cheap pass over the
+  // file gives the record count before anything is parsed.
+  static size_t CountRecords(std::ifstream& file) {
+    size_t count = 0;
+    char last = '\n';
+    for (auto it = std::istreambuf_iterator<char>(file);
+         it != std::istreambuf_iterator<char>(); ++it) {
+      last = *it;
+      count += last == '\n';
+    }
+    if (last != '\n') {
+      ++count;
+    }
+
+    file.clear();
+    file.seekg(0);
+    return count;
+  }
 };
 
 }  // namespace s21
 
-#endif  // TRANSACTIONS_SOURCE_MODEL_COMMON_FILEMANAGER_H_
\ No newline at end of file
+#endif  // TRANSACTIONS_SOURCE_MODEL_COMMON_FILEMANAGER_H_
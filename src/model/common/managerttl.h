@@ -1,15 +1,16 @@
 #ifndef TRANSACTIONS_SOURCE_MODEL_COMMON_MANAGERTTL_H_
 #define TRANSACTIONS_SOURCE_MODEL_COMMON_MANAGERTTL_H_
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <functional>
-#include <list>
-#include <map>
+#include <limits>
 #include <mutex>
 
 #include "model/common/basestorage.h"
+#include "model/common/expiryheap.h"
 
 namespace s21 {
 
@@ -26,6 +27,9 @@ class ManagerTTL {
         : key(key),
           death_time(std::chrono::seconds(ttl) +
                      std::chrono::steady_clock::now()) {}
+
+    Record(Key key, std::chrono::milliseconds ttl)
+        : key(key), death_time(ttl + std::chrono::steady_clock::now()) {}
   };
 
   explicit ManagerTTL(BaseStorage<Key, Value>& storage) : storage_(storage) {}
@@ -36,59 +40,100 @@ class ManagerTTL {
     }
 
     std::unique_lock lock(records_mtx_);
-    auto it = records_.begin();
-    while (it != records_.end() && it->death_time < record.death_time) {
-      ++it;
+    records_.Push(record.key, record.death_time);
+    UpdateNextDeathTime();
+  }
+
+  // Removes up to limit expired records, earliest first, and returns
+  // their number.
+  size_t DeleteExpiredRecords(
+      size_t limit = std::numeric_limits<size_t>::max()) {
+    auto now = std::chrono::steady_clock::now();
+    if (now.time_since_epoch().count() < next_death_time_.load()) {
+      return 0;
     }
 
-    records_.insert(it, record);
-    ttl_info_[record.key] = record.death_time;
+    std::unique_lock lock(storage_mtx_, std::defer_lock);
+    if (!storage_.IsThreadSafe()) {
+      lock.lock();
+    }
+    std::unique_lock lock2(records_mtx_);
+
+    size_t removed = 0;
+    while (removed < limit && !records_.IsEmpty() &&
+           records_.GetTopTime() <= now) {
+      storage_.Del(records_.GetTopKey());
+      records_.Pop();
+      ++removed;
+    }
+    UpdateNextDeathTime();
+    return removed;
   }
 
-  void DeleteExpiredRecords() {
-    std::unique_lock lock(storage_mtx_);
-    std::unique_lock lock2(records_mtx_);
+  // Removes key if its TTL has run out. Other expired keys are left to
+  // the collector, so an access never pays for them.
+  void ExpireRecord(const Key& key) {
     auto now = std::chrono::steady_clock::now();
+    if (now.time_since_epoch().count() < next_death_time_.load()) {
+      return;
+    }
+    if (!IsExpired(key, now)) {
+      return;
+    }
 
-    while (!records_.empty() && records_.begin()->death_time <= now) {
-      storage_.Del(records_.begin()->key);
-      ttl_info_[records_.begin()->key] = records_.begin()->death_time;
-      records_.erase(records_.begin());
+    std::unique_lock lock(storage_mtx_, std::defer_lock);
+    if (!storage_.IsThreadSafe()) {
+      lock.lock();
+    }
+    std::unique_lock lock2(records_mtx_);
+    auto death_time = records_.Find(key);
+    if (death_time && *death_time <= now) {
+      storage_.Del(key);
+      records_.Erase(key);
+      UpdateNextDeathTime();
     }
   }
 
   void RenameRecord(const Key& key, const Key& new_key) {
     std::unique_lock lock_2(records_mtx_);
-
-    for (auto it = records_.begin(); it != records_.end(); ++it) {
-      if (it->key == key) {
-        ttl_info_[new_key] = (it->death_time);
-        ttl_info_.erase(it->key);
-        it->key = new_key;
-      }
-    }
+    records_.Rename(key, new_key);
   }
 
   void DeleteRecord(const Key& key) {
     std::unique_lock lock_2(records_mtx_);
+    records_.Erase(key);
+    UpdateNextDeathTime();
+  }
 
-    for (auto it = records_.begin(); it != records_.end(); ++it) {
-      if (it->key == key) {
-        ttl_info_.erase(it->key);
-        records_.erase(it);
-        break;
-      }
-    }
+  template <typename Predicate>
+  void DeleteRecordsIf(Predicate matches) {
+    std::unique_lock lock_2(records_mtx_);
+    records_.EraseIf(matches);
+    UpdateNextDeathTime();
   }
 
+  // Each round removes at most kExpiryBatch records, so the locks are
+  // released between rounds. While more than kBusyRatio of a batch turns
+  // out expired the collector comes back after kMinPause, otherwise it
+  // sleeps until the earliest expiry, at most sleep_time.
   void StartManagerLoop(std::chrono::seconds sleep_time) {
+    using namespace std::chrono;
+
     running_collector_.store(true);
     while (running_collector_.load()) {
-      DeleteExpiredRecords();
+      size_t removed = DeleteExpiredRecords(kExpiryBatch);
+
+      steady_clock::duration pause = kMinPause;
+      if (removed <= kExpiryBatch * kBusyRatio) {
+        auto next = steady_clock::duration(next_death_time_.load());
+        auto until_next = next - steady_clock::now().time_since_epoch();
+        pause = std::clamp<steady_clock::duration>(until_next, kMinPause,
+                                                   sleep_time);
+      }
 
       std::mutex temp;
       std::unique_lock lock(temp);
-      loop_condition_.wait_for(lock, sleep_time);
+      loop_condition_.wait_for(lock, pause);
     }
   }
 
@@ -100,31 +145,66 @@ class ManagerTTL {
   size_t GetTTL(const Key& key) {
     using namespace std::chrono;
 
-    auto elem = ttl_info_.find(key);
-    if (elem == ttl_info_.end()) {
+    std::unique_lock lock(records_mtx_);
+    auto death_time = records_.Find(key);
+    if (!death_time) {
       return 0;
     }
 
     int time_diff =
-        duration_cast<seconds>(elem->second - steady_clock::now()).count();
+        duration_cast<seconds>(*death_time - steady_clock::now()).count();
 
     return time_diff < 0 ? 0 : static_cast<size_t>(time_diff);
   }
 
+  // Operations over the whole storage drop every expired record first.
   template <typename Func, typename... Args>
   auto ExecuteStorageOperation(Func func, Args... args) {
     DeleteExpiredRecords();
-    std::unique_lock lock(storage_mtx_);
-    auto result = std::invoke(func, storage_, std::forward<Args>(args)...);
+    std::unique_lock lock(storage_mtx_, std::defer_lock);
+    if (!storage_.IsThreadSafe()) {
+      lock.lock();
+    }
+    return std::invoke(func, storage_, std::forward<Args>(args)...);
+  }
 
-    return result;
+  // Operations on one key only expire that key.
+  template <typename Func, typename... Args>
+  auto ExecuteKeyOperation(const Key& key, Func func, Args... args) {
+    ExpireRecord(key);
+    std::unique_lock lock(storage_mtx_, std::defer_lock);
+    if (!storage_.IsThreadSafe()) {
+      lock.lock();
+    }
+    return std::invoke(func, storage_, std::forward<Args>(args)...);
   }
 
  private:
+  using rep_type = typename time_type::duration::rep;
+
+  static constexpr size_t kExpiryBatch = 64;
+  static constexpr double kBusyRatio = 0.25;
+  static constexpr std::chrono::milliseconds kMinPause{10};
+
+  bool IsExpired(const Key& key, time_type now) {
+    std::unique_lock lock(records_mtx_);
+    auto death_time = records_.Find(key);
+    return death_time && *death_time <= now;
+  }
+
+  // Lets every operation skip both mutexes until the earliest record dies.
+  void UpdateNextDeathTime() {
+    next_death_time_.store(
+        records_.IsEmpty()
+            ? std::numeric_limits<rep_type>::max()
+            : records_.GetTopTime().time_since_epoch().count());
+  }
+
   BaseStorage<Key, Value>& storage_;
-  std::list<Record> records_;
-  std::map<Key, time_type> ttl_info_;
+  ExpiryHeap<Key> records_;
 
+  std::atomic<rep_type> next_death_time_ =
+      std::numeric_limits<rep_type>::max();
   std::atomic<bool> running_collector_ = false;
   std::condition_variable loop_condition_;
   std::mutex storage_mtx_;
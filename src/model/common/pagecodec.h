@@ -0,0 +1,88 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_COMMON_PAGECODEC_H_
+#define TRANSACTIONS_SOURCE_MODEL_COMMON_PAGECODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace s21 {
+
+inline char* WriteBytes(char* out, const std::string& bytes) {
+  uint32_t size = static_cast<uint32_t>(bytes.size());
+  std::memcpy(out, &size, sizeof(size));
+  std::memcpy(out + sizeof(size), bytes.data(), bytes.size());
+  return out + sizeof(size) + bytes.size();
+}
+
+inline const char* ReadBytes(const char* in, std::string& bytes) {
+  uint32_t size;
+  std::memcpy(&size, in, sizeof(size));
+  bytes.assign(in + sizeof(size), size);
+  return in + sizeof(size) + size;
+}
+
+// Byte layout of a key or a value inside a page. Arithmetic types are
+// stored as they are in memory and strings with their length. Other types
+// are stored in the text form of their stream operators, the one .dat
+// files use.
+template <typename T, typename = void>
+struct PageCodec {
+  static size_t Size(const T& value) {
+    return sizeof(uint32_t) + ToText(value).size();
+  }
+
+  static char* Write(char* out, const T& value) {
+    return WriteBytes(out, ToText(value));
+  }
+
+  static const char* Read(const char* in, T& value) {
+    std::string text;
+    in = ReadBytes(in, text);
+    std::istringstream stream(text);
+    stream >> value;
+    return in;
+  }
+
+  static std::string ToText(const T& value) {
+    std::ostringstream stream;
+    stream << value;
+    return stream.str();
+  }
+};
+
+template <typename T>
+struct PageCodec<T, std::enable_if_t<std::is_arithmetic_v<T>>> {
+  static size_t Size(const T&) { return sizeof(T); }
+
+  static char* Write(char* out, const T& value) {
+    std::memcpy(out, &value, sizeof(T));
+    return out + sizeof(T);
+  }
+
+  static const char* Read(const char* in, T& value) {
+    std::memcpy(&value, in, sizeof(T));
+    return in + sizeof(T);
+  }
+};
+
+template <>
+struct PageCodec<std::string> {
+  static size_t Size(const std::string& value) {
+    return sizeof(uint32_t) + value.size();
+  }
+
+  static char* Write(char* out, const std::string& value) {
+    return WriteBytes(out, value);
+  }
+
+  static const char* Read(const char* in, std::string& value) {
+    return ReadBytes(in, value);
+  }
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_COMMON_PAGECODEC_H_
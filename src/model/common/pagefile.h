@@ -0,0 +1,277 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_COMMON_PAGEFILE_H_
+#define TRANSACTIONS_SOURCE_MODEL_COMMON_PAGEFILE_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+namespace s21 {
+
+using PageId = uint32_t;
+
+// Page 0 holds the superblock, so no data page ever has id 0.
+inline constexpr PageId kNoPage = 0;
+
+// CRC-32C, the instruction and the table give the same values, so files
+// stay readable by builds without SSE4.2.
+inline uint32_t Crc32c(const void* data, size_t size) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  uint32_t crc = ~uint32_t{0};
+#if defined(__SSE4_2__)
+  uint64_t crc64 = crc;
+  for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+    bytes += sizeof(word);
+  }
+  crc = static_cast<uint32_t>(crc64);
+  for (; size > 0; --size) {
+    crc = _mm_crc32_u8(crc, *bytes++);
+  }
+#else
+  static const std::array<uint32_t, 256> kTable = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t value = i;
+      for (int bit = 0; bit < 8; ++bit) {
+        value = (value >> 1) ^ ((value & 1) != 0 ? 0x82F63B78u : 0);
+      }
+      table[i] = value;
+    }
+    return table;
+  }();
+  for (; size > 0; --size) {
+    crc = (crc >> 8) ^ kTable[(crc ^ *bytes++) & 0xFF];
+  }
+#endif
+  return ~crc;
+}
+
+// File of fixed-size pages mapped into memory. Every page starts with the
+// checksum of the rest of it, pages are sealed by whoever writes them and
+// verified on the way back. Released pages are chained into a free list.
+// The superblock keeps the page count, the free list, a root page and a
+// record count for the structure stored in the file, and is rewritten by
+// Sync only, so the file is consistent after Sync and there is no journal
+// to recover a crash in between.
+class PageFile {
+ public:
+  static constexpr size_t kPageSize = 4096;
+  static constexpr size_t kChecksumBytes = sizeof(uint32_t);
+  static constexpr size_t kMinMappedPages = 16;
+  static constexpr uint32_t kVersion = 1;
+
+  explicit PageFile(const std::string& path) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+      throw std::runtime_error("Cannot open " + path);
+    }
+    try {
+      Open(path);
+    } catch (...) {
+      Unmap();
+      ::close(fd_);
+      throw;
+    }
+  }
+
+  PageFile(const PageFile&) = delete;
+  PageFile& operator=(const PageFile&) = delete;
+
+  ~PageFile() {
+    WriteSuperblock();
+    Unmap();
+    ::close(fd_);
+  }
+
+  // True when the file has been created by this object.
+  bool IsNew() const { return created_; }
+
+  char* GetPage(PageId id) { return data_ + size_t{id} * kPageSize; }
+
+  const char* GetPage(PageId id) const {
+    return data_ + size_t{id} * kPageSize;
+  }
+
+  void Seal(PageId id) {
+    char* page = GetPage(id);
+    uint32_t checksum = Checksum(page);
+    std::memcpy(page, &checksum, sizeof(checksum));
+  }
+
+  void Verify(PageId id) const {
+    if (id == kNoPage || id >= page_count_) {
+      throw std::runtime_error("Page " + std::to_string(id) +
+                               " is out of the file");
+    }
+    const char* page = GetPage(id);
+    uint32_t checksum;
+    std::memcpy(&checksum, page, sizeof(checksum));
+    if (checksum != Checksum(page)) {
+      throw std::runtime_error("Page " + std::to_string(id) +
+                               " checksum mismatch");
+    }
+  }
+
+  // The page content is undefined, the caller writes and seals it.
+  PageId Allocate() {
+    if (free_head_ != kNoPage) {
+      PageId id = free_head_;
+      Verify(id);
+      std::memcpy(&free_head_, GetPage(id) + kChecksumBytes,
+                  sizeof(free_head_));
+      return id;
+    }
+    if (page_count_ == mapped_pages_) {
+      Remap(mapped_pages_ * 2);
+    }
+    return page_count_++;
+  }
+
+  void Free(PageId id) {
+    char* page = GetPage(id);
+    std::memset(page, 0, kPageSize);
+    std::memcpy(page + kChecksumBytes, &free_head_, sizeof(free_head_));
+    Seal(id);
+    free_head_ = id;
+  }
+
+  PageId GetRoot() const { return root_; }
+
+  void SetRoot(PageId root) { root_ = root; }
+
+  uint64_t GetRecordsCount() const { return records_; }
+
+  void SetRecordsCount(uint64_t records) { records_ = records; }
+
+  size_t GetPagesCount() const { return page_count_; }
+
+  // Pages reach the disk before the superblock that refers to them.
+  void Sync() {
+    ::msync(data_, mapped_pages_ * kPageSize, MS_SYNC);
+    WriteSuperblock();
+    ::msync(data_, kPageSize, MS_SYNC);
+  }
+
+ private:
+  struct Superblock {
+    char magic[8];
+    uint32_t version;
+    uint32_t page_size;
+    uint32_t page_count;
+    uint32_t free_head;
+    uint32_t root;
+    uint32_t reserved;
+    uint64_t records;
+  };
+
+  static constexpr char kMagic[8] = {'S', '2', '1', 'P', 'A', 'G', 'E', 'S'};
+
+  static uint32_t Checksum(const char* page) {
+    return Crc32c(page + kChecksumBytes, kPageSize - kChecksumBytes);
+  }
+
+  void Open(const std::string& path) {
+    struct stat info;
+    if (::fstat(fd_, &info) != 0) {
+      throw std::runtime_error("Cannot stat " + path);
+    }
+    size_t file_size = static_cast<size_t>(info.st_size);
+    if (file_size == 0) {
+      created_ = true;
+      Remap(kMinMappedPages);
+      WriteSuperblock();
+      return;
+    }
+    if (file_size % kPageSize != 0) {
+      throw std::runtime_error(path + " is not a page file");
+    }
+    Remap(file_size / kPageSize);
+    ReadSuperblock(path);
+  }
+
+  void ReadSuperblock(const std::string& path) {
+    Superblock superblock;
+    std::memcpy(&superblock, data_ + kChecksumBytes, sizeof(superblock));
+    if (std::memcmp(superblock.magic, kMagic, sizeof(kMagic)) != 0 ||
+        superblock.page_size != kPageSize) {
+      throw std::runtime_error(path + " is not a page file");
+    }
+    uint32_t checksum;
+    std::memcpy(&checksum, data_, sizeof(checksum));
+    if (checksum != Checksum(data_)) {
+      throw std::runtime_error(path + " superblock checksum mismatch");
+    }
+    if (superblock.version != kVersion ||
+        superblock.page_count > mapped_pages_) {
+      throw std::runtime_error(path + " has an unsupported layout");
+    }
+    page_count_ = superblock.page_count;
+    free_head_ = superblock.free_head;
+    root_ = superblock.root;
+    records_ = superblock.records;
+  }
+
+  void WriteSuperblock() {
+    Superblock superblock{};
+    std::memcpy(superblock.magic, kMagic, sizeof(kMagic));
+    superblock.version = kVersion;
+    superblock.page_size = kPageSize;
+    superblock.page_count = page_count_;
+    superblock.free_head = free_head_;
+    superblock.root = root_;
+    superblock.records = records_;
+    std::memset(data_, 0, kPageSize);
+    std::memcpy(data_ + kChecksumBytes, &superblock, sizeof(superblock));
+    Seal(0);
+  }
+
+  // Pages are addressed by id, so nothing outside keeps pointers into the
+  // mapping across an Allocate that may move it.
+  void Remap(size_t pages) {
+    Unmap();
+    if (::ftruncate(fd_, static_cast<off_t>(pages * kPageSize)) != 0) {
+      throw std::runtime_error("Cannot resize the page file");
+    }
+    void* data = ::mmap(nullptr, pages * kPageSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+      throw std::runtime_error("Cannot map the page file");
+    }
+    data_ = static_cast<char*>(data);
+    mapped_pages_ = pages;
+  }
+
+  void Unmap() {
+    if (data_ != nullptr) {
+      ::munmap(data_, mapped_pages_ * kPageSize);
+      data_ = nullptr;
+    }
+  }
+
+  int fd_ = -1;
+  char* data_ = nullptr;
+  size_t mapped_pages_ = 0;
+  uint32_t page_count_ = 1;
+  PageId free_head_ = kNoPage;
+  PageId root_ = kNoPage;
+  uint64_t records_ = 0;
+  bool created_ = false;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_COMMON_PAGEFILE_H_
@@ -0,0 +1,134 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_COMMON_SLABALLOCATOR_H_
+#define TRANSACTIONS_SOURCE_MODEL_COMMON_SLABALLOCATOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace s21 {
+
+enum class SlabPages {
+  kRegular,
+  kHuge,
+};
+
+// Hands out objects of one type from large slabs. Released objects go to a
+// free list kept inside their own slots and are reused first, so a
+// structure built from the allocator keeps its nodes packed together and
+// only calls malloc once per slab. Destroying the allocator releases every
+// slab at once, objects that are still alive are not destroyed.
+template <typename T>
+class SlabAllocator {
+ public:
+  static constexpr size_t kSlabBytes = size_t{64} << 10;
+  static constexpr size_t kHugeSlabBytes = size_t{2} << 20;
+  static constexpr size_t kMinSlabObjects = 8;
+
+  explicit SlabAllocator(SlabPages pages = SlabPages::kRegular)
+      : pages_(pages) {}
+
+  SlabAllocator(const SlabAllocator&) = delete;
+  SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+  SlabAllocator(SlabAllocator&& other) noexcept
+      : pages_(other.pages_),
+        slabs_(std::move(other.slabs_)),
+        free_(std::exchange(other.free_, nullptr)),
+        next_(std::exchange(other.next_, 0)),
+        allocated_(std::exchange(other.allocated_, 0)) {
+    other.slabs_.clear();
+  }
+
+  ~SlabAllocator() { Release(); }
+
+  template <typename... Args>
+  T* New(Args&&... args) {
+    return new (Allocate()) T(std::forward<Args>(args)...);
+  }
+
+  void Delete(T* object) {
+    object->~T();
+    Slot* slot = reinterpret_cast<Slot*>(object);
+    slot->next = free_;
+    free_ = slot;
+    --allocated_;
+  }
+
+  // Frees all slabs, the objects in them must have been destroyed or be
+  // trivially destructible.
+  void Release() {
+    for (void* slab : slabs_) {
+      std::free(slab);
+    }
+    slabs_.clear();
+    free_ = nullptr;
+    next_ = 0;
+    allocated_ = 0;
+  }
+
+  size_t GetAllocated() const { return allocated_; }
+
+  size_t GetSlabsCount() const { return slabs_.size(); }
+
+  static constexpr size_t GetObjectsPerSlab(SlabPages pages) {
+    size_t bytes = pages == SlabPages::kHuge ? kHugeSlabBytes : kSlabBytes;
+    return std::max(bytes / sizeof(Slot), kMinSlabObjects);
+  }
+
+ private:
+  union Slot {
+    Slot* next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  void* Allocate() {
+    ++allocated_;
+    if (free_ != nullptr) {
+      Slot* slot = free_;
+      free_ = slot->next;
+      return slot;
+    }
+    size_t per_slab = GetObjectsPerSlab(pages_);
+    if (slabs_.empty() || next_ == per_slab) {
+      AddSlab(per_slab * sizeof(Slot));
+      next_ = 0;
+    }
+    return static_cast<Slot*>(slabs_.back()) + next_++;
+  }
+
+  // Huge slabs are aligned to the huge page size and the kernel is asked
+  // to back them with huge pages, which it may decline.
+  void AddSlab(size_t bytes) {
+    size_t alignment = pages_ == SlabPages::kHuge ? kHugeSlabBytes : 64;
+    alignment = std::max(alignment, alignof(Slot));
+    bytes = (bytes + alignment - 1) / alignment * alignment;
+
+    void* slab = std::aligned_alloc(alignment, bytes);
+    if (slab == nullptr) {
+      throw std::bad_alloc();
+    }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (pages_ == SlabPages::kHuge) {
+      madvise(slab, bytes, MADV_HUGEPAGE);
+    }
+#endif
+    slabs_.push_back(slab);
+  }
+
+  SlabPages pages_;
+  std::vector<void*> slabs_;
+  Slot* free_ = nullptr;
+  size_t next_ = 0;
+  size_t allocated_ = 0;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_COMMON_SLABALLOCATOR_H_
@@ -0,0 +1,221 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_HASHTABLE_CONCURRENT_HASH_TABLE_H_
+#define TRANSACTIONS_SOURCE_MODEL_HASHTABLE_CONCURRENT_HASH_TABLE_H_
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+
+#include "model/common/basestorage.h"
+#include "model/hashtable/hash_table.h"
+#include "model/hashtable/seeded_hash.h"
+
+namespace s21 {
+
+// Lock-striped hash table: keys are spread over independent HashTable
+// segments, each guarded by its own reader-writer lock, so operations on
+// keys of different stripes run in parallel.
+template <typename Key, typename Value,
+          typename ValueEqual = std::equal_to<Value>,
+          typename Hasher = SeededHash<Key>>
+class ConcurrentHashTable : public BaseStorage<Key, Value> {
+ public:
+  using Segment = HashTable<Key, Value, ValueEqual, Hasher>;
+
+  static constexpr size_t kDefaultStripes = 16;
+
+  ConcurrentHashTable() : ConcurrentHashTable(kDefaultStripes) {}
+
+  explicit ConcurrentHashTable(size_t stripes)
+      : stripes_count_(RoundUpToPowerOfTwo(stripes)),
+        stripes_(std::make_unique<Stripe[]>(stripes_count_)) {}
+
+  ConcurrentHashTable(const ConcurrentHashTable& other)
+      : stripes_count_(other.stripes_count_),
+        stripes_(std::make_unique<Stripe[]>(stripes_count_)),
+        hasher_(other.hasher_) {
+    for (size_t i = 0; i < stripes_count_; ++i) {
+      std::shared_lock lock(other.stripes_[i].mtx);
+      stripes_[i].table = other.stripes_[i].table;
+    }
+  }
+
+  ConcurrentHashTable& operator=(const ConcurrentHashTable&) = delete;
+
+  ~ConcurrentHashTable() override = default;
+
+  bool IsThreadSafe() const override { return true; }
+
+  // Copies one stripe at a time, each under its shared lock.
+  std::unique_ptr<BaseStorage<Key, Value>> Clone() const override {
+    return std::make_unique<ConcurrentHashTable>(*this);
+  }
+
+  bool Set(const Key& key, const Value& value) override {
+    Stripe& stripe = GetStripe(key);
+    std::unique_lock lock(stripe.mtx);
+    return stripe.table.Set(key, value);
+  }
+
+  Value Get(const Key& key) const override {
+    const Stripe& stripe = GetStripe(key);
+    std::shared_lock lock(stripe.mtx);
+    return stripe.table.Get(key);
+  }
+
+  bool Exists(const Key& key) const override {
+    const Stripe& stripe = GetStripe(key);
+    std::shared_lock lock(stripe.mtx);
+    return stripe.table.Exists(key);
+  }
+
+  bool Del(const Key& key) override {
+    Stripe& stripe = GetStripe(key);
+    std::unique_lock lock(stripe.mtx);
+    return stripe.table.Del(key);
+  }
+
+  bool Update(const Key& key, const Value& value) override {
+    Stripe& stripe = GetStripe(key);
+    std::unique_lock lock(stripe.mtx);
+    return stripe.table.Update(key, value);
+  }
+
+  std::vector<Key> Keys() const override {
+    auto locks = LockAllShared();
+    std::vector<Key> result;
+
+    for (size_t i = 0; i < stripes_count_; ++i) {
+      std::vector<Key> keys = stripes_[i].table.Keys();
+      std::move(keys.begin(), keys.end(), std::back_inserter(result));
+    }
+
+    return result;
+  }
+
+  // Both stripes are locked in index order so concurrent renames in
+  // opposite directions cannot deadlock.
+  bool Rename(const Key& key, const Key& new_key) override {
+    size_t from = GetStripeIndex(key);
+    size_t to = GetStripeIndex(new_key);
+
+    if (from == to) {
+      std::unique_lock lock(stripes_[from].mtx);
+      return stripes_[from].table.Rename(key, new_key);
+    }
+
+    std::unique_lock first_lock(stripes_[std::min(from, to)].mtx);
+    std::unique_lock second_lock(stripes_[std::max(from, to)].mtx);
+    Segment& source = stripes_[from].table;
+    Segment& target = stripes_[to].table;
+    if (!source.Exists(key) || target.Exists(new_key)) {
+      return false;
+    }
+
+    target.Set(new_key, source.Get(key));
+    source.Del(key);
+    return true;
+  }
+
+  std::vector<Key> Find(const Value& value) const override {
+    auto locks = LockAllShared();
+    std::vector<Key> result;
+
+    for (size_t i = 0; i < stripes_count_; ++i) {
+      std::vector<Key> keys = stripes_[i].table.Find(value);
+      std::move(keys.begin(), keys.end(), std::back_inserter(result));
+    }
+
+    return result;
+  }
+
+  std::vector<Value> Showall() const override {
+    auto locks = LockAllShared();
+    std::vector<Value> result;
+
+    for (size_t i = 0; i < stripes_count_; ++i) {
+      std::vector<Value> values = stripes_[i].table.Showall();
+      std::move(values.begin(), values.end(), std::back_inserter(result));
+    }
+
+    return result;
+  }
+
+  // Keys are spread evenly over the stripes, so each one reserves its share.
+  void Reserve(size_t count) override {
+    size_t share = (count + stripes_count_ - 1) / stripes_count_;
+
+    for (size_t i = 0; i < stripes_count_; ++i) {
+      std::unique_lock lock(stripes_[i].mtx);
+      stripes_[i].table.Reserve(share);
+    }
+  }
+
+  void Compact() override {
+    for (size_t i = 0; i < stripes_count_; ++i) {
+      std::unique_lock lock(stripes_[i].mtx);
+      stripes_[i].table.Compact();
+    }
+  }
+
+  std::size_t GetSize() const {
+    auto locks = LockAllShared();
+    size_t size = 0;
+
+    for (size_t i = 0; i < stripes_count_; ++i) {
+      size += stripes_[i].table.GetSize();
+    }
+
+    return size;
+  }
+
+  std::size_t GetStripesCount() const { return stripes_count_; }
+
+ private:
+  // Each stripe sits on its own cache line so that writers of neighbouring
+  // stripes do not invalidate each other's lock word.
+  struct alignas(64) Stripe {
+    mutable std::shared_mutex mtx;
+    Segment table{RehashPolicy::kIncremental};
+  };
+
+  static size_t RoundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  // Segments take the low bits of the hash for their buckets, so stripes
+  // are selected by the high bits of a re-mixed hash.
+  size_t GetStripeIndex(const Key& key) const {
+    size_t hash = static_cast<size_t>(hasher_(key)) * 0x9E3779B97F4A7C15ULL;
+    return (hash >> 32) & (stripes_count_ - 1);
+  }
+
+  Stripe& GetStripe(const Key& key) { return stripes_[GetStripeIndex(key)]; }
+
+  const Stripe& GetStripe(const Key& key) const {
+    return stripes_[GetStripeIndex(key)];
+  }
+
+  std::vector<std::shared_lock<std::shared_mutex>> LockAllShared() const {
+    std::vector<std::shared_lock<std::shared_mutex>> locks;
+    locks.reserve(stripes_count_);
+
+    for (size_t i = 0; i < stripes_count_; ++i) {
+      locks.emplace_back(stripes_[i].mtx);
+    }
+
+    return locks;
+  }
+
+  size_t stripes_count_;
+  std::unique_ptr<Stripe[]> stripes_;
+  Hasher hasher_{};
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_HASHTABLE_CONCURRENT_HASH_TABLE_H_
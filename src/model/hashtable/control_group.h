@@ -0,0 +1,101 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_HASHTABLE_CONTROL_GROUP_H_
+#define TRANSACTIONS_SOURCE_MODEL_HASHTABLE_CONTROL_GROUP_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace s21 {
+
+using ctrl_t = int8_t;
+
+enum Ctrl : ctrl_t {
+  kEmpty = -128,
+  kDeleted = -2,
+};
+
+// Metadata bytes of a flat hash table are probed one group at a time. A full
+// slot stores the low 7 bits of its hash (H2), so a single vector compare
+// filters out almost every non-matching slot before touching the keys.
+class ControlGroup {
+ public:
+#if defined(__AVX2__)
+  static constexpr size_t kWidth = 32;
+  using Mask = uint32_t;
+
+  explicit ControlGroup(const ctrl_t* pos)
+      : ctrl_(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos))) {}
+
+  Mask Match(ctrl_t h2) const {
+    return static_cast<Mask>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl_)));
+  }
+
+  Mask MatchEmpty() const { return Match(Ctrl::kEmpty); }
+
+  Mask MatchEmptyOrDeleted() const {
+    return static_cast<Mask>(_mm256_movemask_epi8(ctrl_));
+  }
+
+ private:
+  __m256i ctrl_;
+#elif defined(__SSE2__)
+  static constexpr size_t kWidth = 16;
+  using Mask = uint32_t;
+
+  explicit ControlGroup(const ctrl_t* pos)
+      : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+  Mask Match(ctrl_t h2) const {
+    return static_cast<Mask>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+  }
+
+  Mask MatchEmpty() const { return Match(Ctrl::kEmpty); }
+
+  Mask MatchEmptyOrDeleted() const {
+    return static_cast<Mask>(_mm_movemask_epi8(ctrl_));
+  }
+
+ private:
+  __m128i ctrl_;
+#else
+  static constexpr size_t kWidth = 8;
+  using Mask = uint32_t;
+
+  explicit ControlGroup(const ctrl_t* pos) : ctrl_(pos) {}
+
+  Mask Match(ctrl_t h2) const {
+    Mask mask = 0;
+    for (size_t i = 0; i < kWidth; ++i) {
+      mask |= static_cast<Mask>(ctrl_[i] == h2) << i;
+    }
+    return mask;
+  }
+
+  Mask MatchEmpty() const { return Match(Ctrl::kEmpty); }
+
+  Mask MatchEmptyOrDeleted() const {
+    Mask mask = 0;
+    for (size_t i = 0; i < kWidth; ++i) {
+      mask |= static_cast<Mask>(ctrl_[i] < 0) << i;
+    }
+    return mask;
+  }
+
+ private:
+  const ctrl_t* ctrl_;
+#endif
+
+ public:
+  static size_t LowestBit(Mask mask) {
+    return static_cast<size_t>(__builtin_ctz(mask));
+  }
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_HASHTABLE_CONTROL_GROUP_H_
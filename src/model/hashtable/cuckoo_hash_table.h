@@ -0,0 +1,448 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_HASHTABLE_CUCKOO_HASH_TABLE_H_
+#define TRANSACTIONS_SOURCE_MODEL_HASHTABLE_CUCKOO_HASH_TABLE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "model/common/basestorage.h"
+#include "model/hashtable/seeded_hash.h"
+
+namespace s21 {
+
+// Bucketized cuckoo hashing: every key may live only in one of two buckets
+// of kSlotsPerBucket slots, so a lookup inspects at most 2 * kSlotsPerBucket
+// slots regardless of how keys cluster. Inserts move residents to their
+// alternative bucket when both candidates are full. Keys that cannot be
+// placed in a sparse table (i.e. identical hashes) go to a small stash that
+// is only scanned while it is non-empty.
+template <typename Key, typename Value,
+          typename ValueEqual = std::equal_to<Value>,
+          typename Hasher = SeededHash<Key>>
+class CuckooHashTable : public BaseStorage<Key, Value> {
+ public:
+  struct Slot {
+    Key key;
+    Value value;
+    size_t hash;
+  };
+
+  static constexpr size_t kSlotsPerBucket = 4;
+  static constexpr size_t kDefaultBuckets = 4;
+  static constexpr float kResizeCoeff = 0.9;
+  static constexpr float kStashCoeff = 0.5;
+  static constexpr float kShrinkCoeff = 0.125;
+  static constexpr size_t kMaxKicks = 256;
+  static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+  CuckooHashTable() = default;
+
+  ~CuckooHashTable() override { Destroy(); }
+
+  CuckooHashTable(const CuckooHashTable& other)
+      : tags_(other.tags_),
+        stash_(other.stash_),
+        size_(other.size_),
+        random_state_(other.random_state_),
+        hasher_(other.hasher_) {
+    if (tags_.empty()) {
+      return;
+    }
+
+    slots_ = allocator_.allocate(tags_.size());
+    for (size_t i = 0; i < tags_.size(); ++i) {
+      if (tags_[i] != kEmptyTag) {
+        SlotTraits::construct(allocator_, slots_ + i, other.slots_[i]);
+      }
+    }
+  }
+
+  CuckooHashTable(CuckooHashTable&& other) noexcept { swap(*this, other); }
+
+  CuckooHashTable& operator=(const CuckooHashTable& other) {
+    CuckooHashTable temp = CuckooHashTable(other);
+    swap(*this, temp);
+    return *this;
+  }
+
+  CuckooHashTable& operator=(CuckooHashTable&& other) noexcept {
+    Destroy();
+    swap(*this, other);
+    return *this;
+  }
+
+  std::unique_ptr<BaseStorage<Key, Value>> Clone() const override {
+    return std::make_unique<CuckooHashTable>(*this);
+  }
+
+  bool Set(const Key& key, const Value& value) override {
+    size_t hash = hasher_(key);
+    if (FindSlot(key, hash) != kNotFound) {
+      return false;
+    }
+
+    if (tags_.empty() ||
+        static_cast<float>(size_ + 1) > GetCapacity() * kResizeCoeff) {
+      Rehash(tags_.empty() ? kDefaultBuckets : 2 * GetBucketCount());
+    }
+
+    Slot slot{key, value, hash};
+    while (!Place(slot) && !Stash(slot)) {
+      Rehash(2 * GetBucketCount());
+    }
+    ++size_;
+
+    return true;
+  }
+
+  Value Get(const Key& key) const override {
+    size_t index = FindSlot(key, hasher_(key));
+    if (index != kNotFound) {
+      return GetSlot(index).value;
+    }
+
+    throw std::invalid_argument("Key is not exists");
+  }
+
+  bool Exists(const Key& key) const override {
+    return FindSlot(key, hasher_(key)) != kNotFound;
+  }
+
+  bool Del(const Key& key) override {
+    size_t index = FindSlot(key, hasher_(key));
+    if (index == kNotFound) {
+      return false;
+    }
+
+    EraseSlot(index);
+    ShrinkIfSparse();
+    return true;
+  }
+
+  bool Update(const Key& key, const Value& value) override {
+    size_t index = FindSlot(key, hasher_(key));
+    if (index == kNotFound) {
+      return false;
+    }
+
+    GetSlot(index).value = value;
+    return true;
+  }
+
+  std::vector<Key> Keys() const override {
+    std::vector<Key> result;
+    result.reserve(size_);
+
+    for (size_t i = 0; i < tags_.size(); ++i) {
+      if (tags_[i] != kEmptyTag) {
+        result.push_back(slots_[i].key);
+      }
+    }
+    for (const Slot& slot : stash_) {
+      result.push_back(slot.key);
+    }
+
+    return result;
+  }
+
+  bool Rename(const Key& key, const Key& new_key) override {
+    size_t index = FindSlot(key, hasher_(key));
+    if (index == kNotFound || Exists(new_key)) {
+      return false;
+    }
+
+    Value value = std::move(GetSlot(index).value);
+    EraseSlot(index);
+    return Set(new_key, value);
+  }
+
+  std::vector<Key> Find(const Value& value) const override {
+    std::vector<Key> result;
+    ValueEqual equal;
+
+    for (size_t i = 0; i < tags_.size(); ++i) {
+      if (tags_[i] != kEmptyTag && equal(slots_[i].value, value)) {
+        result.push_back(slots_[i].key);
+      }
+    }
+    for (const Slot& slot : stash_) {
+      if (equal(slot.value, value)) {
+        result.push_back(slot.key);
+      }
+    }
+
+    return result;
+  }
+
+  std::vector<Value> Showall() const override {
+    std::vector<Value> result;
+    result.reserve(size_);
+
+    for (size_t i = 0; i < tags_.size(); ++i) {
+      if (tags_[i] != kEmptyTag) {
+        result.push_back(slots_[i].value);
+      }
+    }
+    for (const Slot& slot : stash_) {
+      result.push_back(slot.value);
+    }
+
+    return result;
+  }
+
+  void Reserve(size_t count) override {
+    size_t bucket_count = GetFitBucketCount(size_ + count);
+    if (bucket_count > GetBucketCount()) {
+      Rehash(bucket_count);
+    }
+  }
+
+  void Compact() override {
+    if (size_ == 0) {
+      Destroy();
+    } else if (GetFitBucketCount(size_) < GetBucketCount()) {
+      Rehash(GetFitBucketCount(size_));
+    }
+    stash_.shrink_to_fit();
+  }
+
+  std::size_t GetSize() const { return size_; }
+
+  std::size_t GetCapacity() const { return tags_.size(); }
+
+  std::size_t GetStashSize() const { return stash_.size(); }
+
+  float GetLoadFactor() const {
+    return tags_.empty() ? 0 : static_cast<float>(size_) / tags_.size();
+  }
+
+ private:
+  using SlotTraits = std::allocator_traits<std::allocator<Slot>>;
+
+  static constexpr uint8_t kEmptyTag = 0;
+
+  // The tag is a non-zero byte of the hash, so an empty slot never matches
+  // and most mismatching keys are rejected without touching the slot.
+  static uint8_t GetTag(size_t hash) {
+    uint8_t tag = static_cast<uint8_t>(hash >> 56);
+    return tag == kEmptyTag ? 1 : tag;
+  }
+
+  size_t GetBucketCount() const { return tags_.size() / kSlotsPerBucket; }
+
+  size_t GetPrimaryBucket(size_t hash) const {
+    return hash & (GetBucketCount() - 1);
+  }
+
+  // The alternative bucket depends only on the current bucket and the tag,
+  // and applying it twice gives the original bucket back.
+  size_t GetAltBucket(size_t bucket, uint8_t tag) const {
+    size_t mask = GetBucketCount() - 1;
+    return bucket ^ (((tag * 0xC6A4A7935BD1E995ULL) & mask) | 1);
+  }
+
+  size_t FindInBucket(size_t bucket, const Key& key, size_t hash,
+                      uint8_t tag) const {
+    size_t offset = bucket * kSlotsPerBucket;
+    for (size_t i = offset; i < offset + kSlotsPerBucket; ++i) {
+      if (tags_[i] == tag && slots_[i].hash == hash && slots_[i].key == key) {
+        return i;
+      }
+    }
+    return kNotFound;
+  }
+
+  size_t FindSlot(const Key& key, size_t hash) const {
+    if (tags_.empty()) {
+      return kNotFound;
+    }
+
+    uint8_t tag = GetTag(hash);
+    size_t bucket = GetPrimaryBucket(hash);
+    size_t index = FindInBucket(bucket, key, hash, tag);
+    if (index == kNotFound) {
+      index = FindInBucket(GetAltBucket(bucket, tag), key, hash, tag);
+    }
+    for (size_t i = 0; index == kNotFound && i < stash_.size(); ++i) {
+      if (stash_[i].hash == hash && stash_[i].key == key) {
+        index = tags_.size() + i;
+      }
+    }
+
+    return index;
+  }
+
+  // Indices past the slot array address the stash.
+  Slot& GetSlot(size_t index) {
+    return index < tags_.size() ? slots_[index] : stash_[index - tags_.size()];
+  }
+
+  const Slot& GetSlot(size_t index) const {
+    return index < tags_.size() ? slots_[index] : stash_[index - tags_.size()];
+  }
+
+  size_t FindEmptyInBucket(size_t bucket) const {
+    size_t offset = bucket * kSlotsPerBucket;
+    for (size_t i = offset; i < offset + kSlotsPerBucket; ++i) {
+      if (tags_[i] == kEmptyTag) {
+        return i;
+      }
+    }
+    return kNotFound;
+  }
+
+  void Construct(size_t index, Slot&& slot) {
+    SlotTraits::construct(allocator_, slots_ + index, std::move(slot));
+    tags_[index] = GetTag(slots_[index].hash);
+  }
+
+  // Random-walk cuckoo insertion. On failure `slot` holds the entry evicted
+  // last, which still has to be placed after the table grows.
+  bool Place(Slot& slot) {
+    uint8_t tag = GetTag(slot.hash);
+    size_t bucket = GetPrimaryBucket(slot.hash);
+    size_t index = FindEmptyInBucket(bucket);
+    if (index == kNotFound) {
+      bucket = GetAltBucket(bucket, tag);
+      index = FindEmptyInBucket(bucket);
+    }
+
+    for (size_t kick = 0; index == kNotFound && kick < kMaxKicks; ++kick) {
+      size_t victim = bucket * kSlotsPerBucket + NextRandom() % kSlotsPerBucket;
+      std::swap(slots_[victim], slot);
+      tags_[victim] = tag;
+
+      tag = GetTag(slot.hash);
+      bucket = GetAltBucket(bucket, tag);
+      index = FindEmptyInBucket(bucket);
+    }
+
+    if (index == kNotFound) {
+      return false;
+    }
+
+    Construct(index, std::move(slot));
+    return true;
+  }
+
+  // Growing does not help when the table is still sparse: the key collides
+  // with too many others on both of its buckets.
+  bool Stash(Slot& slot) {
+    if (GetLoadFactor() >= kStashCoeff) {
+      return false;
+    }
+
+    stash_.push_back(std::move(slot));
+    return true;
+  }
+
+  void EraseSlot(size_t index) {
+    if (index < tags_.size()) {
+      SlotTraits::destroy(allocator_, slots_ + index);
+      tags_[index] = kEmptyTag;
+    } else {
+      stash_.erase(stash_.begin() + (index - tags_.size()));
+    }
+    --size_;
+  }
+
+  static size_t GetFitBucketCount(size_t count) {
+    size_t bucket_count = kDefaultBuckets;
+    while (static_cast<float>(count) >
+           bucket_count * kSlotsPerBucket * kResizeCoeff) {
+      bucket_count *= 2;
+    }
+    return bucket_count;
+  }
+
+  // Halves the bucket count once under an eighth of the slots are used,
+  // the rehash doubles it back if the keys do not fit.
+  void ShrinkIfSparse() {
+    if (GetBucketCount() > kDefaultBuckets &&
+        static_cast<float>(size_) < GetCapacity() * kShrinkCoeff) {
+      Rehash(GetBucketCount() / 2);
+    }
+  }
+
+  void Rehash(size_t bucket_count) {
+    std::vector<Slot> items = Drain();
+    Allocate(bucket_count);
+
+    for (size_t i = 0; i < items.size(); ++i) {
+      Slot slot = std::move(items[i]);
+      if (!Place(slot) && !Stash(slot)) {
+        std::vector<Slot> rest = Drain();
+        rest.push_back(std::move(slot));
+        std::move(items.begin() + i + 1, items.end(), std::back_inserter(rest));
+        items = std::move(rest);
+        bucket_count *= 2;
+        Allocate(bucket_count);
+        i = static_cast<size_t>(-1);
+      }
+    }
+  }
+
+  std::vector<Slot> Drain() {
+    std::vector<Slot> items = std::move(stash_);
+    items.reserve(size_);
+    stash_.clear();
+
+    for (size_t i = 0; i < tags_.size(); ++i) {
+      if (tags_[i] != kEmptyTag) {
+        items.push_back(std::move(slots_[i]));
+        SlotTraits::destroy(allocator_, slots_ + i);
+      }
+    }
+    if (slots_ != nullptr) {
+      allocator_.deallocate(slots_, tags_.size());
+    }
+    slots_ = nullptr;
+    tags_.clear();
+
+    return items;
+  }
+
+  void Allocate(size_t bucket_count) {
+    tags_.assign(bucket_count * kSlotsPerBucket, kEmptyTag);
+    tags_.shrink_to_fit();
+    slots_ = allocator_.allocate(tags_.size());
+  }
+
+  void Destroy() {
+    Drain();
+    size_ = 0;
+  }
+
+  size_t NextRandom() {
+    random_state_ ^= random_state_ << 13;
+    random_state_ ^= random_state_ >> 7;
+    random_state_ ^= random_state_ << 17;
+    return static_cast<size_t>(random_state_);
+  }
+
+  friend void swap(CuckooHashTable& first, CuckooHashTable& second) noexcept {
+    using std::swap;
+
+    swap(first.tags_, second.tags_);
+    swap(first.stash_, second.stash_);
+    swap(first.slots_, second.slots_);
+    swap(first.size_, second.size_);
+    swap(first.random_state_, second.random_state_);
+    swap(first.hasher_, second.hasher_);
+    swap(first.allocator_, second.allocator_);
+  }
+
+  std::vector<uint8_t> tags_{};
+  std::vector<Slot> stash_{};
+  Slot* slots_ = nullptr;
+  size_t size_ = 0;
+  uint64_t random_state_ = 0x9E3779B97F4A7C15ULL;
+  Hasher hasher_{};
+  std::allocator<Slot> allocator_{};
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_HASHTABLE_CUCKOO_HASH_TABLE_H_
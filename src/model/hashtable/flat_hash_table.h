@@ -0,0 +1,386 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_HASHTABLE_FLAT_HASH_TABLE_H_
+#define TRANSACTIONS_SOURCE_MODEL_HASHTABLE_FLAT_HASH_TABLE_H_
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include "model/common/basestorage.h"
+#include "model/hashtable/control_group.h"
+#include "model/hashtable/seeded_hash.h"
+
+namespace s21 {
+
+// Open-addressing table in the spirit of Swiss tables: control bytes and
+// slots live in two contiguous arrays, so a lookup costs one metadata group
+// load plus, almost always, a single slot access.
+template <typename Key, typename Value,
+          typename ValueEqual = std::equal_to<Value>,
+          typename Hasher = SeededHash<Key>>
+class FlatHashTable : public BaseStorage<Key, Value> {
+ public:
+  struct Slot {
+    Key key;
+    Value value;
+  };
+
+  static constexpr size_t kGroupWidth = ControlGroup::kWidth;
+  static constexpr size_t kDefaultSize = kGroupWidth;
+  static constexpr float kResizeCoeff = 0.875;
+  static constexpr float kShrinkCoeff = 0.125;
+  static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+  FlatHashTable() = default;
+
+  ~FlatHashTable() override { Destroy(); }
+
+  FlatHashTable(const FlatHashTable& other)
+      : hasher_(other.hasher_), slot_allocator_(other.slot_allocator_) {
+    Allocate(other.capacity_);
+    if (capacity_ == 0) {
+      return;
+    }
+
+    std::memcpy(ctrl_, other.ctrl_, capacity_);
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (IsFull(ctrl_[i])) {
+        SlotTraits::construct(slot_allocator_, slots_ + i, other.slots_[i]);
+      }
+    }
+    size_ = other.size_;
+    deleted_ = other.deleted_;
+  }
+
+  FlatHashTable(FlatHashTable&& other) noexcept { swap(*this, other); }
+
+  FlatHashTable& operator=(const FlatHashTable& other) {
+    FlatHashTable temp = FlatHashTable(other);
+    swap(*this, temp);
+    return *this;
+  }
+
+  FlatHashTable& operator=(FlatHashTable&& other) noexcept {
+    Destroy();
+    swap(*this, other);
+    return *this;
+  }
+
+  std::unique_ptr<BaseStorage<Key, Value>> Clone() const override {
+    return std::make_unique<FlatHashTable>(*this);
+  }
+
+  bool Set(const Key& key, const Value& value) override {
+    size_t hash = GetHash(key);
+    if (FindSlot(key, hash) != kNotFound) {
+      return false;
+    }
+
+    if (capacity_ == 0 ||
+        static_cast<float>(size_ + deleted_ + 1) > capacity_ * kResizeCoeff) {
+      Resize();
+    }
+
+    size_t index = FindInsertSlot(hash);
+    if (ctrl_[index] == Ctrl::kDeleted) {
+      --deleted_;
+    }
+    SlotTraits::construct(slot_allocator_, slots_ + index, Slot{key, value});
+    ctrl_[index] = GetH2(hash);
+    ++size_;
+
+    return true;
+  }
+
+  Value Get(const Key& key) const override {
+    size_t index = FindSlot(key, GetHash(key));
+    if (index != kNotFound) {
+      return slots_[index].value;
+    }
+
+    throw std::invalid_argument("Key is not exists");
+  }
+
+  bool Exists(const Key& key) const override {
+    return FindSlot(key, GetHash(key)) != kNotFound;
+  }
+
+  bool Del(const Key& key) override {
+    size_t index = FindSlot(key, GetHash(key));
+    if (index == kNotFound) {
+      return false;
+    }
+
+    EraseSlot(index);
+    ShrinkIfSparse();
+    return true;
+  }
+
+  bool Update(const Key& key, const Value& value) override {
+    size_t index = FindSlot(key, GetHash(key));
+    if (index == kNotFound) {
+      return false;
+    }
+
+    slots_[index].value = value;
+    return true;
+  }
+
+  std::vector<Key> Keys() const override {
+    std::vector<Key> result;
+    result.reserve(size_);
+
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (IsFull(ctrl_[i])) {
+        result.push_back(slots_[i].key);
+      }
+    }
+
+    return result;
+  }
+
+  bool Rename(const Key& key, const Key& new_key) override {
+    size_t index = FindSlot(key, GetHash(key));
+    if (index == kNotFound || Exists(new_key)) {
+      return false;
+    }
+
+    Value value = std::move(slots_[index].value);
+    EraseSlot(index);
+    return Set(new_key, value);
+  }
+
+  std::vector<Key> Find(const Value& value) const override {
+    std::vector<Key> result;
+    ValueEqual equal;
+
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (IsFull(ctrl_[i]) && equal(slots_[i].value, value)) {
+        result.push_back(slots_[i].key);
+      }
+    }
+
+    return result;
+  }
+
+  std::vector<Value> Showall() const override {
+    std::vector<Value> result;
+    result.reserve(size_);
+
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (IsFull(ctrl_[i])) {
+        result.push_back(slots_[i].value);
+      }
+    }
+
+    return result;
+  }
+
+  void Reserve(size_t count) override {
+    size_t new_capacity = GetFitCapacity(size_ + count);
+    if (new_capacity > capacity_) {
+      Rehash(new_capacity);
+    }
+  }
+
+  // Rehashing into the smallest fitting capacity also drops tombstones.
+  void Compact() override {
+    if (size_ == 0) {
+      Destroy();
+    } else if (GetFitCapacity(size_) < capacity_ || deleted_ > 0) {
+      Rehash(GetFitCapacity(size_));
+    }
+  }
+
+  std::size_t GetSize() const { return size_; }
+
+  std::size_t GetCapacity() const { return capacity_; }
+
+  float GetLoadFactor() const {
+    return capacity_ == 0 ? 0 : static_cast<float>(size_) / capacity_;
+  }
+
+ private:
+  using SlotTraits = std::allocator_traits<std::allocator<Slot>>;
+  using CtrlTraits = std::allocator_traits<std::allocator<ctrl_t>>;
+
+  static bool IsFull(ctrl_t ctrl) { return ctrl >= 0; }
+
+  static ctrl_t GetH2(size_t hash) { return static_cast<ctrl_t>(hash & 0x7F); }
+
+  static size_t GetH1(size_t hash) { return hash >> 7; }
+
+  size_t GetHash(const Key& key) const {
+    // Spread weak hashes (e.g. identity for integers) over all bits, since H1
+    // and H2 are taken from opposite ends of the word.
+    return static_cast<size_t>(hasher_(key)) * 0x9E3779B97F4A7C15ULL;
+  }
+
+  size_t GroupCount() const { return capacity_ / kGroupWidth; }
+
+  size_t FindSlot(const Key& key, size_t hash) const {
+    if (capacity_ == 0) {
+      return kNotFound;
+    }
+
+    size_t mask = GroupCount() - 1;
+    size_t group = GetH1(hash) & mask;
+    ctrl_t h2 = GetH2(hash);
+
+    for (size_t step = 0; step <= mask; ++step) {
+      size_t offset = group * kGroupWidth;
+      ControlGroup ctrl(ctrl_ + offset);
+
+      for (auto match = ctrl.Match(h2); match != 0; match &= match - 1) {
+        size_t index = offset + ControlGroup::LowestBit(match);
+        if (slots_[index].key == key) {
+          return index;
+        }
+      }
+
+      if (ctrl.MatchEmpty() != 0) {
+        return kNotFound;
+      }
+      group = (group + step + 1) & mask;
+    }
+
+    return kNotFound;
+  }
+
+  size_t FindInsertSlot(size_t hash) const {
+    size_t mask = GroupCount() - 1;
+    size_t group = GetH1(hash) & mask;
+
+    for (size_t step = 0;; ++step) {
+      size_t offset = group * kGroupWidth;
+      auto match = ControlGroup(ctrl_ + offset).MatchEmptyOrDeleted();
+      if (match != 0) {
+        return offset + ControlGroup::LowestBit(match);
+      }
+      group = (group + step + 1) & mask;
+    }
+  }
+
+  void EraseSlot(size_t index) {
+    SlotTraits::destroy(slot_allocator_, slots_ + index);
+    --size_;
+
+    // A probe only stops at a group that has an empty byte, so if this group
+    // already has one no probe sequence can pass through it and the slot may
+    // become empty instead of a tombstone.
+    size_t offset = index - index % kGroupWidth;
+    if (ControlGroup(ctrl_ + offset).MatchEmpty() != 0) {
+      ctrl_[index] = Ctrl::kEmpty;
+    } else {
+      ctrl_[index] = Ctrl::kDeleted;
+      ++deleted_;
+    }
+  }
+
+  static size_t GetFitCapacity(size_t count) {
+    size_t capacity = kDefaultSize;
+    while (static_cast<float>(count) > capacity * kResizeCoeff) {
+      capacity *= 2;
+    }
+    return capacity;
+  }
+
+  // Halves the capacity once it is above kDefaultSize and the load falls
+  // below kShrinkCoeff. The rehash also drops every tombstone.
+  void ShrinkIfSparse() {
+    if (capacity_ > kDefaultSize &&
+        static_cast<float>(size_) < capacity_ * kShrinkCoeff) {
+      Rehash(capacity_ / 2);
+    }
+  }
+
+  void Resize() {
+    size_t new_capacity = capacity_ == 0 ? kDefaultSize : capacity_;
+    if (static_cast<float>(size_ + 1) > new_capacity * kResizeCoeff / 2) {
+      new_capacity *= 2;
+    }
+    Rehash(new_capacity);
+  }
+
+  void Rehash(size_t new_capacity) {
+    ctrl_t* old_ctrl = ctrl_;
+    Slot* old_slots = slots_;
+    size_t old_capacity = capacity_;
+
+    Allocate(new_capacity);
+    for (size_t i = 0; i < old_capacity; ++i) {
+      if (IsFull(old_ctrl[i])) {
+        size_t hash = GetHash(old_slots[i].key);
+        size_t index = FindInsertSlot(hash);
+        SlotTraits::construct(slot_allocator_, slots_ + index,
+                              std::move(old_slots[i]));
+        SlotTraits::destroy(slot_allocator_, old_slots + i);
+        ctrl_[index] = GetH2(hash);
+      }
+    }
+    deleted_ = 0;
+
+    Deallocate(old_ctrl, old_slots, old_capacity);
+  }
+
+  void Allocate(size_t capacity) {
+    capacity_ = capacity;
+    if (capacity_ == 0) {
+      ctrl_ = nullptr;
+      slots_ = nullptr;
+      return;
+    }
+
+    ctrl_ = ctrl_allocator_.allocate(capacity_);
+    std::memset(ctrl_, Ctrl::kEmpty, capacity_);
+    slots_ = slot_allocator_.allocate(capacity_);
+  }
+
+  void Deallocate(ctrl_t* ctrl, Slot* slots, size_t capacity) {
+    if (capacity == 0) {
+      return;
+    }
+    ctrl_allocator_.deallocate(ctrl, capacity);
+    slot_allocator_.deallocate(slots, capacity);
+  }
+
+  void Destroy() {
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (IsFull(ctrl_[i])) {
+        SlotTraits::destroy(slot_allocator_, slots_ + i);
+      }
+    }
+    Deallocate(ctrl_, slots_, capacity_);
+
+    ctrl_ = nullptr;
+    slots_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+    deleted_ = 0;
+  }
+
+  friend void swap(FlatHashTable& first, FlatHashTable& second) noexcept {
+    using std::swap;
+
+    swap(first.capacity_, second.capacity_);
+    swap(first.size_, second.size_);
+    swap(first.deleted_, second.deleted_);
+    swap(first.ctrl_, second.ctrl_);
+    swap(first.slots_, second.slots_);
+    swap(first.hasher_, second.hasher_);
+    swap(first.ctrl_allocator_, second.ctrl_allocator_);
+    swap(first.slot_allocator_, second.slot_allocator_);
+  }
+
+  size_t capacity_ = 0;
+  size_t size_ = 0;
+  size_t deleted_ = 0;
+  ctrl_t* ctrl_ = nullptr;
+  Slot* slots_ = nullptr;
+  Hasher hasher_{};
+  std::allocator<ctrl_t> ctrl_allocator_{};
+  std::allocator<Slot> slot_allocator_{};
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_HASHTABLE_FLAT_HASH_TABLE_H_
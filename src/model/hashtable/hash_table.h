@@ -2,21 +2,34 @@
 #define TRANSACTIONS_SOURCE_MODEL_HASHTABLE_HASH_TABLE_H_
 
 #include <list>
+#include <memory>
 #include <stdexcept>
 
 #include "model/common/basestorage.h"
+#include "model/hashtable/seeded_hash.h"
 
 namespace s21 {
 
+enum class RehashPolicy {
+  kBlocking,
+  kIncremental,
+};
+
 template <typename Key, typename Value,
           typename ValueEqual = std::equal_to<Value>,
-          typename Hasher = std::hash<Key>>
+          typename Hasher = SeededHash<Key>>
 class HashTable : public BaseStorage<Key, Value> {
  public:
+  // Nodes of one bucket form a contiguous run in data_. While a rehash is in
+  // progress the old and the new table share the list, and the generation
+  // bit tells which table the run of a node belongs to. The full hash is
+  // kept so that resizes never call the hasher and chain walks compare keys
+  // only on a hash match.
   struct Node {
     Key key;
     Value value;
-    int cached;
+    size_t hash;
+    bool generation;
   };
 
   using iterator = typename std::list<Node>::iterator;
@@ -24,24 +37,44 @@ class HashTable : public BaseStorage<Key, Value> {
 
   static constexpr size_t kDefaultSize = 8;
   static constexpr float kResizeCoeff = 0.75;
-  static constexpr float kScaleCoeff = 2;
+  static constexpr float kShrinkCoeff = 0.125;
+  static constexpr size_t kScaleCoeff = 2;
+  static constexpr size_t kRehashStep = 8;
 
   HashTable() = default;
 
+  explicit HashTable(RehashPolicy policy) : policy_(policy) {}
+
   ~HashTable() override {
     allocator_.deallocate(bucket_pointers_, table_size_);
+    allocator_.deallocate(old_bucket_pointers_, old_table_size_);
   }
 
-  HashTable(const HashTable& other) : data_(other.data_) {
-    bucket_pointers_ = allocator_.allocate(other.table_size_);
-
-    for (std::size_t i = 0; i < other.table_size_; ++i) {
-      std::allocator_traits<decltype(allocator_)>::construct(
-          allocator_, &bucket_pointers_[i], data_.end());
+  HashTable(const HashTable& other)
+      : policy_(other.policy_),
+        table_size_(other.table_size_),
+        old_table_size_(other.old_table_size_),
+        rehash_index_(other.rehash_index_),
+        generation_(other.generation_),
+        data_(other.data_),
+        hasher_(other.hasher_) {
+    // An empty or compacted table has no bucket array, and Set relies on
+    // the null pointer to allocate one.
+    if (table_size_ != 0) {
+      bucket_pointers_ = AllocateBuckets(table_size_);
+    }
+    if (old_table_size_ != 0) {
+      old_bucket_pointers_ = AllocateBuckets(old_table_size_);
     }
 
     for (auto it = data_.begin(); it != data_.end(); ++it) {
-      bucket_pointers_[it->cached] = it;
+      bool is_new = it->generation == generation_;
+      iterator* buckets = is_new ? bucket_pointers_ : old_bucket_pointers_;
+      size_t size = is_new ? table_size_ : old_table_size_;
+      size_t index = it->hash & (size - 1);
+      if (buckets[index] == data_.end()) {
+        buckets[index] = it;
+      }
     }
   }
 
@@ -55,32 +88,43 @@ class HashTable : public BaseStorage<Key, Value> {
 
   HashTable& operator=(HashTable&& other) noexcept {
     allocator_.deallocate(bucket_pointers_, table_size_);
+    allocator_.deallocate(old_bucket_pointers_, old_table_size_);
     data_.clear();
     table_size_ = 0;
+    old_table_size_ = 0;
+    rehash_index_ = 0;
     bucket_pointers_ = nullptr;
+    old_bucket_pointers_ = nullptr;
 
     swap(*this, other);
     return *this;
   }
 
+  std::unique_ptr<BaseStorage<Key, Value>> Clone() const override {
+    return std::make_unique<HashTable>(*this);
+  }
+
   bool Set(const Key& key, const Value& value) override {
-    if (Exists(key)) {
+    size_t hash = hasher_(key);
+    if (GetNodePosition(key, GetBucket(hash)) != data_.end()) {
       return false;
     }
 
+    RehashStep();
     if (GetLoadFactor() >= kResizeCoeff || !bucket_pointers_) {
-      Resize();
+      Resize(table_size_ == 0 ? kDefaultSize : table_size_ * kScaleCoeff);
     }
 
-    int hash = GetHash(key, table_size_);
-    bucket_pointers_[hash] =
-        data_.insert(bucket_pointers_[hash], Node{key, value, hash});
+    Bucket bucket = GetBucket(hash);
+    bucket.table[bucket.index] =
+        data_.insert(bucket.table[bucket.index],
+                     Node{key, value, bucket.hash, bucket.generation});
 
     return true;
   }
 
   Value Get(const Key& key) const override {
-    auto pos = GetNodePosition(key, GetHash(key, table_size_));
+    auto pos = GetNodePosition(key, GetBucket(key));
     if (pos != data_.end()) {
       return pos->value;
     }
@@ -89,18 +133,21 @@ class HashTable : public BaseStorage<Key, Value> {
   }
 
   bool Exists(const Key& key) const override {
-    return GetNodePosition(key, GetHash(key, table_size_)) != data_.end();
+    return GetNodePosition(key, GetBucket(key)) != data_.end();
   }
 
   bool Del(const Key& key) override {
-    auto pos = GetNodePosition(key, GetHash(key, table_size_));
+    Bucket bucket = GetBucket(key);
+    auto pos = GetNodePosition(key, bucket);
     if (pos != data_.end()) {
-      if (bucket_pointers_[pos->cached]->key == key) {
-        bucket_pointers_[pos->cached] = pos->cached == std::next(pos)->cached
-                                            ? (std::next(pos))
-                                            : data_.end();
+      if (bucket.table[bucket.index] == pos) {
+        auto next = std::next(pos);
+        bucket.table[bucket.index] = IsInBucket(next, bucket) ? next
+                                                              : data_.end();
       }
       data_.erase(pos);
+      RehashStep();
+      ShrinkIfSparse();
       return true;
     }
 
@@ -108,7 +155,7 @@ class HashTable : public BaseStorage<Key, Value> {
   }
 
   bool Update(const Key& key, const Value& value) override {
-    auto pos = GetNodePosition(key, GetHash(key, table_size_));
+    auto pos = GetNodePosition(key, GetBucket(key));
     if (pos != data_.end()) {
       pos->value = value;
       return true;
@@ -128,7 +175,7 @@ class HashTable : public BaseStorage<Key, Value> {
   }
 
   bool Rename(const Key& key, const Key& new_key) override {
-    auto pos = GetNodePosition(key, GetHash(key, table_size_));
+    auto pos = GetNodePosition(key, GetBucket(key));
 
     if (pos != data_.end() && !Exists(new_key)) {
       Set(new_key, pos->value);
@@ -163,25 +210,80 @@ class HashTable : public BaseStorage<Key, Value> {
     return result;
   }
 
+  void Reserve(size_t count) override {
+    size_t new_size = GetFitTableSize(data_.size() + count);
+    if (new_size > table_size_) {
+      Resize(new_size);
+    }
+  }
+
+  void Compact() override {
+    FinishRehash();
+    if (data_.empty()) {
+      allocator_.deallocate(bucket_pointers_, table_size_);
+      bucket_pointers_ = nullptr;
+      table_size_ = 0;
+      return;
+    }
+
+    size_t new_size = GetFitTableSize(data_.size());
+    if (new_size < table_size_) {
+      Resize(new_size);
+      FinishRehash();
+    }
+  }
+
   std::size_t GetSize() const { return data_.size(); }
 
+  std::size_t GetBucketCount() const { return table_size_; }
+
   float GetLoadFactor() const {
-    return table_size_ == 0 ? 0 : data_.size() / table_size_;
+    return table_size_ == 0 ? 0
+                            : static_cast<float>(data_.size()) / table_size_;
   }
 
+  bool IsRehashing() const { return old_bucket_pointers_ != nullptr; }
+
  private:
-  size_t GetHash(const Key& value, size_t size) const {
-    return size == 1 ? 0 : hasher_(value) % (size - 1);
+  struct Bucket {
+    iterator* table;
+    size_t mask;
+    size_t index;
+    size_t hash;
+    bool generation;
+  };
+
+  // Old buckets below rehash_index_ have already been moved to the new
+  // table, the rest are still served from the old one. Table sizes are
+  // powers of two, so the bucket index is the masked hash.
+  Bucket GetBucket(const Key& key) const { return GetBucket(hasher_(key)); }
+
+  Bucket GetBucket(size_t hash) const {
+    if (IsRehashing()) {
+      size_t old_mask = old_table_size_ - 1;
+      if ((hash & old_mask) >= rehash_index_) {
+        return Bucket{old_bucket_pointers_, old_mask, hash & old_mask, hash,
+                      !generation_};
+      }
+    }
+
+    size_t mask = table_size_ == 0 ? 0 : table_size_ - 1;
+    return Bucket{bucket_pointers_, mask, hash & mask, hash, generation_};
+  }
+
+  bool IsInBucket(const_iterator it, const Bucket& bucket) const {
+    return it != data_.end() && (it->hash & bucket.mask) == bucket.index &&
+           it->generation == bucket.generation;
   }
 
-  const_iterator GetNodePosition(const Key& key, int hash) const {
-    if (bucket_pointers_ == nullptr) {
+  const_iterator GetNodePosition(const Key& key, const Bucket& bucket) const {
+    if (bucket.table == nullptr) {
       return data_.end();
     }
 
-    for (auto it = bucket_pointers_[hash];
-         it != data_.end() && it->cached == hash; ++it) {
-      if (it->key == key) {
+    for (const_iterator it = bucket.table[bucket.index];
+         IsInBucket(it, bucket); ++it) {
+      if (it->hash == bucket.hash && it->key == key) {
         return it;
       }
     }
@@ -189,14 +291,14 @@ class HashTable : public BaseStorage<Key, Value> {
     return data_.end();
   }
 
-  iterator GetNodePosition(const Key& key, int hash) {
-    if (bucket_pointers_ == nullptr) {
+  iterator GetNodePosition(const Key& key, const Bucket& bucket) {
+    if (bucket.table == nullptr) {
       return data_.end();
     }
 
-    for (auto it = bucket_pointers_[hash];
-         it != data_.end() && it->cached == hash; ++it) {
-      if (it->key == key) {
+    for (iterator it = bucket.table[bucket.index]; IsInBucket(it, bucket);
+         ++it) {
+      if (it->hash == bucket.hash && it->key == key) {
         return it;
       }
     }
@@ -204,46 +306,134 @@ class HashTable : public BaseStorage<Key, Value> {
     return data_.end();
   }
 
-  void Resize() {
-    size_t new_table_size =
-        table_size_ == 0 ? kDefaultSize : table_size_ * kScaleCoeff;
-    iterator* new_bucket_pointers = allocator_.allocate(new_table_size);
-    std::list<Node> temp;
-    std::swap(temp, data_);
+  static size_t GetFitTableSize(size_t count) {
+    size_t size = kDefaultSize;
+    while (static_cast<float>(count) >= size * kResizeCoeff) {
+      size *= kScaleCoeff;
+    }
+    return size;
+  }
 
-    for (std::size_t i = 0; i < new_table_size; ++i) {
-      std::allocator_traits<std::allocator<iterator>>::construct(
-          allocator_, &new_bucket_pointers[i], data_.end());
+  // The table is halved only far below the grow threshold, so a workload
+  // hovering around one size does not resize back and forth.
+  void ShrinkIfSparse() {
+    if (table_size_ > kDefaultSize && GetLoadFactor() < kShrinkCoeff) {
+      Resize(table_size_ / kScaleCoeff);
     }
+  }
 
-    for (auto it = temp.begin(); it != temp.end(); ++it) {
-      int new_hash = GetHash(it->key, new_table_size);
-      new_bucket_pointers[new_hash] = data_.insert(
-          new_bucket_pointers[new_hash], Node{it->key, it->value, new_hash});
+  void Resize(size_t new_size) {
+    FinishRehash();
+
+    old_table_size_ = table_size_;
+    old_bucket_pointers_ = bucket_pointers_;
+    rehash_index_ = 0;
+    generation_ = !generation_;
+
+    table_size_ = new_size;
+    bucket_pointers_ = AllocateBuckets(table_size_);
+
+    if (policy_ == RehashPolicy::kBlocking) {
+      FinishRehash();
     }
+  }
 
-    allocator_.deallocate(bucket_pointers_, table_size_);
-    bucket_pointers_ = std::move(new_bucket_pointers);
-    table_size_ = new_table_size;
+  void RehashStep() {
+    for (size_t i = 0; i < kRehashStep && IsRehashing(); ++i) {
+      MigrateBucket();
+    }
+  }
+
+  void FinishRehash() {
+    while (IsRehashing()) {
+      MigrateBucket();
+    }
+  }
+
+  // Nodes are spliced from the old run into the new buckets, so migration
+  // never copies keys or values and never allocates.
+  void MigrateBucket() {
+    Bucket old_bucket{old_bucket_pointers_, old_table_size_ - 1,
+                      rehash_index_, 0, !generation_};
+    size_t mask = table_size_ - 1;
+
+    for (iterator it = old_bucket_pointers_[rehash_index_];
+         IsInBucket(it, old_bucket);) {
+      iterator next = std::next(it);
+      size_t index = it->hash & mask;
+      it->generation = generation_;
+      data_.splice(bucket_pointers_[index], data_, it);
+      bucket_pointers_[index] = it;
+      it = next;
+    }
+
+    if (++rehash_index_ == old_table_size_) {
+      allocator_.deallocate(old_bucket_pointers_, old_table_size_);
+      old_bucket_pointers_ = nullptr;
+      old_table_size_ = 0;
+      rehash_index_ = 0;
+    }
+  }
+
+  iterator* AllocateBuckets(size_t size) {
+    iterator* buckets = allocator_.allocate(size);
+
+    for (std::size_t i = 0; i < size; ++i) {
+      std::allocator_traits<decltype(allocator_)>::construct(
+          allocator_, &buckets[i], data_.end());
+    }
+
+    return buckets;
+  }
+
+  // Empty buckets hold end() of the list they were built for, and the
+  // sentinel of std::list stays with the list object on swap.
+  void RelinkEmptyBuckets(const_iterator stale_end) {
+    for (size_t i = 0; i < table_size_; ++i) {
+      if (bucket_pointers_[i] == stale_end) {
+        bucket_pointers_[i] = data_.end();
+      }
+    }
+    for (size_t i = 0; old_bucket_pointers_ && i < old_table_size_; ++i) {
+      if (old_bucket_pointers_[i] == stale_end) {
+        old_bucket_pointers_[i] = data_.end();
+      }
+    }
   }
 
   friend void swap(HashTable& first, HashTable& second) noexcept {
     using std::swap;
 
+    const_iterator first_end = first.data_.end();
+    const_iterator second_end = second.data_.end();
+
+    swap(first.policy_, second.policy_);
     swap(first.table_size_, second.table_size_);
+    swap(first.old_table_size_, second.old_table_size_);
+    swap(first.rehash_index_, second.rehash_index_);
+    swap(first.generation_, second.generation_);
     swap(first.data_, second.data_);
     swap(first.bucket_pointers_, second.bucket_pointers_);
+    swap(first.old_bucket_pointers_, second.old_bucket_pointers_);
     swap(first.hasher_, second.hasher_);
     swap(first.allocator_, second.allocator_);
+
+    first.RelinkEmptyBuckets(second_end);
+    second.RelinkEmptyBuckets(first_end);
   }
 
+  RehashPolicy policy_ = RehashPolicy::kBlocking;
   size_t table_size_ = 0;
+  size_t old_table_size_ = 0;
+  size_t rehash_index_ = 0;
+  bool generation_ = false;
   std::list<Node> data_{};
   iterator* bucket_pointers_ = nullptr;
+  iterator* old_bucket_pointers_ = nullptr;
   Hasher hasher_{};
   std::allocator<iterator> allocator_{};
 };
 
 }  // namespace s21
 
-#endif  // TRANSACTIONS_SOURCE_MODEL_HASHTABLE_HASH_TABLE_H_
\ No newline at end of file
+#endif  // TRANSACTIONS_SOURCE_MODEL_HASHTABLE_HASH_TABLE_H_
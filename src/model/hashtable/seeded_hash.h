@@ -0,0 +1,194 @@
+#ifndef TRANSACTIONS_SOURCE_MODEL_HASHTABLE_SEEDED_HASH_H_
+#define TRANSACTIONS_SOURCE_MODEL_HASHTABLE_SEEDED_HASH_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace s21 {
+
+namespace hash_internal {
+
+inline constexpr uint64_t kSecret[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL,
+    0x4d5a2da51de1aa47ULL};
+
+// Full 64x64->128 multiplication, the low half is left in a and the high
+// half in b.
+inline void Multiply(uint64_t* a, uint64_t* b) {
+#if defined(__SIZEOF_INT128__)
+  __extension__ using uint128 = unsigned __int128;
+  uint128 product = static_cast<uint128>(*a) * *b;
+  *a = static_cast<uint64_t>(product);
+  *b = static_cast<uint64_t>(product >> 64);
+#else
+  uint64_t a_lo = *a & 0xFFFFFFFF, a_hi = *a >> 32;
+  uint64_t b_lo = *b & 0xFFFFFFFF, b_hi = *b >> 32;
+  uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+  uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+  uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+  *b = hi_hi + (hi_lo >> 32) + (cross >> 32);
+  *a = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+#endif
+}
+
+// Folded multiplication, the mixing primitive of wyhash.
+inline uint64_t Mix(uint64_t a, uint64_t b) {
+  Multiply(&a, &b);
+  return a ^ b;
+}
+
+inline uint64_t Read8(const uint8_t* p) {
+  uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint64_t Read4(const uint8_t* p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint64_t Read3(const uint8_t* p, size_t len) {
+  return (static_cast<uint64_t>(p[0]) << 16) |
+         (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+}
+
+// wyhash (final version 4): short inputs are read with at most two
+// overlapping loads, long ones in three independent 16-byte lanes.
+inline uint64_t HashBytes(const void* data, size_t len, uint64_t seed) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  seed ^= Mix(seed ^ kSecret[0], kSecret[1]);
+  uint64_t a = 0;
+  uint64_t b = 0;
+
+  if (len <= 16) {
+    if (len >= 4) {
+      size_t shift = (len >> 3) << 2;
+      a = (Read4(p) << 32) | Read4(p + shift);
+      b = (Read4(p + len - 4) << 32) | Read4(p + len - 4 - shift);
+    } else if (len > 0) {
+      a = Read3(p, len);
+    }
+  } else {
+    size_t i = len;
+    if (i > 48) {
+      uint64_t seed_1 = seed;
+      uint64_t seed_2 = seed;
+      do {
+        seed = Mix(Read8(p) ^ kSecret[1], Read8(p + 8) ^ seed);
+        seed_1 = Mix(Read8(p + 16) ^ kSecret[2], Read8(p + 24) ^ seed_1);
+        seed_2 = Mix(Read8(p + 32) ^ kSecret[3], Read8(p + 40) ^ seed_2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= seed_1 ^ seed_2;
+    }
+    while (i > 16) {
+      seed = Mix(Read8(p) ^ kSecret[1], Read8(p + 8) ^ seed);
+      p += 16;
+      i -= 16;
+    }
+    a = Read8(p + i - 16);
+    b = Read8(p + i - 8);
+  }
+
+  a ^= kSecret[1];
+  b ^= seed;
+  Multiply(&a, &b);
+  return Mix(a ^ kSecret[0] ^ len, b ^ kSecret[1]);
+}
+
+inline uint64_t HashWord(uint64_t value, uint64_t seed) {
+  uint64_t a = value ^ kSecret[0];
+  uint64_t b = seed ^ kSecret[1];
+  Multiply(&a, &b);
+  return Mix(a ^ kSecret[0], b ^ kSecret[1]);
+}
+
+// Every table gets its own seed, so keys that collide in one instance do not
+// collide in another and a crafted key set cannot degrade all of them.
+inline uint64_t NewSeed() {
+  static const uint64_t base = [] {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) ^ device();
+  }();
+  static std::atomic<uint64_t> counter{0};
+  return Mix(base ^ kSecret[2], ++counter ^ kSecret[3]);
+}
+
+}  // namespace hash_internal
+
+// Default hasher of the hash table engines. Integers and strings are hashed
+// directly with a seeded wyhash, other types fold their std::hash value
+// through the same seeded mixer.
+template <typename Key, typename = void>
+class SeededHash {
+ public:
+  SeededHash() = default;
+
+  explicit SeededHash(uint64_t seed) : seed_(seed) {}
+
+  size_t operator()(const Key& key) const {
+    return static_cast<size_t>(
+        hash_internal::HashWord(std::hash<Key>{}(key), seed_));
+  }
+
+  uint64_t GetSeed() const { return seed_; }
+
+ private:
+  uint64_t seed_ = hash_internal::NewSeed();
+};
+
+template <typename Key>
+class SeededHash<Key, std::enable_if_t<std::is_integral_v<Key> ||
+                                       std::is_enum_v<Key>>> {
+ public:
+  SeededHash() = default;
+
+  explicit SeededHash(uint64_t seed) : seed_(seed) {}
+
+  size_t operator()(Key key) const {
+    return static_cast<size_t>(
+        hash_internal::HashWord(static_cast<uint64_t>(key), seed_));
+  }
+
+  uint64_t GetSeed() const { return seed_; }
+
+ private:
+  uint64_t seed_ = hash_internal::NewSeed();
+};
+
+template <>
+class SeededHash<std::string_view> {
+ public:
+  SeededHash() = default;
+
+  explicit SeededHash(uint64_t seed) : seed_(seed) {}
+
+  size_t operator()(std::string_view key) const {
+    return static_cast<size_t>(
+        hash_internal::HashBytes(key.data(), key.size(), seed_));
+  }
+
+  uint64_t GetSeed() const { return seed_; }
+
+ private:
+  uint64_t seed_ = hash_internal::NewSeed();
+};
+
+template <>
+class SeededHash<std::string> : public SeededHash<std::string_view> {
+ public:
+  using SeededHash<std::string_view>::SeededHash;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SOURCE_MODEL_HASHTABLE_SEEDED_HASH_H_
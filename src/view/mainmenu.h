@@ -13,11 +13,15 @@ class MainMenu : public BaseView {
       {"1", {[this] { UseHashTable(); }, "use HashTable"}},
       {"2", {[this] { UseSBBST(); }, "use SBBST"}},
       {"3", {[this] { UseBPlusTree(); }, "use BPlusTree"}},
-      {"4", {[this] { PopMenu(); }, "exit"}}};
+      {"4", {[this] { UseCuckooHashTable(); }, "use CuckooHashTable"}},
+      {"5", {[this] { PopMenu(); }, "exit"}}};
 
   MainMenu(Controller<Key, Value>& hashtable, Controller<Key, Value>& sbbst,
-           Controller<Key, Value>& bplustree)
-      : hashtable_(hashtable), sbbst_(sbbst), bplustree_(bplustree) {}
+           Controller<Key, Value>& bplustree, Controller<Key, Value>& cuckoo)
+      : hashtable_(hashtable),
+        sbbst_(sbbst),
+        bplustree_(bplustree),
+        cuckoo_(cuckoo) {}
 
   void Start() override {
     PushMenu(kMainMenuCommands);
@@ -36,12 +40,17 @@ class MainMenu : public BaseView {
   Controller<Key, Value>& hashtable_;
   Controller<Key, Value>& sbbst_;
   Controller<Key, Value>& bplustree_;
+  Controller<Key, Value>& cuckoo_;
 
   void UseHashTable() const { StorageMenu<Key, Value>(hashtable_).Start(); }
 
   void UseSBBST() const { StorageMenu<Key, Value>(sbbst_).Start(); }
 
   void UseBPlusTree() const { StorageMenu<Key, Value>(bplustree_).Start(); }
+
+  void UseCuckooHashTable() const {
+    StorageMenu<Key, Value>(cuckoo_).Start();
+  }
 };
 
 }  // namespace s21
@@ -5,6 +5,7 @@
 #include "model/bplustree/b_plus_tree.h"
 #include "model/bst/self_balancing_binary_search_tree.h"
 #include "model/common/storagebenchmark.h"
+#include "model/hashtable/cuckoo_hash_table.h"
 #include "model/hashtable/hash_table.h"
 #include "view/baseview.h"
 
@@ -16,7 +17,8 @@ class StorageBenchmarkMenu : BaseView {
       {"1", {[this] { HashTable(); }, "hashtable benchmark"}},
       {"2", {[this] { BPlusTree(); }, "bplusTree benchmark"}},
       {"3", {[this] { SBBST(); }, "sbbst benchmark"}},
-      {"4", {[this] { PopMenu(); }, "exit"}}};
+      {"4", {[this] { CuckooHashTable(); }, "cuckoo hashtable benchmark"}},
+      {"5", {[this] { PopMenu(); }, "exit"}}};
 
   void Start() override {
     stack_menu_.push(kBenchmarkMenuCommands);
@@ -73,6 +75,14 @@ class StorageBenchmarkMenu : BaseView {
     MeasureTimeStorage(controller, input.first, input.second);
   }
 
+  void CuckooHashTable() {
+    s21::CuckooHashTable<Key, Value> cuckoo;
+    Controller controller(cuckoo);
+
+    auto input = InputCountAndRepeats();
+    MeasureTimeStorage(controller, input.first, input.second);
+  }
+
   std::pair<size_t, size_t> InputCountAndRepeats() {
     std::cout << "count: ";
     size_t count = parser_.ParseValue<int>(std::cin, "count");
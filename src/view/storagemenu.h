@@ -19,14 +19,21 @@ class StorageMenu : BaseView {
       {"get", {[this] { Get(); }, "<key>"}},
       {"exists", {[this] { Exists(); }, "<key>"}},
       {"del", {[this] { Del(); }, "<key>"}},
+      {"delrange", {[this] { DelRange(); }, "<key1> <key2>"}},
+      {"delprefix", {[this] { DelPrefix(); }, "<prefix>"}},
       {"update", {[this] { Update(); }, "<key> <value>"}},
       {"keys", {[this] { Keys(); }, ""}},
       {"rename", {[this] { Rename(); }, "<key1> <key2>"}},
       {"ttl", {[this] { TTL(); }, "<key>"}},
       {"find", {[this] { Find(); }, "<value>"}},
       {"showall", {[this] { Showall(); }, ""}},
+      {"range", {[this] { Range(); }, "<key1> <key2> [limit <count>]"}},
+      {"rank", {[this] { Rank(); }, "<key>"}},
+      {"select", {[this] { Select(); }, "<index>"}},
+      {"count", {[this] { CountRange(); }, "<key1> <key2>"}},
       {"upload", {[this] { Upload(); }, "<path>"}},
       {"export", {[this] { Export(); }, "<path>"}},
+      {"compact", {[this] { Compact(); }, ""}},
       {"help", {[this] { DisplayMenu(kStorageCommands); }, ""}},
       {"exit", {[this] { PopMenu(); }, ""}}};
 
@@ -96,6 +103,19 @@ class StorageMenu : BaseView {
               << std::endl;
   }
 
+  void DelRange() {
+    std::stringstream user_input = ReadInputAsStringStream();
+    Key from = parser_.ParseValue<Key>(user_input, "key1");
+    Key to = parser_.ParseValue<Key>(user_input, "key2");
+    std::cout << controller_.DelRange(from, to) << std::endl;
+  }
+
+  void DelPrefix() {
+    std::stringstream user_input = ReadInputAsStringStream();
+    Key prefix = parser_.ParseValue<Key>(user_input, "prefix");
+    std::cout << controller_.DelPrefix(prefix) << std::endl;
+  }
+
   void Update() {
     std::stringstream user_input = ReadInputAsStringStream();
     Key key = parser_.ParseValue<Key>(user_input, "key");
@@ -150,6 +170,46 @@ class StorageMenu : BaseView {
     }
   }
 
+  void Range() {
+    std::stringstream user_input = ReadInputAsStringStream();
+    Key from = parser_.ParseValue<Key>(user_input, "key1");
+    Key to = parser_.ParseValue<Key>(user_input, "key2");
+    auto limit = parser_.ParseOptionalArgument<size_t>(user_input, "limit");
+
+    auto records = limit.first.empty()
+                       ? controller_.Range(from, to)
+                       : controller_.Range(from, to, limit.second);
+
+    size_t counter = 1;
+    for (auto& [key, value] : records) {
+      std::cout << counter << ") " << key << " " << value << std::endl;
+      ++counter;
+    }
+  }
+
+  void Rank() {
+    std::stringstream user_input = ReadInputAsStringStream();
+    Key key = parser_.ParseValue<Key>(user_input, "key");
+    std::cout << controller_.Rank(key) << std::endl;
+  }
+
+  void Select() {
+    std::stringstream user_input = ReadInputAsStringStream();
+    size_t index = parser_.ParseValue<size_t>(user_input, "index");
+    try {
+      std::cout << controller_.Select(index) << std::endl;
+    } catch (std::out_of_range& ex) {
+      std::cout << "(null)" << std::endl;
+    }
+  }
+
+  void CountRange() {
+    std::stringstream user_input = ReadInputAsStringStream();
+    Key from = parser_.ParseValue<Key>(user_input, "key1");
+    Key to = parser_.ParseValue<Key>(user_input, "key2");
+    std::cout << controller_.CountRange(from, to) << std::endl;
+  }
+
   void Upload() {
     std::stringstream user_input = ReadInputAsStringStream();
     std::string path = parser_.ParseValue<std::string>(user_input, "path");
@@ -164,6 +224,11 @@ class StorageMenu : BaseView {
     std::cout << StatusToStr(res.first) << " " << res.second << std::endl;
   }
 
+  void Compact() {
+    controller_.Compact();
+    std::cout << StatusToStr(true) << std::endl;
+  }
+
   static std::string StatusToStr(bool status) {
     return status ? "OK" : "(null)";
   }
@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <map>
+#include <random>
+
 #include "common.h"
 #include "model/bplustree/b_plus_tree.h"
+#include "model/common/filemanager.h"
 #include "model/common/student.h"
 
 namespace s21 {
@@ -248,4 +253,735 @@ TEST(BPlusTreeShowAll, SomeElements) {
 
   ASSERT_EQ(values.size(), 3);
 }
+
+TEST(BPlusTreeCompact, KeepsRecords) {
+  BPlusTree<std::string, Student> tree;
+  Student student{"NAME", "SURNAME", 12, "CITY", 5555};
+  for (int i = 0; i < 5000; ++i) {
+    tree.Set("KEY" + std::to_string(i), student);
+  }
+  for (int i = 0; i < 5000; i += 3) {
+    tree.Del("KEY" + std::to_string(i));
+  }
+  std::vector<std::string> keys = tree.Keys();
+
+  tree.Compact();
+
+  ASSERT_EQ(tree.Keys(), keys);
+  ASSERT_EQ(tree.Get("KEY1"), student);
+  ASSERT_EQ(tree.Exists("KEY3"), false);
+}
+
+TEST(BPlusTreeScan, Window) {
+  BPlusTree<int, int> tree;
+  for (int i = 0; i < 1000; i += 2) {
+    tree.Set(i, i * 10);
+  }
+
+  auto records = tree.Scan(101, 120, 5);
+
+  ASSERT_EQ(records.size(), 5);
+  ASSERT_EQ(records.front(), std::make_pair(102, 1020));
+  ASSERT_EQ(records.back(), std::make_pair(110, 1100));
+  ASSERT_EQ(tree.Scan(101, 120, 100).size(), 10);
+  ASSERT_EQ(tree.Scan(2000, 3000, 100).empty(), true);
+  ASSERT_EQ(tree.Scan(120, 101, 100).empty(), true);
+}
+
+TEST(BPlusTreeCursor, SeekNextPrev) {
+  BPlusTree<int, int> tree;
+  for (int i = 0; i < 1000; ++i) {
+    tree.Set(i * 3, i);
+  }
+  auto cursor = tree.GetCursor();
+
+  cursor->Seek(301);
+  ASSERT_EQ(cursor->GetKey(), 303);
+  cursor->Prev();
+  ASSERT_EQ(cursor->GetKey(), 300);
+
+  int expected = 2997;
+  for (cursor->SeekToLast(); cursor->IsValid(); cursor->Prev()) {
+    ASSERT_EQ(cursor->GetKey(), expected);
+    expected -= 3;
+  }
+  ASSERT_EQ(expected, -3);
+
+  cursor->SeekToFirst();
+  ASSERT_EQ(cursor->GetValue(), 0);
+  cursor->Seek(2998);
+  ASSERT_EQ(cursor->IsValid(), false);
+}
+
+TEST(TreeBulkLoad, UnsortedBatchWithDuplicates) {
+  Tree<int, int, 2> tree;
+  std::vector<std::pair<int, int>> items;
+  for (int i = 0; i < 1000; ++i) {
+    items.emplace_back((i * 37) % 500, i);
+  }
+
+  ASSERT_EQ(tree.BulkLoad(items), 500);
+  ASSERT_EQ(tree.GetSize(), 500);
+
+  int expected = 0;
+  for (auto it = tree.Begin(); it != tree.End(); ++it, ++expected) {
+    ASSERT_EQ((*it).first, expected);
+    ASSERT_LT((*it).second, 500);
+  }
+  ASSERT_EQ(expected, 500);
+}
+
+TEST(TreeBulkLoad, MergesIntoExistingTree) {
+  Tree<int, int, 3> tree;
+  for (int i = 0; i < 300; i += 2) {
+    tree.Insert(i, -1);
+  }
+  std::vector<std::pair<int, int>> small = {{1, 1}, {2, 2}, {999, 999}};
+  std::vector<std::pair<int, int>> large;
+  for (int i = 0; i < 600; i += 3) {
+    large.emplace_back(i, i);
+  }
+
+  ASSERT_EQ(tree.BulkLoad(small), 2);
+  ASSERT_EQ(tree.BulkLoad(large), 150);
+  ASSERT_EQ(tree.GetSize(), 302);
+  ASSERT_EQ(tree.Search(2), -1);
+  ASSERT_EQ(tree.Search(3), 3);
+  ASSERT_EQ(tree.Search(999), 999);
+}
+
+TEST(TreeBulkLoad, OperationsAfterLoadWithFillFactor) {
+  for (float fill_factor : {0.1f, 0.5f, 0.7f, 1.0f}) {
+    Tree<int, int, 3> tree;
+    std::map<int, int> expected;
+    std::vector<std::pair<int, int>> items;
+    for (int i = 0; i < 2000; i += 2) {
+      items.emplace_back(i, i);
+      expected.emplace(i, i);
+    }
+    tree.BulkLoad(items, fill_factor);
+
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> key_dist(0, 2500);
+    for (int i = 0; i < 5000; ++i) {
+      int key = key_dist(gen);
+      if (i % 2 == 0) {
+        ASSERT_EQ(tree.Remove(key), expected.erase(key) == 1);
+      } else {
+        ASSERT_EQ(tree.Insert(key, i), expected.emplace(key, i).second);
+      }
+    }
+
+    ASSERT_EQ(tree.GetSize(), expected.size());
+    auto it = tree.Begin();
+    for (const auto& [key, value] : expected) {
+      ASSERT_EQ((*it).first, key);
+      ASSERT_EQ((*it).second, value);
+      ++it;
+    }
+  }
+}
+
+TEST(BPlusTreeSetBatch, ImportFromFile) {
+  BPlusTree<std::string, Student> tree;
+  tree.Set("ZZZ", Student{"NAME", "SURNAME", 12, "CITY", 5555});
+
+  auto result = FileManager::ImportFromDat(tree, kSamplesDir + "student.dat");
+
+  ASSERT_EQ(result.second, 20);
+  ASSERT_EQ(tree.GetSize(), 21);
+  ASSERT_EQ(tree.Keys().size(), 21);
+}
+
+TEST(TreeCompact, OperationsAfterCompact) {
+  Tree<int, int, 2> tree;
+  std::map<int, int> expected;
+  std::mt19937 gen(5);
+  std::uniform_int_distribution<int> key_dist(0, 500);
+
+  for (int round = 0; round < 20; ++round) {
+    for (int i = 0; i < 300; ++i) {
+      int key = key_dist(gen);
+      if (i % 3 == 0) {
+        ASSERT_EQ(tree.Remove(key), expected.erase(key) == 1);
+      } else {
+        ASSERT_EQ(tree.Insert(key, i), expected.emplace(key, i).second);
+      }
+    }
+    tree.Compact();
+
+    auto it = tree.Begin();
+    for (const auto& [key, value] : expected) {
+      ASSERT_EQ((*it).first, key);
+      ASSERT_EQ(tree.Search(key), value);
+      ++it;
+    }
+    ASSERT_EQ(it == tree.End(), true);
+  }
+}
+
+TEST(TreeStringKeys, SharedPrefixes) {
+  Tree<std::string, int, 2> tree;
+  std::map<std::string, int> expected;
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<int> key_dist(0, 400);
+
+  for (int i = 0; i < 4000; ++i) {
+    int number = key_dist(gen);
+    std::string key = number % 3 == 0 ? "SAME_PREFIX" + std::to_string(number)
+                                       : std::to_string(number);
+    key.resize(key.size() + number % 4, '\0');
+    if (i % 3 == 0) {
+      ASSERT_EQ(tree.Remove(key), expected.erase(key) == 1);
+    } else {
+      ASSERT_EQ(tree.Insert(key, i), expected.emplace(key, i).second);
+    }
+  }
+
+  ASSERT_EQ(tree.GetSize(), expected.size());
+  auto it = tree.Begin();
+  for (const auto& [key, value] : expected) {
+    ASSERT_EQ((*it).first, key);
+    ASSERT_EQ(tree.Search(key), value);
+    ++it;
+  }
+}
+
+TEST(TreeStringKeys, LongCommonPrefixes) {
+  Tree<std::string, int, 3> tree;
+  std::map<std::string, int> expected;
+  std::mt19937 gen(13);
+  std::uniform_int_distribution<int> dist(0, 999);
+  auto make_key = [](int number) {
+    return "tenant_" + std::to_string(number % 4) + "/2024-01-" +
+           std::to_string(10 + number % 7) + "/record_" +
+           std::to_string(number);
+  };
+
+  std::vector<std::pair<std::string, int>> batch;
+  for (int i = 0; i < 300; ++i) {
+    batch.emplace_back(make_key(i * 3), i);
+    expected.emplace(make_key(i * 3), i);
+  }
+  tree.BulkLoad(batch);
+  for (int i = 0; i < 6000; ++i) {
+    std::string key = make_key(dist(gen));
+    if (i % 3 == 0) {
+      ASSERT_EQ(tree.Remove(key), expected.erase(key) == 1);
+    } else {
+      ASSERT_EQ(tree.Insert(key, i), expected.emplace(key, i).second);
+    }
+    if (i % 2000 == 0) {
+      tree.Compact();
+    }
+  }
+
+  ASSERT_EQ(tree.GetSize(), expected.size());
+  auto cursor = tree.GetCursor();
+  cursor.SeekToLast();
+  for (auto it = expected.rbegin(); it != expected.rend(); ++it) {
+    ASSERT_EQ(cursor.GetKey(), it->first);
+    ASSERT_EQ(cursor.GetValue(), it->second);
+    cursor.Prev();
+  }
+  ASSERT_EQ(cursor.IsValid(), false);
+
+  auto window = tree.Scan("tenant_1/", "tenant_2", 10000);
+  auto first = expected.lower_bound("tenant_1/");
+  auto last = expected.upper_bound("tenant_2");
+  ASSERT_EQ(window.size(), std::distance(first, last));
+  for (const auto& [key, value] : window) {
+    ASSERT_EQ(key, first->first);
+    ASSERT_EQ(tree.Exists(key), true);
+    ASSERT_EQ(tree.Exists(key + "x"), expected.count(key + "x") == 1);
+    ++first;
+  }
+  ASSERT_EQ(tree.Exists("tenant_"), false);
+  ASSERT_EQ(tree.Exists("tenant_9"), false);
+}
+
+TEST(TreeFreeAtEmpty, DeleteBurstsMatchMap) {
+  Tree<int, int, 2> tree(RebalancePolicy::kFreeAtEmpty);
+  std::map<int, int> expected;
+  std::mt19937 gen(17);
+  std::uniform_int_distribution<int> key_dist(0, 3000);
+
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 1500; ++i) {
+      int key = key_dist(gen);
+      ASSERT_EQ(tree.Insert(key, i), expected.emplace(key, i).second);
+    }
+    int from = key_dist(gen);
+    for (int key = from; key < from + 800; ++key) {
+      ASSERT_EQ(tree.Remove(key), expected.erase(key) == 1);
+    }
+    if (round == 5) {
+      tree.Compact();
+    }
+
+    ASSERT_EQ(tree.GetSize(), expected.size());
+    auto it = tree.Begin();
+    for (const auto& [key, value] : expected) {
+      ASSERT_EQ((*it).first, key);
+      ASSERT_EQ(tree.Search(key), value);
+      ++it;
+    }
+    ASSERT_EQ(it == tree.End(), true);
+    auto cursor = tree.GetCursor();
+    cursor.SeekToLast();
+    for (auto rit = expected.rbegin(); rit != expected.rend(); ++rit) {
+      ASSERT_EQ(cursor.GetKey(), rit->first);
+      cursor.Prev();
+    }
+  }
+}
+
+TEST(TreeFreeAtEmpty, RemoveEverything) {
+  Tree<int, int, 2> tree(RebalancePolicy::kFreeAtEmpty);
+  for (int i = 0; i < 500; ++i) {
+    tree.Insert(i, i);
+  }
+  for (int i = 499; i >= 0; i -= 2) {
+    ASSERT_EQ(tree.Remove(i), true);
+  }
+  for (int i = 0; i < 500; i += 2) {
+    ASSERT_EQ(tree.Remove(i), true);
+  }
+
+  ASSERT_EQ(tree.GetSize(), 0);
+  ASSERT_EQ(tree.Begin() == tree.End(), true);
+  ASSERT_EQ(tree.Insert(7, 7), true);
+  ASSERT_EQ(tree.Search(7), 7);
+}
+
+TEST(BPlusTreeFreeAtEmpty, StorageOperations) {
+  BPlusTree<std::string, int> tree(RebalancePolicy::kFreeAtEmpty);
+  for (int i = 0; i < 1000; ++i) {
+    tree.Set("KEY" + std::to_string(i), i);
+  }
+  for (int i = 0; i < 1000; i += 3) {
+    ASSERT_EQ(tree.Del("KEY" + std::to_string(i)), true);
+  }
+
+  ASSERT_EQ(tree.Keys().size(), 666);
+  ASSERT_EQ(tree.Rename("KEY1", "KEY0"), true);
+  ASSERT_EQ(tree.Get("KEY0"), 1);
+}
+
+TEST(SlabAllocator, ReusesFreedSlots) {
+  SlabAllocator<std::string> allocator;
+  std::string* first = allocator.New("FIRST");
+  std::string* second = allocator.New("SECOND");
+  allocator.Delete(first);
+
+  ASSERT_EQ(allocator.GetAllocated(), 1);
+  ASSERT_EQ(allocator.New("THIRD"), first);
+  ASSERT_EQ(*second, "SECOND");
+  allocator.Delete(first);
+  allocator.Delete(second);
+
+  size_t per_slab = allocator.GetObjectsPerSlab(SlabPages::kRegular);
+  std::vector<std::string*> objects;
+  for (size_t i = 0; i <= per_slab; ++i) {
+    objects.push_back(allocator.New(std::to_string(i)));
+  }
+  ASSERT_EQ(allocator.GetSlabsCount(), 2);
+  for (std::string* object : objects) {
+    allocator.Delete(object);
+  }
+  allocator.Release();
+  ASSERT_EQ(allocator.GetSlabsCount(), 0);
+}
+
+TEST(TreeSlabs, HugePagesMatchMap) {
+  Tree<std::string, int, 2> tree(RebalancePolicy::kMerge, SlabPages::kHuge);
+  std::map<std::string, int> expected;
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<int> key_dist(0, 3000);
+
+  for (int i = 0; i < 20000; ++i) {
+    std::string key = "KEY" + std::to_string(key_dist(gen));
+    if (i % 3 == 0) {
+      ASSERT_EQ(tree.Remove(key), expected.erase(key) == 1);
+    } else {
+      ASSERT_EQ(tree.Insert(key, i), expected.emplace(key, i).second);
+    }
+  }
+
+  Tree<std::string, int, 2> moved(std::move(tree));
+  moved.Compact();
+  Tree<std::string, int, 2> copy(moved);
+  ASSERT_EQ(copy.GetSize(), expected.size());
+  auto it = expected.begin();
+  for (auto node = copy.Begin(); node != copy.End(); ++node, ++it) {
+    ASSERT_EQ((*node).first, it->first);
+    ASSERT_EQ((*node).second, it->second);
+  }
+}
+
+TEST(TreeAppend, SequentialInsertsFillLeaves) {
+  Tree<int, int> tree;
+  const int kKeys = 10000;
+  for (int i = 0; i < kKeys; ++i) {
+    ASSERT_EQ(tree.Insert(i, i), true);
+  }
+
+  ASSERT_LT(tree.GetLeavesCount(), kKeys / 24);
+  int expected = 0;
+  for (auto it = tree.Begin(); it != tree.End(); ++it, ++expected) {
+    ASSERT_EQ((*it).first, expected);
+  }
+  ASSERT_EQ(expected, kKeys);
+}
+
+TEST(TreeAppend, DeletesAfterAppendsMatchMap) {
+  Tree<std::string, int, 2> tree;
+  std::map<std::string, int> expected;
+  for (int i = 0; i < 3000; ++i) {
+    std::string key = "LOG" + std::to_string(100000 + i);
+    tree.Insert(key, i);
+    expected.emplace(key, i);
+  }
+  std::mt19937 gen(3);
+  std::uniform_int_distribution<int> key_dist(0, 3999);
+  for (int i = 0; i < 6000; ++i) {
+    std::string key = "LOG" + std::to_string(100000 + key_dist(gen));
+    if (i % 2 == 0) {
+      ASSERT_EQ(tree.Remove(key), expected.erase(key) == 1);
+    } else {
+      ASSERT_EQ(tree.Insert(key, i), expected.emplace(key, i).second);
+    }
+  }
+
+  ASSERT_EQ(tree.GetSize(), expected.size());
+  auto it = expected.begin();
+  for (auto node = tree.Begin(); node != tree.End(); ++node, ++it) {
+    ASSERT_EQ((*node).first, it->first);
+    ASSERT_EQ((*node).second, it->second);
+  }
+}
+
+void CheckRemoveWhile(RebalancePolicy policy) {
+  Tree<int, int, 2> tree(policy);
+  std::map<int, int> expected;
+  std::mt19937 gen(9);
+  std::uniform_int_distribution<int> key_dist(0, 5000);
+  for (int i = 0; i < 4000; ++i) {
+    int key = key_dist(gen);
+    tree.Insert(key, i);
+    expected.emplace(key, i);
+  }
+
+  for (int round = 0; round < 200; ++round) {
+    int from = key_dist(gen);
+    int to = from + key_dist(gen) % (round % 10 == 0 ? 2000 : 50);
+    size_t removed =
+        tree.RemoveWhile(from, [to](int key) { return key <= to; });
+    auto first = expected.lower_bound(from);
+    auto last = expected.upper_bound(to);
+    ASSERT_EQ(removed, std::distance(first, last));
+    expected.erase(first, last);
+
+    for (int i = 0; i < 30; ++i) {
+      int key = key_dist(gen);
+      if (i % 2 == 0) {
+        ASSERT_EQ(tree.Remove(key), expected.erase(key) == 1);
+      } else {
+        ASSERT_EQ(tree.Insert(key, i), expected.emplace(key, i).second);
+      }
+    }
+  }
+
+  ASSERT_EQ(tree.GetSize(), expected.size());
+  auto it = expected.begin();
+  for (auto node = tree.Begin(); node != tree.End(); ++node, ++it) {
+    ASSERT_EQ((*node).first, it->first);
+  }
+  ASSERT_EQ(it == expected.end(), true);
+}
+
+TEST(TreeRemoveWhile, MergeMatchesMap) {
+  CheckRemoveWhile(RebalancePolicy::kMerge);
+}
+
+TEST(TreeRemoveWhile, FreeAtEmptyMatchesMap) {
+  CheckRemoveWhile(RebalancePolicy::kFreeAtEmpty);
+}
+
+TEST(TreeRemoveWhile, ContiguousRun) {
+  Tree<int, int, 4> tree;
+  for (int i = 0; i < 100000; ++i) {
+    tree.Insert(i, i);
+  }
+
+  ASSERT_EQ(tree.RemoveWhile(5000, [](int key) { return key < 95000; }),
+            90000);
+  ASSERT_EQ(tree.GetSize(), 10000);
+  ASSERT_LT(tree.GetLeavesCount(), 10000 / 4 + 2);
+  ASSERT_EQ(tree.Exists(4999), true);
+  ASSERT_EQ(tree.Exists(5000), false);
+  ASSERT_EQ(tree.Exists(95000), true);
+  for (int i = 0; i < 5000; ++i) {
+    ASSERT_EQ(tree.Remove(i), true);
+  }
+  ASSERT_EQ(tree.RemoveWhile(0, [](int) { return true; }), 5000);
+  ASSERT_EQ(tree.GetSize(), 0);
+  ASSERT_EQ(tree.Begin() == tree.End(), true);
+  ASSERT_EQ(tree.Insert(1, 1), true);
+}
+
+TEST(BPlusTreeDelRange, RangesAndPrefixes) {
+  BPlusTree<std::string, int> tree;
+  for (int i = 0; i < 1000; ++i) {
+    tree.Set("TENANT" + std::to_string(i % 10) + "_" + std::to_string(i), i);
+  }
+
+  ASSERT_EQ(tree.DelPrefix("TENANT3_"), 100);
+  ASSERT_EQ(tree.DelPrefix("TENANT3_"), 0);
+  ASSERT_EQ(tree.DelRange("TENANT5", "TENANT6"), 100);
+  ASSERT_EQ(tree.DelRange("TENANT6", "TENANT5"), 0);
+  ASSERT_EQ(tree.GetSize(), 800);
+  ASSERT_EQ(tree.Exists("TENANT2_2"), true);
+  ASSERT_EQ(tree.Exists("TENANT3_3"), false);
+  ASSERT_EQ(tree.Exists("TENANT6_6"), true);
+}
+
+void ExpectSameRecords(const BPlusTree<std::string, std::string,
+                                       std::equal_to<std::string>, 2>& tree,
+                       const std::map<std::string, std::string>& expected) {
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  for (const auto& [key, value] : expected) {
+    keys.push_back(key);
+    values.push_back(value);
+  }
+  ASSERT_EQ(tree.Keys(), keys);
+  ASSERT_EQ(tree.Showall(), values);
+}
+
+// Strings are cleared when moved onto themselves, so empty runs must not
+// touch the leaf.
+TEST(BPlusTreeDelRange, StringKeysMatchMap) {
+  BPlusTree<std::string, std::string, std::equal_to<std::string>, 2> tree;
+  std::map<std::string, std::string> expected;
+  for (int i = 10; i < 60; ++i) {
+    std::string key = std::to_string(i);
+    tree.Set(key, "value" + key);
+    expected.emplace(key, "value" + key);
+  }
+
+  ASSERT_EQ(tree.DelPrefix("bar"), 0);
+  ASSERT_EQ(tree.DelRange("395", "399"), 0);
+  ASSERT_EQ(tree.DelRange("48", "39"), 0);
+  ExpectSameRecords(tree, expected);
+
+  // Single keys end a run at every leaf boundary in turn.
+  for (int i = 10; i < 60; i += 3) {
+    std::string key = std::to_string(i);
+    ASSERT_EQ(tree.DelRange(key, key), 1);
+    expected.erase(key);
+    ExpectSameRecords(tree, expected);
+  }
+  ASSERT_EQ(tree.DelPrefix("2"), 7);
+  ASSERT_EQ(tree.DelRange("39", "48"), 7);
+  for (auto it = expected.begin(); it != expected.end();) {
+    bool matches = it->first[0] == '2' ||
+                   (it->first >= "39" && it->first <= "48");
+    it = matches ? expected.erase(it) : std::next(it);
+  }
+  ExpectSameRecords(tree, expected);
+}
+
+TEST(LearnedIndex, PredictsWithinEpsilon) {
+  std::mt19937_64 gen(11);
+  std::vector<uint64_t> images(100000);
+  for (uint64_t& image : images) {
+    image = gen() >> (gen() % 40);
+  }
+  std::sort(images.begin(), images.end());
+
+  LearnedIndex index;
+  index.Build(images);
+  ASSERT_LT(index.GetSegmentsCount(), images.size() / 8);
+  for (size_t i = 0; i < images.size(); ++i) {
+    if (i == 0 || images[i] != images[i - 1]) {
+      size_t predicted = index.Predict(images[i]);
+      ASSERT_LE(predicted > i ? predicted - i : i - predicted,
+                LearnedIndex::kEpsilon + 1);
+    }
+  }
+}
+
+TEST(TreeFreeze, MatchesMap) {
+  Tree<int, int, 4> tree;
+  std::map<int, int> expected;
+  std::mt19937 gen(13);
+  std::uniform_int_distribution<int> key_dist(-50000, 50000);
+  for (int i = 0; i < 20000; ++i) {
+    int key = key_dist(gen);
+    tree.Insert(key, i);
+    expected.emplace(key, i);
+  }
+  tree.Freeze();
+  ASSERT_EQ(tree.IsFrozen(), true);
+  ASSERT_LT(tree.GetModelSegmentsCount(), tree.GetLeavesCount() / 4);
+
+  for (int i = 0; i < 40000; ++i) {
+    int key = key_dist(gen);
+    if (i % 3 == 0) {
+      ASSERT_EQ(tree.Remove(key), expected.erase(key) == 1);
+    } else if (i % 3 == 1) {
+      ASSERT_EQ(tree.Insert(key, i), expected.emplace(key, i).second);
+    } else {
+      ASSERT_EQ(tree.Exists(key), expected.count(key) == 1);
+    }
+  }
+  ASSERT_EQ(tree.RemoveWhile(-100, [](int key) { return key <= 100; }),
+            std::distance(expected.lower_bound(-100),
+                          expected.upper_bound(100)));
+  expected.erase(expected.lower_bound(-100), expected.upper_bound(100));
+
+  ASSERT_EQ(tree.GetSize(), expected.size());
+  for (auto& [key, value] : expected) {
+    ASSERT_EQ(tree.Search(key), value);
+  }
+  auto cursor = tree.GetCursor();
+  cursor.SeekToLast();
+  ASSERT_EQ(cursor.GetKey(), expected.rbegin()->first);
+  cursor.Seek(0);
+  ASSERT_EQ(cursor.GetKey(), expected.lower_bound(0)->first);
+
+  tree.Thaw();
+  ASSERT_EQ(tree.IsFrozen(), false);
+  auto it = expected.begin();
+  for (auto node = tree.Begin(); node != tree.End(); ++node, ++it) {
+    ASSERT_EQ((*node).first, it->first);
+  }
+  ASSERT_EQ(it == expected.end(), true);
+}
+
+TEST(TreeFreeze, StringKeysWithLongCommonPrefixes) {
+  Tree<std::string, int, 4> tree;
+  std::map<std::string, int> expected;
+  std::mt19937 gen(17);
+  std::uniform_int_distribution<int> key_dist(0, 30000);
+  for (int i = 0; i < 10000; ++i) {
+    std::string key = "tenant:0000:" + std::to_string(key_dist(gen));
+    tree.Insert(key, i);
+    expected.emplace(key, i);
+  }
+  tree.Freeze();
+
+  for (int i = 0; i < 10000; ++i) {
+    std::string key = "tenant:0000:" + std::to_string(key_dist(gen));
+    if (i % 2 == 0) {
+      ASSERT_EQ(tree.Insert(key, i), expected.emplace(key, i).second);
+    } else {
+      ASSERT_EQ(tree.Remove(key), expected.erase(key) == 1);
+    }
+  }
+  ASSERT_EQ(tree.Insert("a", 1), true);
+  expected.emplace("a", 1);
+
+  ASSERT_EQ(tree.GetSize(), expected.size());
+  for (auto& [key, value] : expected) {
+    ASSERT_EQ(tree.Search(key), value);
+  }
+  auto it = expected.begin();
+  for (auto node = tree.Begin(); node != tree.End(); ++node, ++it) {
+    ASSERT_EQ((*node).first, it->first);
+  }
+}
+
+TEST(BPlusTreeFreeze, StorageOperations) {
+  BPlusTree<std::string, Student> tree;
+  Student student{"NAME", "SURNAME", 12, "CITY", 5555};
+  for (int i = 0; i < 500; ++i) {
+    tree.Set("KEY" + std::to_string(i), student);
+  }
+  tree.Freeze();
+
+  BPlusTree<std::string, Student> copy(tree);
+  ASSERT_EQ(copy.IsFrozen(), true);
+  ASSERT_EQ(tree.Rename("KEY1", "KEY1000"), true);
+  ASSERT_EQ(tree.Update("KEY2", Student{"A", "B", 1, "C", 2}), true);
+  ASSERT_EQ(tree.Get("KEY2").coins, 2);
+  ASSERT_EQ(tree.Scan("KEY10", "KEY11", 200).size(), 13);
+  tree.Compact();
+  ASSERT_EQ(tree.IsFrozen(), true);
+  ASSERT_EQ(tree.Keys().size(), 500);
+  ASSERT_EQ(copy.Exists("KEY1"), true);
+}
+
+TEST(TreeCopy, KeepsShape) {
+  Tree<int, int, 2> tree(RebalancePolicy::kFreeAtEmpty);
+  std::map<int, int> expected;
+  std::mt19937 gen(17);
+  std::uniform_int_distribution<int> key_dist(0, 5000);
+  for (int i = 0; i < 20000; ++i) {
+    int key = key_dist(gen);
+    if (i % 2 == 0) {
+      tree.Insert(key, i);
+      expected.emplace(key, i);
+    } else {
+      tree.Remove(key);
+      expected.erase(key);
+    }
+  }
+
+  for (bool frozen : {false, true}) {
+    if (frozen) tree.Freeze();
+    Tree<int, int, 2> copy(tree);
+    ASSERT_EQ(copy.IsFrozen(), frozen);
+    ASSERT_EQ(copy.GetLeavesCount(), tree.GetLeavesCount());
+    ASSERT_EQ(copy.GetSize(), expected.size());
+
+    std::map<int, int> copy_expected = expected;
+    for (int i = 0; i < 5000; ++i) {
+      int key = key_dist(gen);
+      if (i % 2 == 0) {
+        ASSERT_EQ(copy.Insert(key, -i), copy_expected.emplace(key, -i).second);
+      } else {
+        ASSERT_EQ(copy.Remove(key), copy_expected.erase(key) == 1);
+      }
+    }
+    auto it = copy_expected.begin();
+    for (auto node = copy.Begin(); node != copy.End(); ++node, ++it) {
+      ASSERT_EQ((*node).first, it->first);
+      ASSERT_EQ((*node).second, it->second);
+    }
+    ASSERT_EQ(it == copy_expected.end(), true);
+    for (auto& [key, value] : expected) {
+      ASSERT_EQ(tree.Search(key), value);
+    }
+  }
+}
+
+TEST(BPlusTreeClone, Independent) {
+  BPlusTree<int, int> tree;
+  for (int i = 0; i < 1000; ++i) {
+    tree.Set(i, i);
+  }
+  std::unique_ptr<BaseStorage<int, int>> clone = tree.Clone();
+  clone->DelRange(0, 499);
+  ASSERT_EQ(tree.Keys().size(), 1000);
+  ASSERT_EQ(clone->Keys().size(), 500);
+  ASSERT_EQ(clone->Select(0), 500);
+}
+
+TEST(KeyPrefix, PreservesOrder) {
+  ASSERT_LT(KeyPrefix<int>::Get(-5), KeyPrefix<int>::Get(3));
+  ASSERT_LT(KeyPrefix<int64_t>::Get(INT64_MIN), KeyPrefix<int64_t>::Get(-1));
+  ASSERT_LE(KeyPrefix<std::string>::Get("ABCDEFGH1"),
+            KeyPrefix<std::string>::Get("ABCDEFGH2"));
+  ASSERT_LT(KeyPrefix<std::string>::Get("AB"),
+            KeyPrefix<std::string>::Get("ABC"));
+
+  uint64_t values[] = {1, 3, 3, 7, 9, 12, UINT64_MAX};
+  ASSERT_EQ(CountLess(values, 7, 3), 1);
+  ASSERT_EQ(CountLessOrEqual(values, 7, 3), 3);
+  ASSERT_EQ(CountLess(values, 7, UINT64_MAX), 6);
+  ASSERT_EQ(CountLessOrEqual(values, 7, UINT64_MAX), 7);
+}
+
 }  // namespace s21
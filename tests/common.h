@@ -3,8 +3,49 @@
 
 #include <gtest/gtest.h>
 
+#include <map>
+#include <random>
+#include <string>
+
 namespace s21 {
 const std::string kSamplesDir = std::string(SAMPLES_DIR) + "/";
+
+// Runs random Set, Del, Update and Exists calls against table and a
+// std::map side by side, then compares the final contents.
+template <typename Table>
+void ExpectMatchesStdMap(Table& table, unsigned seed, int key_count,
+                         int operations) {
+  std::map<std::string, int> expected;
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> key_dist(0, key_count);
+  std::uniform_int_distribution<int> op_dist(0, 4);
+
+  for (int i = 0; i < operations; ++i) {
+    std::string key = "KEY" + std::to_string(key_dist(gen));
+    switch (op_dist(gen)) {
+      case 0:
+      case 1:
+        ASSERT_EQ(table.Set(key, i), expected.emplace(key, i).second);
+        break;
+      case 2:
+        ASSERT_EQ(table.Del(key), expected.erase(key) == 1);
+        break;
+      case 3:
+        ASSERT_EQ(table.Update(key, i), expected.count(key) == 1);
+        if (expected.count(key)) {
+          expected[key] = i;
+        }
+        break;
+      default:
+        ASSERT_EQ(table.Exists(key), expected.count(key) == 1);
+    }
+  }
+
+  ASSERT_EQ(table.GetSize(), expected.size());
+  for (const auto& [key, value] : expected) {
+    ASSERT_EQ(table.Get(key), value);
+  }
 }
+}  // namespace s21
 
-#endif  // TRANSACTIONS_TESTS_COMMON_H_
\ No newline at end of file
+#endif  // TRANSACTIONS_TESTS_COMMON_H_
@@ -0,0 +1,365 @@
+#include <atomic>
+#include <map>
+#include <random>
+#include <thread>
+
+#include "common.h"
+#include "controller/controller.h"
+#include "model/bplustree/concurrent_b_plus_tree.h"
+#include "model/common/student.h"
+
+namespace s21 {
+
+TEST(ConcurrentBPlusTree, BasicOperations) {
+  ConcurrentBPlusTree<std::string, Student> tree;
+  Student student{"NAME", "SURNAME", 12, "CITY", 5555};
+  Student new_student{"NAME2", "SURNAME2", 13, "CITY2", 5556};
+
+  ASSERT_EQ(tree.IsThreadSafe(), true);
+  ASSERT_EQ(tree.Set("KEY", student), true);
+  ASSERT_EQ(tree.Set("KEY", student), false);
+  ASSERT_EQ(tree.Get("KEY"), student);
+  ASSERT_EQ(tree.Update("KEY", new_student), true);
+  ASSERT_EQ(tree.Get("KEY"), new_student);
+  ASSERT_EQ(tree.Rename("KEY", "KEY2"), true);
+  ASSERT_EQ(tree.Exists("KEY"), false);
+  ASSERT_EQ(tree.Find(new_student), std::vector<std::string>{"KEY2"});
+  ASSERT_EQ(tree.Del("KEY2"), true);
+  ASSERT_EQ(tree.Del("KEY2"), false);
+  ASSERT_THROW(tree.Get("KEY2"), std::invalid_argument);
+}
+
+TEST(ConcurrentTree, MatchesMapWithSplitsAndMerges) {
+  ConcurrentTree<int, int, 2> tree;
+  std::map<int, int> expected;
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> key_dist(0, 2000);
+
+  for (int i = 0; i < 20000; ++i) {
+    int key = key_dist(gen);
+    if (i % 5 < 2) {
+      ASSERT_EQ(tree.Remove(key), expected.erase(key) == 1);
+    } else if (i % 5 == 2) {
+      ASSERT_EQ(tree.Update(key, -i), expected.count(key) == 1);
+      if (expected.count(key) == 1) {
+        expected[key] = -i;
+      }
+    } else {
+      ASSERT_EQ(tree.Insert(key, i), expected.emplace(key, i).second);
+    }
+  }
+
+  ASSERT_EQ(tree.GetSize(), expected.size());
+  auto it = expected.begin();
+  tree.ForEach(nullptr, [&](const auto& record) {
+    EXPECT_EQ(record.key, it->first);
+    EXPECT_EQ(record.value, it->second);
+    ++it;
+    return true;
+  });
+  ASSERT_EQ(it == expected.end(), true);
+  ASSERT_EQ(tree.Scan(100, 200, 1000).size(),
+            std::distance(expected.lower_bound(100),
+                          expected.upper_bound(200)));
+}
+
+TEST(ConcurrentTree, RemoveEverything) {
+  ConcurrentTree<int, int, 2> tree;
+  for (int i = 0; i < 1000; ++i) {
+    tree.Insert(i, i);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(tree.Remove(i), true);
+  }
+
+  ASSERT_EQ(tree.GetSize(), 0);
+  ASSERT_EQ(tree.Scan(0, 1000, 1000).empty(), true);
+  ASSERT_EQ(tree.Insert(5, 5), true);
+  ASSERT_EQ(tree.Search(5), 5);
+}
+
+TEST(ConcurrentTree, ForEachBeforeAfterDeletes) {
+  ConcurrentTree<int, int, 2> tree;
+  std::map<int, int> expected;
+  for (int i = 0; i < 2000; ++i) {
+    tree.Insert(i, i);
+    expected.emplace(i, i);
+  }
+  std::mt19937 gen(3);
+  std::uniform_int_distribution<int> key_dist(0, 1999);
+  for (int i = 0; i < 1800; ++i) {
+    int key = key_dist(gen);
+    ASSERT_EQ(tree.Remove(key), expected.erase(key) == 1);
+  }
+
+  for (int before : {-1, 0, 1, 500, 1001, 1999, 2000}) {
+    std::vector<int> keys;
+    tree.ForEachBefore(&before, [&keys](const auto& record) {
+      keys.push_back(record.key);
+      return true;
+    });
+    std::vector<int> reference;
+    for (auto it = expected.lower_bound(before); it != expected.begin();) {
+      reference.push_back((--it)->first);
+    }
+    ASSERT_EQ(keys, reference);
+  }
+
+  std::vector<int> keys;
+  tree.ForEachBefore(nullptr, [&keys](const auto& record) {
+    keys.push_back(record.key);
+    return keys.size() < 10;
+  });
+  ASSERT_EQ(keys.size(), 10);
+  ASSERT_EQ(keys.front(), expected.rbegin()->first);
+}
+
+TEST(ConcurrentBPlusTree, CursorWalksBackwards) {
+  ConcurrentBPlusTree<int, int, std::equal_to<int>, 2> tree;
+  for (int i = 0; i < 3000; ++i) {
+    tree.Set(i, -i);
+  }
+
+  auto cursor = tree.GetCursor();
+  int expected = 2999;
+  for (cursor->SeekToLast(); cursor->IsValid(); cursor->Prev()) {
+    ASSERT_EQ(cursor->GetKey(), expected);
+    ASSERT_EQ(cursor->GetValue(), -expected);
+    --expected;
+  }
+  ASSERT_EQ(expected, -1);
+}
+
+TEST(ConcurrentTree, CopyIsBuiltBottomUp) {
+  ConcurrentTree<int, int, 2> empty;
+  ConcurrentTree<int, int, 2> empty_copy(empty);
+  ASSERT_EQ(empty_copy.Insert(1, 1), true);
+  ASSERT_EQ(empty_copy.Search(1), 1);
+
+  ConcurrentTree<int, int, 2> tree;
+  std::map<int, int> expected;
+  for (int i = 0; i < 5000; ++i) {
+    tree.Insert(i, i);
+    expected.emplace(i, i);
+  }
+  ConcurrentTree<int, int, 2> copy(tree);
+  tree.Remove(1);
+
+  std::mt19937 gen(5);
+  std::uniform_int_distribution<int> key_dist(0, 6000);
+  for (int i = 0; i < 20000; ++i) {
+    int key = key_dist(gen);
+    if (i % 2 == 0) {
+      ASSERT_EQ(copy.Remove(key), expected.erase(key) == 1);
+    } else {
+      ASSERT_EQ(copy.Insert(key, -i), expected.emplace(key, -i).second);
+    }
+  }
+
+  ASSERT_EQ(copy.GetSize(), expected.size());
+  auto it = expected.begin();
+  copy.ForEach(nullptr, [&](const auto& record) {
+    EXPECT_EQ(record.key, it->first);
+    EXPECT_EQ(record.value, it->second);
+    ++it;
+    return true;
+  });
+  ASSERT_EQ(it == expected.end(), true);
+  auto rit = expected.rbegin();
+  copy.ForEachBefore(nullptr, [&](const auto& record) {
+    EXPECT_EQ(record.key, rit->first);
+    ++rit;
+    return true;
+  });
+  ASSERT_EQ(rit == expected.rend(), true);
+}
+
+TEST(ConcurrentBPlusTree, ParallelWriters) {
+  ConcurrentBPlusTree<std::string, int, std::equal_to<int>, 4> tree;
+  const int kThreads = 8;
+  const int kPerThread = 3000;
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&tree, t] {
+      for (int i = 0; i < kPerThread; ++i) {
+        tree.Set("KEY" + std::to_string(i) + "_" + std::to_string(t), i);
+      }
+      for (int i = 0; i < kPerThread; i += 2) {
+        tree.Del("KEY" + std::to_string(i) + "_" + std::to_string(t));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(tree.GetSize(), kThreads * kPerThread / 2);
+  ASSERT_EQ(tree.Keys().size(), kThreads * kPerThread / 2);
+  for (int t = 0; t < kThreads; ++t) {
+    for (int i = 0; i < kPerThread; ++i) {
+      std::string key = "KEY" + std::to_string(i) + "_" + std::to_string(t);
+      ASSERT_EQ(tree.Exists(key), i % 2 == 1);
+    }
+  }
+}
+
+// Writers keep every key of [0, kKeys) either present with value key or
+// absent, and only touch odd keys, so every scan must see all even keys in
+// order and only consistent values.
+TEST(ConcurrentBPlusTree, ScansDuringSplitsAndMerges) {
+  ConcurrentBPlusTree<int, int, std::equal_to<int>, 2> tree;
+  const int kKeys = 2000;
+  for (int i = 0; i < kKeys; i += 2) {
+    tree.Set(i, i);
+  }
+  std::atomic<bool> stop = false;
+  std::atomic<int> failures = 0;
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 3; ++t) {
+    threads.emplace_back([&, t] {
+      std::mt19937 gen(t);
+      std::uniform_int_distribution<int> key_dist(0, kKeys / 2 - 1);
+      while (!stop.load()) {
+        int key = key_dist(gen) * 2 + 1;
+        if (!tree.Set(key, key)) {
+          tree.Del(key);
+        }
+      }
+    });
+  }
+  for (int t = 0; t < 2; ++t) {
+    threads.emplace_back([&] {
+      for (int round = 0; round < 200; ++round) {
+        auto records = tree.Scan(0, kKeys, kKeys);
+        int even = 0;
+        for (size_t i = 0; i < records.size(); ++i) {
+          bool sorted = i == 0 || records[i - 1].first < records[i].first;
+          if (!sorted || records[i].first != records[i].second) {
+            ++failures;
+          }
+          even += records[i].first % 2 == 0 ? 1 : 0;
+        }
+        if (even != kKeys / 2) {
+          ++failures;
+        }
+      }
+    });
+  }
+  threads[3].join();
+  threads[4].join();
+  stop.store(true);
+  for (int t = 0; t < 3; ++t) {
+    threads[t].join();
+  }
+
+  ASSERT_EQ(failures.load(), 0);
+  for (int i = 0; i < kKeys; i += 2) {
+    ASSERT_EQ(tree.Get(i), i);
+  }
+}
+
+// One record is renamed along 0, 1, 2, ... A reader that checks the keys
+// in the same order must always meet it, since each rename writes the new
+// key before it removes the old one.
+TEST(ConcurrentBPlusTree, RenameNeverHidesRecord) {
+  ConcurrentBPlusTree<int, int, std::equal_to<int>, 2> tree;
+  const int kSteps = 3000;
+  for (int i = 0; i < 100; ++i) {
+    tree.Set(-1 - i, i);
+  }
+  tree.Set(0, 42);
+  std::atomic<bool> stop = false;
+  std::atomic<int> failures = 0;
+
+  std::thread reader([&] {
+    while (!stop.load()) {
+      bool found = false;
+      for (int i = 0; i <= kSteps && !found; ++i) {
+        found = tree.Exists(i);
+      }
+      if (!found) {
+        ++failures;
+      }
+    }
+  });
+  for (int i = 0; i < kSteps; ++i) {
+    ASSERT_EQ(tree.Rename(i, i + 1), true);
+  }
+  stop.store(true);
+  reader.join();
+
+  ASSERT_EQ(failures.load(), 0);
+  ASSERT_EQ(tree.GetSize(), 101);
+  ASSERT_EQ(tree.Get(kSteps), 42);
+  ASSERT_EQ(tree.Rename(kSteps, -1), false);
+  ASSERT_EQ(tree.Get(kSteps), 42);
+  ASSERT_EQ(tree.Get(-1), 0);
+}
+
+TEST(ConcurrentBPlusTree, CopyConstructor) {
+  ConcurrentBPlusTree<std::string, int> tree;
+  for (int i = 0; i < 1000; ++i) {
+    tree.Set("KEY" + std::to_string(i), i);
+  }
+
+  ConcurrentBPlusTree<std::string, int> copy(tree);
+  tree.Del("KEY1");
+
+  ASSERT_EQ(copy.GetSize(), 1000);
+  ASSERT_EQ(copy.Get("KEY1"), 1);
+  ASSERT_EQ(copy.Showall().size(), 1000);
+}
+
+TEST(ConcurrentBPlusTree, OrderStatisticsAndRanges) {
+  ConcurrentBPlusTree<int, int> tree;
+  for (int i = 0; i < 1000; ++i) {
+    tree.Set(i * 2, i);
+  }
+
+  ASSERT_EQ(tree.Rank(100), 50);
+  ASSERT_EQ(tree.Rank(101), 51);
+  ASSERT_EQ(tree.Select(10), 20);
+  ASSERT_THROW(tree.Select(1000), std::out_of_range);
+  ASSERT_EQ(tree.CountRange(10, 19), 5);
+  ASSERT_EQ(tree.DelRange(100, 199), 50);
+  ASSERT_EQ(tree.GetSize(), 950);
+  ASSERT_EQ(tree.Exists(98), true);
+  ASSERT_EQ(tree.Exists(150), false);
+
+  auto cursor = tree.GetCursor();
+  cursor->SeekToLast();
+  ASSERT_EQ(cursor->GetKey(), 1998);
+  cursor->Seek(99);
+  ASSERT_EQ(cursor->GetKey(), 200);
+  cursor->Prev();
+  ASSERT_EQ(cursor->GetKey(), 98);
+  ASSERT_EQ(cursor->GetValue(), 49);
+}
+
+TEST(ConcurrentBPlusTree, ControllerFromManyThreads) {
+  ConcurrentBPlusTree<std::string, Student> tree;
+  Controller<std::string, Student> controller(tree);
+  Student student{"NAME", "SURNAME", 12, "CITY", 5555};
+  std::atomic<int> found = 0;
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 1000; ++i) {
+        std::string key = std::to_string(t) + "_" + std::to_string(i);
+        controller.Set(key, student);
+        found += controller.Exists(key);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(found.load(), 4000);
+  ASSERT_EQ(controller.Range("0", "1", 5000).size(), 1000);
+}
+
+}  // namespace s21
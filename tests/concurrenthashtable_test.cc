@@ -0,0 +1,162 @@
+#include <atomic>
+#include <thread>
+
+#include "common.h"
+#include "controller/controller.h"
+#include "model/common/student.h"
+#include "model/hashtable/concurrent_hash_table.h"
+
+namespace s21 {
+
+TEST(ConcurrentHashTable, BasicOperations) {
+  ConcurrentHashTable<std::string, Student> table;
+  Student student{"NAME", "SURNAME", 12, "CITY", 5555};
+  Student new_student{"NAME2", "SURNAME2", 13, "CITY2", 5556};
+
+  ASSERT_EQ(table.IsThreadSafe(), true);
+  ASSERT_EQ(table.Set("KEY", student), true);
+  ASSERT_EQ(table.Set("KEY", student), false);
+  ASSERT_EQ(table.Get("KEY"), student);
+  ASSERT_EQ(table.Update("KEY", new_student), true);
+  ASSERT_EQ(table.Get("KEY"), new_student);
+  ASSERT_EQ(table.Rename("KEY", "KEY2"), true);
+  ASSERT_EQ(table.Exists("KEY"), false);
+  ASSERT_EQ(table.Find(new_student), std::vector<std::string>{"KEY2"});
+  ASSERT_EQ(table.Del("KEY2"), true);
+  ASSERT_EQ(table.Del("KEY2"), false);
+  ASSERT_THROW(table.Get("KEY2"), std::invalid_argument);
+}
+
+TEST(ConcurrentHashTable, StripesRoundedToPowerOfTwo) {
+  ConcurrentHashTable<std::string, int> table(5);
+
+  ASSERT_EQ(table.GetStripesCount(), 8);
+}
+
+TEST(ConcurrentHashTable, CopyConstructor) {
+  ConcurrentHashTable<std::string, int> table;
+  for (int i = 0; i < 1000; ++i) {
+    table.Set("KEY" + std::to_string(i), i);
+  }
+
+  ConcurrentHashTable<std::string, int> copy(table);
+  table.Del("KEY1");
+
+  ASSERT_EQ(copy.GetSize(), 1000);
+  ASSERT_EQ(copy.Get("KEY1"), 1);
+  ASSERT_EQ(copy.Keys().size(), 1000);
+  ASSERT_EQ(copy.Showall().size(), 1000);
+}
+
+// With 0 or 3 keys most stripes are empty, and 1000 new keys reach every
+// stripe of the clone.
+TEST(ConcurrentHashTable, CloneWithEmptyStripes) {
+  for (int filled : {0, 3}) {
+    ConcurrentHashTable<std::string, int> table;
+    for (int i = 0; i < filled; ++i) {
+      table.Set("OLD" + std::to_string(i), i);
+    }
+
+    std::unique_ptr<BaseStorage<std::string, int>> clone = table.Clone();
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_EQ(clone->Set("KEY" + std::to_string(i), i), true);
+      ASSERT_EQ(clone->Update("KEY" + std::to_string(i), i + 1), true);
+    }
+
+    ASSERT_EQ(clone->Keys().size(), 1000 + filled);
+    for (int i = 0; i < filled; ++i) {
+      ASSERT_EQ(clone->Get("OLD" + std::to_string(i)), i);
+    }
+    ASSERT_EQ(clone->Get("KEY999"), 1000);
+    ASSERT_EQ(table.Exists("KEY0"), false);
+  }
+}
+
+TEST(ConcurrentHashTable, ParallelWriters) {
+  ConcurrentHashTable<std::string, int> table;
+  const int kThreads = 8;
+  const int kPerThread = 5000;
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&table, t] {
+      for (int i = 0; i < kPerThread; ++i) {
+        table.Set("KEY" + std::to_string(t) + "_" + std::to_string(i), i);
+      }
+      for (int i = 0; i < kPerThread; i += 2) {
+        table.Del("KEY" + std::to_string(t) + "_" + std::to_string(i));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(table.GetSize(), kThreads * kPerThread / 2);
+  for (int t = 0; t < kThreads; ++t) {
+    for (int i = 0; i < kPerThread; ++i) {
+      std::string key = "KEY" + std::to_string(t) + "_" + std::to_string(i);
+      ASSERT_EQ(table.Exists(key), i % 2 == 1);
+    }
+  }
+}
+
+TEST(ConcurrentHashTable, ParallelRenamesKeepEveryValue) {
+  ConcurrentHashTable<std::string, int> table;
+  const int kKeys = 64;
+  for (int i = 0; i < kKeys; ++i) {
+    table.Set("A" + std::to_string(i), i);
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&table] {
+      for (int round = 0; round < 200; ++round) {
+        for (int i = 0; i < kKeys; ++i) {
+          std::string a = "A" + std::to_string(i);
+          std::string b = "B" + std::to_string(i);
+          if (!table.Rename(a, b)) {
+            table.Rename(b, a);
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(table.GetSize(), kKeys);
+  for (int i = 0; i < kKeys; ++i) {
+    std::string key = table.Exists("A" + std::to_string(i))
+                          ? "A" + std::to_string(i)
+                          : "B" + std::to_string(i);
+    ASSERT_EQ(table.Get(key), i);
+  }
+}
+
+TEST(ConcurrentHashTable, ControllerFromManyThreads) {
+  ConcurrentHashTable<std::string, Student> table;
+  Controller<std::string, Student> controller(table);
+  Student student{"NAME", "SURNAME", 12, "CITY", 5555};
+  std::atomic<int> found = 0;
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 1000; ++i) {
+        std::string key = std::to_string(t) + "_" + std::to_string(i);
+        controller.Set(key, student);
+        found += controller.Exists(key);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(found.load(), 4000);
+  ASSERT_EQ(controller.Keys().size(), 4000);
+}
+
+}  // namespace s21
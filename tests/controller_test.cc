@@ -4,6 +4,7 @@
 #include "common.h"
 #include "controller/controller.h"
 #include "model/common/student.h"
+#include "model/bst/self_balancing_binary_search_tree.h"
 #include "model/hashtable/hash_table.h"
 
 namespace s21 {
@@ -34,6 +35,44 @@ TEST_F(ControllerFixture, TTLExpired) {
   ASSERT_EQ(controller_.TTL(key_), 0);
 }
 
+TEST_F(ControllerFixture, TTLInMilliseconds) {
+  controller_.SetWithTimeout(key_, value_, std::chrono::milliseconds(50));
+  controller_.SetWithTimeout(key_ + "1", value_,
+                             std::chrono::milliseconds(5000));
+  ASSERT_EQ(controller_.Exists(key_), true);
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+
+  ASSERT_EQ(controller_.Exists(key_), false);
+  ASSERT_EQ(controller_.TTL(key_ + "1"), 4);
+}
+
+TEST_F(ControllerFixture, AccessExpiresOnlyItsKey) {
+  for (int i = 0; i < 100; ++i) {
+    controller_.SetWithTimeout(key_ + std::to_string(i), value_,
+                               std::chrono::milliseconds(20));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+  ASSERT_EQ(controller_.Exists(key_ + "0"), false);
+  ASSERT_EQ(controller_.Set(key_ + "1", value_), true);
+  ASSERT_EQ(ht_.GetSize(), 99);
+  ASSERT_EQ(controller_.Keys(), std::vector<std::string>{key_ + "1"});
+}
+
+TEST_F(ControllerFixture, CollectorWakesForExpiry) {
+  for (int i = 0; i < 1000; ++i) {
+    controller_.SetWithTimeout(key_ + std::to_string(i), value_,
+                               std::chrono::milliseconds(50));
+  }
+  std::thread collector(
+      [this] { controller_.StartManagerLoop(std::chrono::seconds(5)); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  controller_.StopManagerLoop();
+  collector.join();
+
+  ASSERT_EQ(ht_.GetSize(), 0);
+}
+
 TEST_F(ControllerFixture, SetNegativeTTL) {
   controller_.Set(key_, value_, -5);
   size_t ttl = controller_.TTL(key_);
@@ -55,6 +94,44 @@ TEST_F(ControllerFixture, ExistsExpiredTTL) {
   ASSERT_EQ(controller_.Exists(key_), false);
 }
 
+TEST_F(ControllerFixture, CompactKeepsRecords) {
+  for (int i = 0; i < 1000; ++i) {
+    controller_.Set(key_ + std::to_string(i), value_);
+  }
+  for (int i = 0; i < 990; ++i) {
+    controller_.Del(key_ + std::to_string(i));
+  }
+
+  controller_.Compact();
+
+  ASSERT_EQ(ht_.GetBucketCount(), 16);
+  ASSERT_EQ(controller_.Keys().size(), 10);
+  ASSERT_EQ(controller_.Get(key_ + "995"), value_);
+}
+
+TEST_F(ControllerFixture, RenameOntoExistingKeepsTTL) {
+  controller_.Set(key_, value_, 5);
+  controller_.Set(key_ + "1", value_, 10);
+
+  ASSERT_EQ(controller_.Rename(key_, key_ + "1"), false);
+  ASSERT_EQ(controller_.TTL(key_), 4);
+  ASSERT_EQ(controller_.TTL(key_ + "1"), 9);
+}
+
+TEST_F(ControllerFixture, RenameMovesTTL) {
+  controller_.Set(key_, value_, 5);
+
+  ASSERT_EQ(controller_.Rename(key_, key_ + "1"), true);
+  ASSERT_EQ(controller_.TTL(key_), 0);
+  ASSERT_EQ(controller_.TTL(key_ + "1"), 4);
+}
+
+TEST_F(ControllerFixture, RangeOnUnorderedStorage) {
+  controller_.Set(key_, value_);
+
+  ASSERT_THROW(controller_.Range(key_, key_), std::logic_error);
+}
+
 TEST_F(ControllerFixture, DelExpiredTTL) {
   controller_.Set(key_, value_, 1);
   std::this_thread::sleep_for(std::chrono::milliseconds(1001));
@@ -62,4 +139,35 @@ TEST_F(ControllerFixture, DelExpiredTTL) {
   ASSERT_EQ(controller_.Del(key_), false);
 }
 
+TEST_F(ControllerFixture, DelPrefixDropsTTL) {
+  controller_.Set(key_ + "1", value_, 1);
+  controller_.Set(key_ + "2", value_);
+  controller_.Set("other", value_);
+
+  ASSERT_EQ(controller_.DelPrefix(key_), 2);
+  ASSERT_EQ(controller_.TTL(key_ + "1"), 0);
+  ASSERT_EQ(controller_.DelRange("a", "z"), 1);
+  ASSERT_EQ(controller_.Keys().empty(), true);
+}
+
+TEST_F(ControllerFixture, OrderStatisticsNeedOrderedStorage) {
+  controller_.Set(key_, value_);
+  ASSERT_THROW(controller_.Rank(key_), std::logic_error);
+}
+
+TEST(ControllerOrderStatistics, Pages) {
+  SelfBalancingBinarySearchTree<int, int> bst;
+  Controller<int, int> controller(bst);
+  for (int i = 0; i < 10000; ++i) {
+    controller.Set(i * 2, i);
+  }
+
+  ASSERT_EQ(controller.Select(5000), 10000);
+  ASSERT_EQ(controller.Rank(10001), 5001);
+  ASSERT_EQ(controller.CountRange(100, 199), 50);
+  controller.Del(0);
+  ASSERT_EQ(controller.Select(0), 2);
+  ASSERT_THROW(controller.Select(9999), std::out_of_range);
+}
+
 }  // namespace s21
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include <map>
+#include <random>
+#include <thread>
+
+#include "common.h"
+#include "model/bplustree/cow_b_plus_tree.h"
+#include "model/common/student.h"
+
+namespace s21 {
+
+template <typename Tree>
+void ExpectSameRecords(const Tree& tree, const std::map<int, int>& expected) {
+  ASSERT_EQ(tree.GetSize(), expected.size());
+  auto cursor = tree.GetCursor();
+  auto it = expected.begin();
+  for (cursor.SeekToFirst(); cursor.IsValid(); cursor.Next(), ++it) {
+    ASSERT_EQ(cursor.GetKey(), it->first);
+    ASSERT_EQ(cursor.GetValue(), it->second);
+  }
+  ASSERT_EQ(it == expected.end(), true);
+}
+
+TEST(CowTree, SnapshotsKeepTheirVersion) {
+  CowTree<int, int, 2> tree;
+  std::map<int, int> expected;
+  std::vector<CowTree<int, int, 2>> snapshots;
+  std::vector<std::map<int, int>> versions;
+  std::mt19937 gen(21);
+  std::uniform_int_distribution<int> key_dist(0, 3000);
+
+  for (int i = 0; i < 30000; ++i) {
+    int key = key_dist(gen);
+    if (i % 3 == 0) {
+      ASSERT_EQ(tree.Remove(key), expected.erase(key) == 1);
+    } else if (i % 5 == 0) {
+      ASSERT_EQ(tree.Update(key, -i), expected.count(key) == 1);
+      if (expected.count(key) == 1) {
+        expected[key] = -i;
+      }
+    } else {
+      ASSERT_EQ(tree.Insert(key, i), expected.emplace(key, i).second);
+    }
+    if (i % 3000 == 0) {
+      snapshots.push_back(tree.Snapshot());
+      versions.push_back(expected);
+    }
+  }
+
+  ExpectSameRecords(tree, expected);
+  for (size_t i = 0; i < snapshots.size(); ++i) {
+    ExpectSameRecords(snapshots[i], versions[i]);
+  }
+}
+
+TEST(CowTree, WritesCopyOnlyTheirPath) {
+  CowTree<int, int, 4> tree;
+  for (int i = 0; i < 100000; ++i) {
+    tree.Insert(i, i);
+  }
+  ASSERT_EQ(tree.GetSharedCount(), 0);
+
+  CowTree<int, int, 4> snapshot = tree.Snapshot();
+  size_t nodes = tree.GetSharedCount();
+  tree.Update(500, -1);
+  tree.Insert(100000, 0);
+  ASSERT_GT(tree.GetSharedCount(), nodes - 20);
+  ASSERT_EQ(tree.Search(500), -1);
+  ASSERT_EQ(snapshot.Search(500), 500);
+  ASSERT_EQ(snapshot.Exists(100000), false);
+
+  auto cursor = snapshot.GetCursor();
+  cursor.SeekToLast();
+  ASSERT_EQ(cursor.GetKey(), 99999);
+  cursor.Seek(50000);
+  cursor.Prev();
+  ASSERT_EQ(cursor.GetKey(), 49999);
+}
+
+TEST(CowTree, SnapshotScannedWhileWriting) {
+  CowTree<int, int, 4> tree;
+  for (int i = 0; i < 20000; ++i) {
+    tree.Insert(i, i);
+  }
+  CowTree<int, int, 4> snapshot = tree.Snapshot();
+
+  long long sum = 0;
+  std::thread reader([&sum, snapshot = std::move(snapshot)]() {
+    auto cursor = snapshot.GetCursor();
+    for (cursor.SeekToFirst(); cursor.IsValid(); cursor.Next()) {
+      sum += cursor.GetValue();
+    }
+  });
+  for (int i = 0; i < 20000; i += 2) {
+    tree.Remove(i);
+    tree.Update(i + 1, 0);
+  }
+  reader.join();
+
+  ASSERT_EQ(sum, 19999LL * 20000 / 2);
+  ASSERT_EQ(tree.GetSize(), 10000);
+  ASSERT_EQ(tree.Scan(0, 100, 100).size(), 50);
+}
+
+TEST(CowBPlusTree, BasicOperations) {
+  CowBPlusTree<std::string, Student> tree;
+  Student student{"NAME", "SURNAME", 12, "CITY", 5555};
+  Student new_student{"NAME2", "SURNAME2", 13, "CITY2", 5556};
+
+  ASSERT_EQ(tree.Set("KEY", student), true);
+  ASSERT_EQ(tree.Set("KEY", student), false);
+  CowBPlusTree<std::string, Student> snapshot = tree.Snapshot();
+  std::unique_ptr<BaseStorage<std::string, Student>> clone = tree.Clone();
+  ASSERT_EQ(tree.Update("KEY", new_student), true);
+  ASSERT_EQ(tree.Rename("KEY", "KEY2"), true);
+  ASSERT_EQ(tree.Find(new_student), std::vector<std::string>{"KEY2"});
+  ASSERT_EQ(tree.Del("KEY2"), true);
+  ASSERT_THROW(tree.Get("KEY2"), std::invalid_argument);
+  ASSERT_EQ(tree.Keys().empty(), true);
+
+  ASSERT_EQ(snapshot.Get("KEY"), student);
+  ASSERT_EQ(snapshot.Keys(), std::vector<std::string>{"KEY"});
+  ASSERT_EQ(snapshot.Showall().size(), 1);
+  ASSERT_EQ(clone->Get("KEY"), student);
+}
+
+}  // namespace s21
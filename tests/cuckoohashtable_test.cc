@@ -0,0 +1,248 @@
+#include "common.h"
+#include "model/common/student.h"
+#include "model/hashtable/cuckoo_hash_table.h"
+
+namespace s21 {
+
+struct CuckooConstantHasher {
+  size_t operator()(int key) const { return key % 4 == 0 ? 7 : key; }
+};
+
+struct CuckooSameHasher {
+  size_t operator()(int) const { return 7; }
+};
+
+TEST(CuckooHashTableCopyConstructor, Normal) {
+  CuckooHashTable<std::string, Student> table;
+  size_t count_elements = 100;
+
+  for (size_t i = 0; i < count_elements; ++i) {
+    table.Set("KEY" + std::to_string(i),
+              Student{"NAME", "SURNAME", 12, "CITY", static_cast<int>(i)});
+  }
+
+  CuckooHashTable<std::string, Student> table_2 = table;
+  table.Del("KEY1");
+
+  for (size_t i = 0; i < count_elements; ++i) {
+    ASSERT_EQ(table_2.Get("KEY" + std::to_string(i)).coins, i);
+  }
+  ASSERT_EQ(table_2.GetSize(), count_elements);
+}
+
+TEST(CuckooHashTableMoveConstructor, Normal) {
+  CuckooHashTable<std::string, Student> table;
+  table.Set("KEY", Student{"NAME", "SURNAME", 12, "CITY", 5555});
+
+  CuckooHashTable<std::string, Student> table_2 = std::move(table);
+
+  ASSERT_EQ(table_2.Exists("KEY"), true);
+  ASSERT_EQ(table.Exists("KEY"), false);
+  ASSERT_EQ(table.GetSize(), 0);
+}
+
+TEST(CuckooHashTableSet, ElementsWithSameKey) {
+  CuckooHashTable<std::string, Student> table;
+
+  bool status_1 =
+      table.Set("KEY", Student{"NAME", "SURNAME", 12, "CITY", 5555});
+  bool status_2 =
+      table.Set("KEY", Student{"NAME2", "SURNAME2", 12, "CITY", 5555});
+
+  ASSERT_EQ(status_1, true);
+  ASSERT_EQ(status_2, false);
+  ASSERT_EQ(table.Get("KEY").name, "NAME");
+}
+
+TEST(CuckooHashTableGet, ThrowKeyIsNotExists) {
+  CuckooHashTable<std::string, Student> table;
+
+  ASSERT_THROW(table.Get("KEY"), std::invalid_argument);
+}
+
+TEST(CuckooHashTableUpdate, Success) {
+  CuckooHashTable<std::string, Student> table;
+  Student new_student{"NAME2", "SURNAME2", 13, "CITY2", 5556};
+  table.Set("KEY", Student{"NAME", "SURNAME", 12, "CITY", 5555});
+
+  ASSERT_EQ(table.Update("KEY", new_student), true);
+  ASSERT_EQ(table.Update("KEY2", new_student), false);
+  ASSERT_EQ(table.Get("KEY"), new_student);
+}
+
+TEST(CuckooHashTableRename, Normal) {
+  CuckooHashTable<std::string, Student> table;
+  table.Set("KEY", Student{"NAME", "SURNAME", 12, "CITY", 5555});
+  table.Set("KEY3", Student{"NAME", "SURNAME", 12, "CITY", 5555});
+
+  ASSERT_EQ(table.Rename("KEY", "KEY2"), true);
+  ASSERT_EQ(table.Rename("KEY2", "KEY3"), false);
+  ASSERT_EQ(table.Exists("KEY"), false);
+  ASSERT_EQ(table.Exists("KEY2"), true);
+}
+
+TEST(CuckooHashTableFind, SomeElements) {
+  CuckooHashTable<std::string, Student> table;
+  Student student{"NAME", "SURNAME", 12, "CITY", 5555};
+  std::set<std::string> keys = {"KEY", "KEY2", "KEY3"};
+
+  for (auto key : keys) {
+    table.Set(key, student);
+  }
+  table.Set("KEY4", Student{"NAME", "SURNAME", 12, "CITY", 1});
+
+  auto keys_result = table.Find(student);
+  std::set<std::string> result_set(keys_result.begin(), keys_result.end());
+
+  ASSERT_EQ(keys, result_set);
+  ASSERT_EQ(table.Keys().size(), 4);
+  ASSERT_EQ(table.Showall().size(), 4);
+}
+
+TEST(CuckooHashTableLoadFactor, HighOccupancy) {
+  CuckooHashTable<int, int> table;
+
+  for (int i = 0; i < 100000; ++i) {
+    ASSERT_EQ(table.Set(i, i), true);
+  }
+
+  ASSERT_EQ(table.GetSize(), 100000);
+  ASSERT_GT(table.GetLoadFactor(), 0.4);
+  for (int i = 0; i < 100000; ++i) {
+    ASSERT_EQ(table.Get(i), i);
+  }
+}
+
+TEST(CuckooHashTableSet, IdenticalHashesGoToStash) {
+  CuckooHashTable<int, int, std::equal_to<int>, CuckooConstantHasher> table;
+
+  for (int i = 0; i < 64; ++i) {
+    ASSERT_EQ(table.Set(i, i), true);
+  }
+
+  ASSERT_GT(table.GetStashSize(), 0);
+  ASSERT_LT(table.GetCapacity(), 1024);
+  for (int i = 0; i < 64; ++i) {
+    ASSERT_EQ(table.Get(i), i);
+  }
+  for (int i = 0; i < 64; i += 4) {
+    ASSERT_EQ(table.Del(i), true);
+  }
+  for (int i = 0; i < 64; ++i) {
+    ASSERT_EQ(table.Exists(i), i % 4 != 0);
+  }
+  ASSERT_EQ(table.GetSize(), 48);
+}
+
+TEST(CuckooHashTableReserve, NoResizeAfterReserve) {
+  CuckooHashTable<int, int> table;
+  table.Reserve(1000);
+  size_t capacity = table.GetCapacity();
+
+  for (int i = 0; i < 1000; ++i) {
+    table.Set(i, i);
+  }
+
+  ASSERT_GE(capacity, 1000);
+  ASSERT_EQ(table.GetSize(), 1000);
+}
+
+TEST(CuckooHashTableShrink, ShrinksAndCompacts) {
+  CuckooHashTable<int, int> table;
+  for (int i = 0; i < 4096; ++i) {
+    table.Set(i, i);
+  }
+  size_t peak = table.GetCapacity();
+
+  for (int i = 0; i < 4000; ++i) {
+    table.Del(i);
+  }
+  ASSERT_LT(table.GetCapacity(), peak / 8);
+
+  table.Compact();
+  ASSERT_EQ(table.GetCapacity(), 128);
+  for (int i = 4000; i < 4096; ++i) {
+    ASSERT_EQ(table.Get(i), i);
+  }
+
+  for (int i = 4000; i < 4096; ++i) {
+    table.Del(i);
+  }
+  table.Compact();
+  ASSERT_EQ(table.GetCapacity(), 0);
+}
+
+// Past half load most inserts find both buckets full, so filling the
+// reserved slots up to the grow threshold needs eviction walks.
+TEST(CuckooHashTableSet, EvictionsFillReservedTable) {
+  using Table = CuckooHashTable<int, int>;
+  Table table;
+  table.Reserve(1000);
+  size_t capacity = table.GetCapacity();
+  int count = static_cast<int>(capacity * Table::kResizeCoeff);
+
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(table.Set(i, i), true);
+  }
+
+  ASSERT_EQ(table.GetCapacity(), capacity);
+  ASSERT_EQ(table.GetStashSize(), 0);
+  ASSERT_GT(table.GetLoadFactor(), 0.89);
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(table.Get(i), i);
+  }
+}
+
+// Keys with one hash share both buckets. The ninth of them finds the table
+// half full, so it grows once and then the key goes to the stash.
+TEST(CuckooHashTableSet, OverflowGoesToStash) {
+  CuckooHashTable<int, int, std::equal_to<int>, CuckooSameHasher> table;
+
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_EQ(table.Set(i, i), true);
+  }
+  ASSERT_EQ(table.GetCapacity(), 16);
+  ASSERT_EQ(table.GetStashSize(), 0);
+
+  ASSERT_EQ(table.Set(8, 8), true);
+  ASSERT_EQ(table.GetCapacity(), 32);
+  ASSERT_EQ(table.GetStashSize(), 1);
+  ASSERT_EQ(table.Get(8), 8);
+  ASSERT_EQ(table.Update(8, 80), true);
+  ASSERT_EQ(table.Get(8), 80);
+  ASSERT_EQ(table.Rename(8, 9), true);
+  ASSERT_EQ(table.Get(9), 80);
+  ASSERT_EQ(table.Del(9), true);
+  ASSERT_EQ(table.GetSize(), 8);
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_EQ(table.Get(i), i);
+  }
+}
+
+// The stash takes keys only while the table is under half full, after
+// that the next key rehashes into twice the buckets.
+TEST(CuckooHashTableSet, RehashWhenStashIsFull) {
+  CuckooHashTable<int, int, std::equal_to<int>, CuckooSameHasher> table;
+
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_EQ(table.Set(i, i), true);
+  }
+  ASSERT_EQ(table.GetCapacity(), 32);
+  ASSERT_EQ(table.GetStashSize(), 8);
+
+  ASSERT_EQ(table.Set(16, 16), true);
+  ASSERT_EQ(table.GetCapacity(), 64);
+  ASSERT_EQ(table.GetStashSize(), 9);
+  ASSERT_EQ(table.GetSize(), 17);
+  for (int i = 0; i < 17; ++i) {
+    ASSERT_EQ(table.Get(i), i);
+  }
+}
+
+TEST(CuckooHashTableRandom, MatchesStdMap) {
+  CuckooHashTable<std::string, int> table;
+
+  ExpectMatchesStdMap(table, 11, 3000, 30000);
+}
+
+}  // namespace s21
@@ -0,0 +1,55 @@
+#include <map>
+#include <random>
+#include <string>
+
+#include "common.h"
+#include "model/common/expiryheap.h"
+
+namespace s21 {
+
+TEST(ExpiryHeap, PopsInExpiryOrder) {
+  using time_type = ExpiryHeap<int>::time_type;
+  ExpiryHeap<int> heap;
+  std::map<int, time_type> expected;
+  std::mt19937 gen(21);
+  std::uniform_int_distribution<int> key_dist(0, 2000);
+  std::uniform_int_distribution<int> time_dist(0, 100000);
+  for (int i = 0; i < 20000; ++i) {
+    int key = key_dist(gen);
+    time_type death_time{std::chrono::milliseconds(time_dist(gen))};
+    if (i % 4 == 0) {
+      ASSERT_EQ(heap.Erase(key), expected.erase(key) == 1);
+    } else if (i % 9 == 0) {
+      int new_key = key_dist(gen);
+      heap.Rename(key, new_key);
+      auto it = expected.find(key);
+      if (it != expected.end() && key != new_key) {
+        expected[new_key] = it->second;
+        expected.erase(key);
+      }
+    } else {
+      heap.Push(key, death_time);
+      expected[key] = death_time;
+    }
+  }
+  ASSERT_EQ(heap.EraseIf([](int key) { return key % 10 == 0; }),
+            std::count_if(expected.begin(), expected.end(),
+                          [](auto& item) { return item.first % 10 == 0; }));
+  for (auto it = expected.begin(); it != expected.end();) {
+    it = it->first % 10 == 0 ? expected.erase(it) : std::next(it);
+  }
+
+  ASSERT_EQ(heap.GetSize(), expected.size());
+  for (auto& [key, death_time] : expected) {
+    ASSERT_EQ(heap.Find(key), death_time);
+  }
+  time_type previous = time_type::min();
+  while (!heap.IsEmpty()) {
+    ASSERT_LE(previous, heap.GetTopTime());
+    ASSERT_EQ(expected.at(heap.GetTopKey()), heap.GetTopTime());
+    previous = heap.GetTopTime();
+    heap.Pop();
+  }
+}
+
+}  // namespace s21
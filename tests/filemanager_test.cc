@@ -1,12 +1,30 @@
 #include <filesystem>
 
 #include "common.h"
+#include "model/bplustree/b_plus_tree.h"
 #include "model/common/filemanager.h"
 #include "model/common/student.h"
 #include "model/hashtable/hash_table.h"
 
 namespace s21 {
 
+class ReserveSpy : public HashTable<std::string, Student> {
+ public:
+  void Reserve(size_t count) override {
+    hint = count;
+    HashTable<std::string, Student>::Reserve(count);
+  }
+
+  size_t SetBatch(std::vector<std::pair<std::string, Student>> records)
+      override {
+    ++batches;
+    return HashTable<std::string, Student>::SetBatch(std::move(records));
+  }
+
+  size_t hint = 0;
+  size_t batches = 0;
+};
+
 class FileManagerExport : public ::testing::Test {
  protected:
   void SetUp() override {}
@@ -48,6 +66,27 @@ TEST_F(FileManagerImport, Normal) {
   ASSERT_EQ(storage_.GetSize(), 20);
 }
 
+TEST(FileManagerImportReserve, HintIsRecordCount) {
+  ReserveSpy storage;
+
+  FileManager::ImportFromDat(storage, kSamplesDir + "student.dat");
+
+  ASSERT_EQ(storage.hint, 20);
+  ASSERT_EQ(storage.batches, 0);
+  ASSERT_EQ(storage.GetSize(), 20);
+}
+
+TEST(FileManagerImportBatch, BulkLoadsTree) {
+  BPlusTree<std::string, Student> storage;
+
+  auto result =
+      FileManager::ImportFromDat(storage, kSamplesDir + "student.dat");
+
+  ASSERT_EQ(result.first, true);
+  ASSERT_EQ(result.second, 20);
+  ASSERT_EQ(storage.Keys().size(), 20);
+}
+
 TEST_F(FileManagerImport, FileNotExists) {
   auto result =
       FileManager::ImportFromDat(storage_, kSamplesDir + "notexists.dat");
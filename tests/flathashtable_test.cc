@@ -0,0 +1,174 @@
+#include "common.h"
+#include "model/common/student.h"
+#include "model/hashtable/flat_hash_table.h"
+
+namespace s21 {
+
+TEST(FlatHashTableCopyConstructor, Normal) {
+  FlatHashTable<std::string, Student> table;
+  size_t count_elements = 100;
+
+  for (size_t i = 0; i < count_elements; ++i) {
+    table.Set("KEY" + std::to_string(i),
+              Student{"NAME", "SURNAME", 12, "CITY", static_cast<int>(i)});
+  }
+
+  FlatHashTable<std::string, Student> table_2 = table;
+
+  for (size_t i = 0; i < count_elements; ++i) {
+    ASSERT_EQ(table_2.Get("KEY" + std::to_string(i)).coins, i);
+  }
+  ASSERT_EQ(table.GetSize(), table_2.GetSize());
+  ASSERT_EQ(table.GetLoadFactor(), table_2.GetLoadFactor());
+}
+
+TEST(FlatHashTableMoveConstructor, Normal) {
+  FlatHashTable<std::string, Student> table;
+  size_t count_elements = 100;
+
+  for (size_t i = 0; i < count_elements; ++i) {
+    table.Set("KEY" + std::to_string(i),
+              Student{"NAME", "SURNAME", 12, "CITY", 5555});
+  }
+
+  FlatHashTable<std::string, Student> table_2 = std::move(table);
+
+  ASSERT_EQ(table_2.GetSize(), count_elements);
+  ASSERT_EQ(table.GetSize(), 0);
+  ASSERT_EQ(table.Showall().size(), 0);
+  ASSERT_EQ(table.Exists("KEY1"), false);
+}
+
+TEST(FlatHashTableSet, ElementsWithSameKey) {
+  FlatHashTable<std::string, Student> table;
+
+  bool status_1 =
+      table.Set("KEY", Student{"NAME", "SURNAME", 12, "CITY", 5555});
+  bool status_2 =
+      table.Set("KEY", Student{"NAME2", "SURNAME2", 12, "CITY", 5555});
+
+  ASSERT_EQ(status_1, true);
+  ASSERT_EQ(status_2, false);
+  ASSERT_EQ(table.GetSize(), 1);
+  ASSERT_EQ(table.Get("KEY").name, "NAME");
+}
+
+TEST(FlatHashTableGet, ThrowKeyIsNotExists) {
+  FlatHashTable<std::string, Student> table;
+
+  ASSERT_THROW(table.Get("KEY"), std::invalid_argument);
+}
+
+TEST(FlatHashTableUpdate, Success) {
+  FlatHashTable<std::string, Student> table;
+  Student new_student{"NAME2", "SURNAME2", 13, "CITY2", 5556};
+  table.Set("KEY", Student{"NAME", "SURNAME", 12, "CITY", 5555});
+
+  ASSERT_EQ(table.Update("KEY", new_student), true);
+  ASSERT_EQ(table.Update("KEY2", new_student), false);
+  ASSERT_EQ(table.Get("KEY"), new_student);
+}
+
+TEST(FlatHashTableRename, Normal) {
+  FlatHashTable<std::string, Student> table;
+  table.Set("KEY", Student{"NAME", "SURNAME", 12, "CITY", 5555});
+  table.Set("KEY3", Student{"NAME", "SURNAME", 12, "CITY", 5555});
+
+  ASSERT_EQ(table.Rename("KEY", "KEY2"), true);
+  ASSERT_EQ(table.Rename("KEY2", "KEY3"), false);
+  ASSERT_EQ(table.Rename("KEY", "KEY4"), false);
+  ASSERT_EQ(table.Exists("KEY"), false);
+  ASSERT_EQ(table.Exists("KEY2"), true);
+}
+
+TEST(FlatHashTableFind, SomeElements) {
+  FlatHashTable<std::string, Student> table;
+  Student student{"NAME", "SURNAME", 12, "CITY", 5555};
+  std::set<std::string> keys = {"KEY", "KEY2", "KEY3"};
+
+  for (auto key : keys) {
+    table.Set(key, student);
+  }
+  table.Set("KEY4", Student{"NAME", "SURNAME", 12, "CITY", 1});
+
+  auto keys_result = table.Find(student);
+  std::set<std::string> result_set(keys_result.begin(), keys_result.end());
+
+  ASSERT_EQ(keys, result_set);
+  ASSERT_EQ(table.Keys().size(), 4);
+  ASSERT_EQ(table.Showall().size(), 4);
+}
+
+TEST(FlatHashTableLoadFactor, StaysBelowResizeCoeff) {
+  using Table = FlatHashTable<int, int>;
+  Table table;
+
+  for (int i = 0; i < 1000; ++i) {
+    table.Set(i, i);
+    ASSERT_LE(table.GetLoadFactor(), Table::kResizeCoeff);
+  }
+
+  ASSERT_GT(table.GetLoadFactor(), 0.4);
+}
+
+TEST(FlatHashTableDel, ReuseDeletedSlots) {
+  FlatHashTable<int, int> table;
+
+  for (int i = 0; i < 100; ++i) {
+    table.Set(i, i);
+  }
+  size_t capacity = table.GetCapacity();
+
+  for (int round = 0; round < 100; ++round) {
+    for (int i = 0; i < 50; ++i) {
+      ASSERT_EQ(table.Del(i), true);
+    }
+    for (int i = 0; i < 50; ++i) {
+      ASSERT_EQ(table.Set(i, round), true);
+    }
+  }
+
+  ASSERT_EQ(table.GetSize(), 100);
+  ASSERT_EQ(table.GetCapacity(), capacity);
+}
+
+TEST(FlatHashTableReserve, NoResizeAfterReserve) {
+  FlatHashTable<int, int> table;
+  table.Set(-1, -1);
+  table.Reserve(1000);
+  size_t capacity = table.GetCapacity();
+
+  for (int i = 0; i < 1000; ++i) {
+    table.Set(i, i);
+  }
+
+  ASSERT_EQ(table.GetCapacity(), capacity);
+  ASSERT_EQ(table.Get(-1), -1);
+}
+
+TEST(FlatHashTableShrink, ShrinksAndCompacts) {
+  FlatHashTable<int, int> table;
+  for (int i = 0; i < 4096; ++i) {
+    table.Set(i, i);
+  }
+  size_t peak = table.GetCapacity();
+
+  for (int i = 0; i < 4000; ++i) {
+    table.Del(i);
+  }
+  ASSERT_LT(table.GetCapacity(), peak / 8);
+
+  table.Compact();
+  ASSERT_EQ(table.GetCapacity(), 128);
+  for (int i = 4000; i < 4096; ++i) {
+    ASSERT_EQ(table.Get(i), i);
+  }
+}
+
+TEST(FlatHashTableRandom, MatchesStdMap) {
+  FlatHashTable<std::string, int> table;
+
+  ExpectMatchesStdMap(table, 42, 2000, 20000);
+}
+
+}  // namespace s21
@@ -25,6 +25,17 @@ TEST(HashTableCopyConstructor, Normal) {
   ASSERT_EQ(table.GetLoadFactor(), table_2.GetLoadFactor());
 }
 
+TEST(HashTableCopyConstructor, EmptyTable) {
+  HashTable<std::string, int> table;
+  HashTable<std::string, int> table_2 = table;
+
+  ASSERT_EQ(table_2.GetBucketCount(), 0);
+  ASSERT_EQ(table_2.Exists("KEY"), false);
+  ASSERT_EQ(table_2.Set("KEY", 1), true);
+  ASSERT_EQ(table_2.Get("KEY"), 1);
+  ASSERT_EQ(table.Exists("KEY"), false);
+}
+
 TEST(HashTableCopyAssignmentConstructor, Normal) {
   HashTable<std::string, Student> table;
   HashTable<std::string, Student> table_2;
@@ -294,4 +305,282 @@ TEST(HashTableShowAll, SomeElements) {
   ASSERT_EQ(values.size(), 3);
   ASSERT_EQ(table.GetSize(), 3);
 }
+
+TEST(HashTableMoveConstructor, LookupAfterMove) {
+  HashTable<std::string, Student> table;
+  Student student{"NAME", "SURNAME", 12, "CITY", 5555};
+
+  for (size_t i = 0; i < 100; ++i) {
+    table.Set("KEY" + std::to_string(i), student);
+  }
+
+  HashTable<std::string, Student> table_2 = std::move(table);
+
+  for (size_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(table_2.Exists("KEY" + std::to_string(i)), true);
+  }
+  ASSERT_EQ(table_2.Exists("KEY100"), false);
+  ASSERT_EQ(table.Exists("KEY1"), false);
+  ASSERT_EQ(table.Set("KEY1", student), true);
+}
+
+TEST(HashTableIncrementalRehash, KeysStayReachable) {
+  using Table = HashTable<std::string, int>;
+  Table table(RehashPolicy::kIncremental);
+  bool was_rehashing = false;
+
+  for (int i = 0; i < 5000; ++i) {
+    ASSERT_EQ(table.Set("KEY" + std::to_string(i), i), true);
+    was_rehashing = was_rehashing || table.IsRehashing();
+
+    ASSERT_EQ(table.Get("KEY" + std::to_string(i)), i);
+    ASSERT_EQ(table.Get("KEY" + std::to_string(i / 2)), i / 2);
+  }
+
+  ASSERT_EQ(was_rehashing, true);
+  ASSERT_EQ(table.GetSize(), 5000);
+  ASSERT_LT(table.GetLoadFactor(), Table::kResizeCoeff);
+}
+
+TEST(HashTableIncrementalRehash, CopyWhileRehashing) {
+  HashTable<std::string, int> table(RehashPolicy::kIncremental);
+  int count = 0;
+
+  while (!table.IsRehashing() || count < 100) {
+    table.Set("KEY" + std::to_string(count), count);
+    ++count;
+  }
+
+  HashTable<std::string, int> copy = table;
+  HashTable<std::string, int> moved = std::move(table);
+
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(copy.Get("KEY" + std::to_string(i)), i);
+    ASSERT_EQ(moved.Get("KEY" + std::to_string(i)), i);
+  }
+  ASSERT_EQ(copy.Del("KEY0"), true);
+  ASSERT_EQ(copy.Exists("KEY0"), false);
+  ASSERT_EQ(moved.Exists("KEY0"), true);
+}
+
+// Right after a resize starts no old bucket has moved yet, so the old
+// keys are served from the old table and the last key from the new one.
+TEST(HashTableIncrementalRehash, OperationsMidMigration) {
+  HashTable<std::string, int> table(RehashPolicy::kIncremental);
+  int count = 0;
+
+  while (!table.IsRehashing() || table.GetBucketCount() < 512) {
+    table.Set("KEY" + std::to_string(count), count);
+    ++count;
+  }
+  std::string old_key = "KEY0";
+  std::string new_key = "KEY" + std::to_string(count - 1);
+
+  ASSERT_EQ(table.Get(old_key), 0);
+  ASSERT_EQ(table.Get(new_key), count - 1);
+  ASSERT_EQ(table.Update(old_key, -1), true);
+  ASSERT_EQ(table.Update(new_key, -2), true);
+  ASSERT_EQ(table.Get(old_key), -1);
+  ASSERT_EQ(table.Get(new_key), -2);
+
+  ASSERT_EQ(table.Rename(old_key, "OLD"), true);
+  ASSERT_EQ(table.Rename(new_key, "NEW"), true);
+  ASSERT_EQ(table.Rename("KEY1", "OLD"), false);
+  ASSERT_EQ(table.Get("OLD"), -1);
+  ASSERT_EQ(table.Get("NEW"), -2);
+  ASSERT_EQ(table.Exists(old_key), false);
+  ASSERT_EQ(table.Exists(new_key), false);
+
+  ASSERT_EQ(table.Del("KEY1"), true);
+  ASSERT_EQ(table.Del("NEW"), true);
+  ASSERT_EQ(table.Del("NEW"), false);
+  ASSERT_EQ(table.IsRehashing(), true);
+
+  ASSERT_EQ(table.GetSize(), count - 2);
+  ASSERT_EQ(table.Get("OLD"), -1);
+  for (int i = 2; i < count - 1; ++i) {
+    ASSERT_EQ(table.Get("KEY" + std::to_string(i)), i);
+  }
+}
+
+TEST(HashTableIncrementalRehash, MatchesStdMap) {
+  HashTable<std::string, int> table(RehashPolicy::kIncremental);
+
+  ExpectMatchesStdMap(table, 7, 3000, 30000);
+}
+
+struct CountingHasher {
+  static inline size_t calls = 0;
+
+  size_t operator()(const std::string& key) const {
+    ++calls;
+    return std::hash<std::string>{}(key);
+  }
+};
+
+struct ConstantHasher {
+  size_t operator()(const std::string&) const { return 42; }
+};
+
+TEST(HashTableHashCache, ResizeDoesNotCallHasher) {
+  HashTable<std::string, int, std::equal_to<int>, CountingHasher> table;
+  CountingHasher::calls = 0;
+
+  for (int i = 0; i < 1000; ++i) {
+    table.Set("KEY" + std::to_string(i), i);
+  }
+
+  ASSERT_EQ(CountingHasher::calls, 1000);
+  ASSERT_EQ(table.GetSize(), 1000);
+}
+
+TEST(HashTableHashCache, FullCollisions) {
+  HashTable<std::string, int, std::equal_to<int>, ConstantHasher> table;
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(table.Set("KEY" + std::to_string(i), i), true);
+  }
+  for (int i = 0; i < 100; i += 3) {
+    ASSERT_EQ(table.Del("KEY" + std::to_string(i)), true);
+  }
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(table.Exists("KEY" + std::to_string(i)), i % 3 != 0);
+  }
+}
+
+TEST(HashTableReserve, NoResizeAfterReserve) {
+  HashTable<std::string, int> table;
+  table.Reserve(1000);
+  size_t buckets = table.GetBucketCount();
+
+  for (int i = 0; i < 1000; ++i) {
+    table.Set("KEY" + std::to_string(i), i);
+  }
+
+  ASSERT_EQ(table.GetBucketCount(), buckets);
+  ASSERT_EQ(table.GetSize(), 1000);
+}
+
+TEST(HashTableReserve, CountsExistingRecords) {
+  HashTable<std::string, int> table(RehashPolicy::kIncremental);
+  for (int i = 0; i < 500; ++i) {
+    table.Set("KEY" + std::to_string(i), i);
+  }
+
+  table.Reserve(500);
+  size_t buckets = table.GetBucketCount();
+  for (int i = 500; i < 1000; ++i) {
+    table.Set("KEY" + std::to_string(i), i);
+  }
+
+  ASSERT_EQ(table.GetBucketCount(), buckets);
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(table.Get("KEY" + std::to_string(i)), i);
+  }
+}
+
+TEST(HashTableShrink, ShrinksAfterMassDelete) {
+  HashTable<std::string, int> table;
+  for (int i = 0; i < 4096; ++i) {
+    table.Set("KEY" + std::to_string(i), i);
+  }
+  size_t peak = table.GetBucketCount();
+
+  for (int i = 0; i < 4000; ++i) {
+    table.Del("KEY" + std::to_string(i));
+  }
+
+  ASSERT_LT(table.GetBucketCount(), peak / 8);
+  for (int i = 4000; i < 4096; ++i) {
+    ASSERT_EQ(table.Get("KEY" + std::to_string(i)), i);
+  }
+}
+
+TEST(HashTableShrink, NoResizeNearThreshold) {
+  HashTable<int, int> table;
+  for (int i = 0; i < 97; ++i) {
+    table.Set(i, i);
+  }
+  size_t buckets = table.GetBucketCount();
+  table.Del(96);
+
+  for (int round = 0; round < 100; ++round) {
+    table.Set(1000, 1000);
+    table.Del(1000);
+  }
+
+  ASSERT_EQ(table.GetBucketCount(), buckets);
+}
+
+TEST(HashTableCompact, FitsLiveRecords) {
+  HashTable<std::string, int> table(RehashPolicy::kIncremental);
+  for (int i = 0; i < 1000; ++i) {
+    table.Set("KEY" + std::to_string(i), i);
+  }
+  for (int i = 0; i < 900; ++i) {
+    table.Del("KEY" + std::to_string(i));
+  }
+
+  table.Compact();
+
+  ASSERT_EQ(table.IsRehashing(), false);
+  ASSERT_EQ(table.GetBucketCount(), 256);
+  for (int i = 900; i < 1000; ++i) {
+    ASSERT_EQ(table.Get("KEY" + std::to_string(i)), i);
+  }
+
+  for (int i = 900; i < 1000; ++i) {
+    table.Del("KEY" + std::to_string(i));
+  }
+  table.Compact();
+  ASSERT_EQ(table.GetBucketCount(), 0);
+  ASSERT_EQ(table.Set("KEY", 1), true);
+  ASSERT_EQ(table.Get("KEY"), 1);
+}
+
+TEST(HashTableClone, Independent) {
+  HashTable<std::string, int> table;
+  for (int i = 0; i < 100; ++i) {
+    table.Set(std::to_string(i), i);
+  }
+  std::unique_ptr<BaseStorage<std::string, int>> clone = table.Clone();
+  table.Del("1");
+  ASSERT_EQ(clone->Get("1"), 1);
+  ASSERT_EQ(clone->Keys().size(), 100);
+  ASSERT_EQ(table.Keys().size(), 99);
+}
+
+TEST(HashTableClone, FromEmptyTable) {
+  HashTable<std::string, int> table;
+  std::unique_ptr<BaseStorage<std::string, int>> clone = table.Clone();
+
+  ASSERT_EQ(clone->Update("KEY", 1), false);
+  ASSERT_EQ(clone->Set("KEY", 1), true);
+  ASSERT_EQ(clone->Update("KEY", 2), true);
+  ASSERT_EQ(clone->Get("KEY"), 2);
+  ASSERT_EQ(table.Exists("KEY"), false);
+}
+
+TEST(HashTableClone, FromCompactedTable) {
+  HashTable<std::string, int> table(RehashPolicy::kIncremental);
+  for (int i = 0; i < 100; ++i) {
+    table.Set("KEY" + std::to_string(i), i);
+  }
+  for (int i = 0; i < 100; ++i) {
+    table.Del("KEY" + std::to_string(i));
+  }
+  table.Compact();
+
+  std::unique_ptr<BaseStorage<std::string, int>> clone = table.Clone();
+  ASSERT_EQ(clone->Update("KEY1", 1), false);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(clone->Set("KEY" + std::to_string(i), i), true);
+    ASSERT_EQ(clone->Update("KEY" + std::to_string(i), i + 1), true);
+  }
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(clone->Get("KEY" + std::to_string(i)), i + 1);
+  }
+  ASSERT_EQ(table.GetSize(), 0);
+}
 }  // namespace s21
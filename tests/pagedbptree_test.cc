@@ -0,0 +1,148 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+
+#include "common.h"
+#include "model/bplustree/paged_b_plus_tree.h"
+#include "model/common/student.h"
+
+namespace s21 {
+
+class PagedBPlusTreeTest : public ::testing::Test {
+ protected:
+  void SetUp() override { std::remove(path_.c_str()); }
+
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  std::string path_ =
+      (std::filesystem::temp_directory_path() / "paged_tree.db").string();
+};
+
+TEST_F(PagedBPlusTreeTest, BasicOperations) {
+  PagedBPlusTree<std::string, Student> tree(path_);
+  Student student{"NAME", "SURNAME", 12, "CITY", 5555};
+  Student new_student{"NAME2", "SURNAME2", 13, "CITY2", 5556};
+
+  ASSERT_EQ(tree.Set("KEY", student), true);
+  ASSERT_EQ(tree.Set("KEY", student), false);
+  ASSERT_EQ(tree.Get("KEY"), student);
+  ASSERT_EQ(tree.Update("KEY", new_student), true);
+  ASSERT_EQ(tree.Get("KEY"), new_student);
+  ASSERT_EQ(tree.Rename("KEY", "KEY2"), true);
+  ASSERT_EQ(tree.Exists("KEY"), false);
+  ASSERT_EQ(tree.Find(new_student), std::vector<std::string>{"KEY2"});
+  ASSERT_EQ(tree.Del("KEY2"), true);
+  ASSERT_EQ(tree.Del("KEY2"), false);
+  ASSERT_THROW(tree.Get("KEY2"), std::invalid_argument);
+  ASSERT_THROW(tree.Set(std::string(PagedTree<std::string, Student>::kPageSize,
+                                    'K'),
+                        student),
+               std::length_error);
+  ASSERT_THROW(tree.Clone(), std::logic_error);
+}
+
+TEST_F(PagedBPlusTreeTest, MatchesMapWithSmallCache) {
+  PagedTree<int, int> tree(path_, 8);
+  std::map<int, int> expected;
+  std::mt19937 gen(5);
+  std::uniform_int_distribution<int> key_dist(0, 10000);
+
+  for (int i = 0; i < 30000; ++i) {
+    int key = key_dist(gen);
+    if (i % 3 == 0) {
+      ASSERT_EQ(tree.Remove(key), expected.erase(key) == 1);
+    } else if (i % 7 == 0) {
+      ASSERT_EQ(tree.Update(key, -i), expected.count(key) == 1);
+      if (expected.count(key) == 1) {
+        expected[key] = -i;
+      }
+    } else {
+      ASSERT_EQ(tree.Insert(key, i), expected.emplace(key, i).second);
+    }
+  }
+
+  ASSERT_LE(tree.GetCachedPages(), 8);
+  ASSERT_EQ(tree.GetSize(), expected.size());
+  auto it = expected.begin();
+  tree.ForEach(nullptr, [&](int key, int value) {
+    EXPECT_EQ(key, it->first);
+    EXPECT_EQ(value, it->second);
+    ++it;
+    return true;
+  });
+  ASSERT_EQ(it == expected.end(), true);
+}
+
+TEST_F(PagedBPlusTreeTest, ReopenKeepsRecords) {
+  {
+    PagedBPlusTree<std::string, Student> tree(path_, 16);
+    for (int i = 0; i < 5000; ++i) {
+      tree.Set("KEY" + std::to_string(i),
+               Student{"NAME", "SURNAME", i, "CITY", i * 2});
+    }
+  }
+
+  PagedBPlusTree<std::string, Student> tree(path_, 16);
+  ASSERT_EQ(tree.GetSize(), 5000);
+  ASSERT_EQ(tree.Get("KEY1234").coins, 2468);
+  ASSERT_EQ(tree.Scan("KEY10", "KEY11", 200).size(), 112);
+
+  auto cursor = tree.GetCursor();
+  cursor->SeekToLast();
+  ASSERT_EQ(cursor->GetKey(), "KEY999");
+  cursor->Prev();
+  ASSERT_EQ(cursor->GetKey(), "KEY998");
+  cursor->Seek("KEY4999");
+  cursor->Next();
+  ASSERT_EQ(cursor->GetKey(), "KEY5");
+}
+
+TEST_F(PagedBPlusTreeTest, RemovedPagesAreReused) {
+  PagedTree<int, int> tree(path_, 16);
+  for (int i = 0; i < 20000; ++i) {
+    tree.Insert(i, i);
+  }
+  size_t pages = tree.GetPagesCount();
+  for (int i = 0; i < 20000; ++i) {
+    ASSERT_EQ(tree.Remove(i), true);
+  }
+  ASSERT_EQ(tree.GetSize(), 0);
+  for (int i = 0; i < 20000; ++i) {
+    tree.Insert(-i, i);
+  }
+
+  ASSERT_EQ(tree.GetPagesCount(), pages);
+  ASSERT_EQ(tree.Search(-19999), 19999);
+}
+
+TEST_F(PagedBPlusTreeTest, DetectsCorruptedPages) {
+  {
+    PagedTree<int, int> tree(path_);
+    for (int i = 0; i < 5000; ++i) {
+      tree.Insert(i, i);
+    }
+  }
+  {
+    std::fstream file(path_, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(PageFile::kPageSize * 2 + 100);
+    file.put('X');
+  }
+
+  PagedTree<int, int> tree(path_);
+  bool corrupted = false;
+  try {
+    tree.ForEach(nullptr, [](int, int) { return true; });
+  } catch (const std::runtime_error&) {
+    corrupted = true;
+  }
+  ASSERT_EQ(corrupted, true);
+}
+
+TEST(PageFile, Crc32c) {
+  ASSERT_EQ(Crc32c("123456789", 9), 0xE3069283u);
+  ASSERT_EQ(Crc32c("", 0), 0u);
+}
+
+}  // namespace s21
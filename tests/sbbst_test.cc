@@ -1,4 +1,8 @@
+#include <map>
+#include <random>
+
 #include "common.h"
+#include "model/bst/node_slab.h"
 #include "model/bst/self_balancing_binary_search_tree.h"
 #include "model/common/student.h"
 
@@ -235,4 +239,234 @@ TEST(BstShowAll, SomeElements) {
 
   ASSERT_EQ(values.size(), 3);
 }
+
+TEST(BstScan, Window) {
+  SelfBalancingBinarySearchTree<int, int> bst;
+  for (int i = 0; i < 1000; i += 2) {
+    bst.Set(i, i * 10);
+  }
+
+  auto records = bst.Scan(101, 120, 5);
+
+  ASSERT_EQ(records.size(), 5);
+  ASSERT_EQ(records.front(), std::make_pair(102, 1020));
+  ASSERT_EQ(records.back(), std::make_pair(110, 1100));
+  ASSERT_EQ(bst.Scan(101, 120, 100).size(), 10);
+  ASSERT_EQ(bst.Scan(2000, 3000, 100).empty(), true);
+}
+
+TEST(BstCursor, SeekNextPrev) {
+  SelfBalancingBinarySearchTree<int, int> bst;
+  for (int i = 0; i < 1000; ++i) {
+    bst.Set((i * 7) % 1000 * 3, i);
+  }
+  for (int i = 0; i < 1000; i += 5) {
+    bst.Del(i * 3);
+  }
+  auto cursor = bst.GetCursor();
+
+  cursor->Seek(15);
+  ASSERT_EQ(cursor->GetKey(), 18);
+  cursor->Prev();
+  ASSERT_EQ(cursor->GetKey(), 12);
+
+  int count = 0;
+  int last = -1;
+  for (cursor->SeekToFirst(); cursor->IsValid(); cursor->Next()) {
+    ASSERT_LT(last, cursor->GetKey());
+    last = cursor->GetKey();
+    ++count;
+  }
+  ASSERT_EQ(count, 800);
+
+  for (cursor->SeekToLast(); cursor->IsValid(); cursor->Prev()) {
+    ASSERT_EQ(cursor->GetKey(), last);
+    last -= last % 15 == 3 ? 6 : 3;
+  }
+}
+
+TEST(BstDelRange, ShortAndLongRuns) {
+  SelfBalancingBinarySearchTree<int, int> bst;
+  std::map<int, int> expected;
+  std::mt19937 gen(4);
+  std::uniform_int_distribution<int> key_dist(0, 5000);
+  for (int i = 0; i < 3000; ++i) {
+    int key = key_dist(gen);
+    bst.Set(key, i);
+    expected.emplace(key, i);
+  }
+
+  for (int round = 0; round < 40; ++round) {
+    int from = key_dist(gen);
+    int to = from + key_dist(gen) % (round % 4 == 0 ? 5000 : 20);
+    auto first = expected.lower_bound(from);
+    auto last = expected.upper_bound(to);
+    ASSERT_EQ(bst.DelRange(from, to), std::distance(first, last));
+    expected.erase(first, last);
+    for (int i = 0; i < 100; ++i) {
+      int key = key_dist(gen);
+      if (i % 3 == 0) {
+        ASSERT_EQ(bst.Del(key), expected.erase(key) == 1);
+      } else {
+        ASSERT_EQ(bst.Set(key, i), expected.emplace(key, i).second);
+      }
+    }
+  }
+
+  ASSERT_EQ(bst.GetSize(), expected.size());
+  std::vector<int> keys;
+  for (const auto& [key, value] : expected) {
+    keys.push_back(key);
+  }
+  ASSERT_EQ(bst.Keys(), keys);
+}
+
+TEST(BstDelPrefix, Tenants) {
+  SelfBalancingBinarySearchTree<std::string, int> bst;
+  for (int i = 0; i < 300; ++i) {
+    bst.Set("T" + std::to_string(i % 3) + "_" + std::to_string(i), i);
+  }
+
+  ASSERT_EQ(bst.DelPrefix("T1_"), 100);
+  ASSERT_EQ(bst.GetSize(), 200);
+  ASSERT_EQ(bst.Exists("T1_1"), false);
+  ASSERT_EQ(bst.Get("T2_2"), 2);
+  ASSERT_EQ(bst.DelPrefix("T"), 200);
+  ASSERT_EQ(bst.Keys().empty(), true);
+  ASSERT_EQ(bst.Set("T0_0", 0), true);
+}
+
+TEST(BstOrderStatistics, MatchesMap) {
+  SelfBalancingBinarySearchTree<int, int> bst;
+  std::map<int, int> expected;
+  std::mt19937 gen(6);
+  std::uniform_int_distribution<int> key_dist(0, 4000);
+  for (int i = 0; i < 20000; ++i) {
+    int key = key_dist(gen);
+    if (i % 3 == 0) {
+      bst.Del(key);
+      expected.erase(key);
+    } else {
+      bst.Set(key, i);
+      expected.emplace(key, i);
+    }
+    if (i % 5000 == 0) {
+      bst.DelRange(key, key + 1000);
+      expected.erase(expected.lower_bound(key),
+                     expected.upper_bound(key + 1000));
+    }
+  }
+
+  std::vector<int> keys;
+  for (const auto& [key, value] : expected) {
+    keys.push_back(key);
+  }
+  for (size_t i = 0; i < keys.size(); i += 7) {
+    ASSERT_EQ(bst.Select(i), keys[i]);
+    ASSERT_EQ(bst.Rank(keys[i]), i);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    int from = key_dist(gen);
+    int to = from + key_dist(gen) % 300;
+    ASSERT_EQ(bst.Rank(from), std::distance(expected.begin(),
+                                            expected.lower_bound(from)));
+    ASSERT_EQ(bst.CountRange(from, to),
+              std::distance(expected.lower_bound(from),
+                            expected.upper_bound(to)));
+  }
+  ASSERT_EQ(bst.CountRange(10, 5), 0);
+  ASSERT_THROW(bst.Select(keys.size()), std::out_of_range);
+}
+
+TEST(BstNodeSlab, ReusesReleasedSlots) {
+  NodeSlab<std::string> slab;
+  auto first = slab.New("first");
+  auto second = slab.New(std::string(100, 's'));
+  slab.Delete(first);
+  ASSERT_EQ(slab.New("third"), first);
+  ASSERT_EQ(slab[first], "third");
+  ASSERT_EQ(slab[second], std::string(100, 's'));
+  ASSERT_EQ(slab.GetSize(), 2);
+
+  for (int i = 0; i < 10000; ++i) {
+    slab.New(std::to_string(i));
+  }
+  ASSERT_EQ(slab[second], std::string(100, 's'));
+  slab.Clear();
+  ASSERT_EQ(slab.GetSize(), 0);
+  ASSERT_EQ(slab.New("again"), 0);
+}
+
+TEST(BstNodeSlab, ReleasesTrailingChunks) {
+  NodeSlab<int> slab;
+  std::vector<NodeSlab<int>::Index> indices;
+  for (int i = 0; i < 100000; ++i) {
+    indices.push_back(slab.New(i));
+  }
+  size_t peak = slab.GetChunksCount();
+
+  for (int i = 1000; i < 100000; ++i) {
+    slab.Delete(indices[i]);
+  }
+  ASSERT_GT(peak, 1);
+  ASSERT_EQ(slab.GetChunksCount(), 1);
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(slab[indices[i]], i);
+  }
+  for (int i = 0; i < 2000; ++i) {
+    slab[slab.New(i)] = i;
+  }
+  ASSERT_EQ(slab.GetSize(), 3000);
+}
+
+TEST(BstCompact, ReleasesMemoryAfterDeletes) {
+  SelfBalancingBinarySearchTree<int, int> bst;
+  for (int i = 0; i < 100000; ++i) {
+    bst.Set(i, i);
+  }
+  size_t peak = bst.GetChunksCount();
+  for (int i = 0; i < 100000; i += 100) {
+    bst.DelRange(i + 1, i + 99);
+  }
+  ASSERT_EQ(bst.GetChunksCount(), peak);
+
+  bst.Compact();
+  ASSERT_LT(bst.GetChunksCount(), peak / 10);
+  ASSERT_EQ(bst.GetSize(), 1000);
+  ASSERT_EQ(bst.Select(10), 1000);
+  ASSERT_EQ(bst.Rank(5000), 50);
+  ASSERT_EQ(bst.Set(1, 1), true);
+  ASSERT_EQ(bst.Del(0), true);
+  ASSERT_EQ(bst.Get(99900), 99900);
+}
+
+TEST(BstNodeSlab, CopiesAreIndependent) {
+  SelfBalancingBinarySearchTree<std::string, Student> bst;
+  for (int i = 0; i < 100; ++i) {
+    bst.Set("key" + std::to_string(i),
+            Student{"NAME", "SURNAME", i, "CITY", 5555});
+  }
+  SelfBalancingBinarySearchTree<std::string, Student> copy(bst);
+  bst.DelPrefix("key");
+  ASSERT_EQ(copy.GetSize(), 100);
+  ASSERT_EQ(copy.Select(0), "key0");
+  bst = copy;
+  ASSERT_EQ(bst.Keys(), copy.Keys());
+}
+
+TEST(BstClone, KeepsOrderStatistics) {
+  SelfBalancingBinarySearchTree<int, int> bst;
+  for (int i = 0; i < 1000; ++i) {
+    bst.Set(i * 2, i);
+  }
+  bst.DelRange(100, 199);
+  std::unique_ptr<BaseStorage<int, int>> clone = bst.Clone();
+  bst.DelRange(0, 2000);
+  ASSERT_EQ(bst.Keys().empty(), true);
+  ASSERT_EQ(clone->Keys().size(), 950);
+  ASSERT_EQ(clone->Select(50), 200);
+  ASSERT_EQ(clone->Rank(300), 100);
+  ASSERT_EQ(clone->Set(101, 0), true);
+  ASSERT_EQ(clone->CountRange(0, 300), 102);
+}
 }  // namespace s21
@@ -0,0 +1,80 @@
+#include <set>
+#include <unordered_set>
+
+#include "common.h"
+#include "model/hashtable/hash_table.h"
+#include "model/hashtable/seeded_hash.h"
+
+namespace s21 {
+
+TEST(SeededHash, SameSeedSameHash) {
+  SeededHash<std::string> hasher(42);
+  SeededHash<std::string> other(42);
+
+  ASSERT_EQ(hasher("KEY"), other("KEY"));
+  ASSERT_EQ(hasher("KEY"), hasher(std::string_view("KEY")));
+  ASSERT_EQ(hasher("KEY"), SeededHash<std::string_view>(42)("KEY"));
+}
+
+TEST(SeededHash, InstancesGetDifferentSeeds) {
+  SeededHash<std::string> first;
+  SeededHash<std::string> second;
+  SeededHash<std::string> copy = first;
+
+  ASSERT_NE(first.GetSeed(), second.GetSeed());
+  ASSERT_EQ(copy.GetSeed(), first.GetSeed());
+  ASSERT_NE(first("KEY"), second("KEY"));
+}
+
+TEST(SeededHash, AllLengthsDistinct) {
+  SeededHash<std::string> hasher(7);
+  std::unordered_set<size_t> hashes;
+  std::string key;
+
+  for (int i = 0; i < 200; ++i) {
+    hashes.insert(hasher(key));
+    key.push_back('a');
+  }
+
+  ASSERT_EQ(hashes.size(), 200);
+}
+
+TEST(SeededHash, SingleBitFlipChangesLowBits) {
+  SeededHash<std::string> hasher(7);
+  std::string key(40, 'x');
+  std::set<size_t> buckets;
+
+  for (size_t i = 0; i < key.size() * 8; ++i) {
+    std::string flipped = key;
+    flipped[i / 8] ^= static_cast<char>(1 << (i % 8));
+    buckets.insert(hasher(flipped) & 0xFFFF);
+  }
+
+  ASSERT_GT(buckets.size(), key.size() * 8 - 4);
+}
+
+TEST(SeededHash, IntegersAreSpread) {
+  SeededHash<int> hasher(1);
+  std::set<size_t> buckets;
+
+  for (int i = 0; i < 1024; ++i) {
+    buckets.insert(hasher(i << 10) & 1023);
+  }
+
+  ASSERT_GT(buckets.size(), 600);
+}
+
+TEST(SeededHash, CopiedTableKeepsLookups) {
+  HashTable<std::string, int> table;
+  for (int i = 0; i < 500; ++i) {
+    table.Set("KEY" + std::to_string(i), i);
+  }
+
+  HashTable<std::string, int> copy = table;
+
+  for (int i = 0; i < 500; ++i) {
+    ASSERT_EQ(copy.Get("KEY" + std::to_string(i)), i);
+  }
+}
+
+}  // namespace s21